@@ -0,0 +1,149 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+// Created: Oct 19, 2026
+
+#include "EDAnchorGraph.h"
+
+#include <algorithm>
+#include <deque>
+
+void EDAnchorGraph::add_edge(EdgeId e, VertexId a, VertexId b)
+{
+	remove_edge(e);
+
+	Edge edge;
+	edge.a = a;
+	edge.b = b;
+	edges[e] = edge;
+	adjacency[a].push_back(e);
+	if (b != a)
+	{
+		adjacency[b].push_back(e);
+	}
+}
+
+void EDAnchorGraph::remove_edge(EdgeId e)
+{
+	auto it = edges.find(e);
+	if (it == edges.end()) return;
+
+	VertexId ends[] = { it->second.a, it->second.b };
+	for (auto v : ends)
+	{
+		auto adj = adjacency.find(v);
+		if (adj == adjacency.end()) continue;
+
+		auto & list = adj->second;
+		list.erase(std::remove(list.begin(), list.end(), e), list.end());
+		if (list.empty())
+		{
+			adjacency.erase(adj);
+		}
+	}
+	edges.erase(it);
+}
+
+void EDAnchorGraph::clear()
+{
+	edges.clear();
+	adjacency.clear();
+}
+
+bool EDAnchorGraph::find_edge(VertexId a, VertexId b, EdgeId & e) const
+{
+	auto adj = adjacency.find(a);
+	if (adj == adjacency.end()) return false;
+
+	for (auto candidate : adj->second)
+	{
+		auto & edge = edges.at(candidate);
+		if ((edge.a == a && edge.b == b) || (edge.a == b && edge.b == a))
+		{
+			e = candidate;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool EDAnchorGraph::find_path(VertexId from, VertexId to, std::vector<EdgeId> & path, size_t max_edges) const
+{
+	path.clear();
+	if (from == to) return false;
+
+	// vertex -> (edge we came through, depth)
+	struct Visit
+	{
+		EdgeId via;
+		size_t depth;
+	};
+	std::unordered_map<VertexId, Visit> visited;
+	std::deque<VertexId> frontier;
+
+	Visit root = { 0, 0 };
+	visited[from] = root;
+	frontier.push_back(from);
+
+	bool found = false;
+	while (!frontier.empty() && !found)
+	{
+		auto v = frontier.front();
+		frontier.pop_front();
+		auto depth = visited[v].depth;
+		if (max_edges && depth >= max_edges) continue;
+
+		auto adj = adjacency.find(v);
+		if (adj == adjacency.end()) continue;
+
+		for (auto e : adj->second)
+		{
+			auto & edge = edges.at(e);
+			// a direct from-to edge would only make a 2-sided loop
+			if ((edge.a == from && edge.b == to) || (edge.a == to && edge.b == from)) continue;
+
+			auto w = edge.a == v ? edge.b : edge.a;
+			if (visited.count(w)) continue;
+
+			Visit visit = { e, depth + 1 };
+			visited[w] = visit;
+			if (w == to)
+			{
+				found = true;
+				break;
+			}
+			frontier.push_back(w);
+		}
+	}
+
+	if (!found) return false;
+
+	// walk back from "to"
+	auto v = to;
+	while (v != from)
+	{
+		auto e = visited[v].via;
+		path.push_back(e);
+		auto & edge = edges.at(e);
+		v = edge.a == v ? edge.b : edge.a;
+	}
+	std::reverse(path.begin(), path.end());
+	return true;
+}
@@ -0,0 +1,64 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+// Anchor -> curve adjacency, used to find closed loops of curves.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+///
+//  Undirected multigraph: anchors are vertices, drawn curves are edges.
+//  Kept up to date as curves are added and deleted.
+///
+class EDAnchorGraph
+{
+public:
+	typedef size_t VertexId;
+	typedef size_t EdgeId;
+
+	void add_edge(EdgeId e, VertexId a, VertexId b);
+	void remove_edge(EdgeId e);
+	void clear();
+
+	// any edge directly joining a and b
+	bool find_edge(VertexId a, VertexId b, EdgeId & e) const;
+
+	///
+	//  Shortest chain of at least two edges from "from" to "to", in order.
+	//  A curve joining "from" and "to" closes it into a minimal loop.
+	//  BFS, O(V+E). max_edges = 0 means no bound.
+	///
+	bool find_path(VertexId from, VertexId to, std::vector<EdgeId> & path, size_t max_edges = 0) const;
+
+private:
+	struct Edge
+	{
+		VertexId a;
+		VertexId b;
+	};
+
+	std::unordered_map<EdgeId, Edge> edges;
+	std::unordered_map<VertexId, std::vector<EdgeId>> adjacency;
+};
@@ -0,0 +1,390 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// Created: Oct 19, 2026
+
+#include "EDBvh.h"
+#include "EDKernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	const int kBins = 12;
+	const int kLeafSize = 4;
+
+	struct Box
+	{
+		float lo[3];
+		float hi[3];
+
+		Box()
+		{
+			for (int a = 0; a < 3; a++)
+			{
+				lo[a] = std::numeric_limits<float>::max();
+				hi[a] = -std::numeric_limits<float>::max();
+			}
+		}
+
+		void grow(const float p[3])
+		{
+			for (int a = 0; a < 3; a++)
+			{
+				lo[a] = std::min(lo[a], p[a]);
+				hi[a] = std::max(hi[a], p[a]);
+			}
+		}
+
+		void grow(const Box & b)
+		{
+			grow(b.lo);
+			grow(b.hi);
+		}
+
+		float area() const
+		{
+			float d[3];
+			for (int a = 0; a < 3; a++) d[a] = std::max(hi[a] - lo[a], 0.0f);
+			return d[0] * d[1] + d[1] * d[2] + d[2] * d[0];
+		}
+	};
+}
+
+struct EDBvh::Build
+{
+	std::vector<Box> boxes;
+	std::vector<float> centroids;  // xyz per triangle
+};
+
+void EDBvh::clear()
+{
+	nodes.clear();
+	order.clear();
+	tris.clear();
+	stride = 0;
+}
+
+void EDBvh::build(const float * x, const float * y, const float * z, const int * triangles, size_t triangle_count)
+{
+	clear();
+	if (triangle_count == 0) return;
+
+	Build b;
+	b.boxes.resize(triangle_count);
+	b.centroids.resize(triangle_count * 3);
+	order.resize(triangle_count);
+	for (size_t t = 0; t < triangle_count; t++)
+	{
+		order[t] = static_cast<int>(t);
+		for (int k = 0; k < 3; k++)
+		{
+			int v = triangles[t * 3 + k];
+			float p[] = { x[v], y[v], z[v] };
+			b.boxes[t].grow(p);
+		}
+		for (int a = 0; a < 3; a++)
+		{
+			b.centroids[t * 3 + a] = 0.5f * (b.boxes[t].lo[a] + b.boxes[t].hi[a]);
+		}
+	}
+
+	nodes.reserve(triangle_count * 2);
+	nodes.push_back(Node());
+	build_node(b, 0, 0, static_cast<int>(triangle_count), 0);
+
+	// corners in leaf order; the padding lets the leaf kernels read 8 wide past the end
+	stride = triangle_count + kPadding;
+	tris.assign(stride * 9, 0.0f);
+	for (size_t i = 0; i < triangle_count; i++)
+	{
+		auto c = &triangles[order[i] * 3];
+		float * out = &tris[i];
+		out[0] = x[c[0]];
+		out[stride] = y[c[0]];
+		out[stride * 2] = z[c[0]];
+		out[stride * 3] = x[c[1]] - out[0];
+		out[stride * 4] = y[c[1]] - out[stride];
+		out[stride * 5] = z[c[1]] - out[stride * 2];
+		out[stride * 6] = x[c[2]] - out[0];
+		out[stride * 7] = y[c[2]] - out[stride];
+		out[stride * 8] = z[c[2]] - out[stride * 2];
+	}
+}
+
+void EDBvh::build_node(Build & b, int index, int begin, int end, int depth)
+{
+	Box box, centroid_box;
+	for (int i = begin; i < end; i++)
+	{
+		box.grow(b.boxes[order[i]]);
+		centroid_box.grow(&b.centroids[order[i] * 3]);
+	}
+	std::copy(box.lo, box.lo + 3, nodes[index].lo);
+	std::copy(box.hi, box.hi + 3, nodes[index].hi);
+	nodes[index].first = begin;
+	nodes[index].count = end - begin;
+
+	int count = end - begin;
+	int axis = 0;
+	float extent[3];
+	for (int a = 0; a < 3; a++) extent[a] = centroid_box.hi[a] - centroid_box.lo[a];
+	if (extent[1] > extent[axis]) axis = 1;
+	if (extent[2] > extent[axis]) axis = 2;
+
+	if (count <= kLeafSize || depth >= kMaxDepth || !(extent[axis] > 0)) return;
+
+	// surface area heuristic over centroid bins
+	Box bin_boxes[kBins];
+	int bin_counts[kBins] = {};
+	float scale = kBins / extent[axis];
+	auto bin_of = [&](int t)
+	{
+		int k = static_cast<int>((b.centroids[t * 3 + axis] - centroid_box.lo[axis]) * scale);
+		return std::min(std::max(k, 0), kBins - 1);
+	};
+	for (int i = begin; i < end; i++)
+	{
+		auto k = bin_of(order[i]);
+		bin_counts[k]++;
+		bin_boxes[k].grow(b.boxes[order[i]]);
+	}
+
+	// cost of splitting after bin k
+	float left_area[kBins - 1], right_area[kBins - 1];
+	int left_count[kBins - 1], right_count[kBins - 1];
+	Box left, right;
+	int lc = 0, rc = 0;
+	for (int k = 0; k < kBins - 1; k++)
+	{
+		left.grow(bin_boxes[k]);
+		lc += bin_counts[k];
+		left_area[k] = left.area();
+		left_count[k] = lc;
+
+		right.grow(bin_boxes[kBins - 1 - k]);
+		rc += bin_counts[kBins - 1 - k];
+		right_area[kBins - 2 - k] = right.area();
+		right_count[kBins - 2 - k] = rc;
+	}
+
+	int best = -1;
+	float best_cost = count * box.area();
+	for (int k = 0; k < kBins - 1; k++)
+	{
+		if (left_count[k] == 0 || right_count[k] == 0) continue;
+		float cost = left_count[k] * left_area[k] + right_count[k] * right_area[k];
+		if (cost < best_cost)
+		{
+			best_cost = cost;
+			best = k;
+		}
+	}
+
+	int mid;
+	if (best >= 0)
+	{
+		mid = static_cast<int>(std::partition(order.begin() + begin, order.begin() + end,
+			[&](int t) { return bin_of(t) <= best; }) - order.begin());
+	}
+	else if (count <= 4 * kLeafSize)
+	{
+		// splitting does not pay off
+		return;
+	}
+	else
+	{
+		mid = begin + count / 2;
+		std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end,
+			[&](int p, int q) { return b.centroids[p * 3 + axis] < b.centroids[q * 3 + axis]; });
+	}
+
+	auto left_index = static_cast<int>(nodes.size());
+	nodes.push_back(Node());
+	nodes.push_back(Node());
+	nodes[index].first = left_index;
+	nodes[index].count = 0;
+
+	build_node(b, left_index, begin, mid, depth + 1);
+	build_node(b, left_index + 1, mid, end, depth + 1);
+}
+
+namespace
+{
+	// slab test; returns the entry distance or a negative value on a miss
+	inline float enter_box(const float lo[3], const float hi[3], const float origin[3], const float inv_dir[3], float t_max)
+	{
+		float t0 = 0, t1 = t_max;
+		for (int a = 0; a < 3; a++)
+		{
+			float near_t = (lo[a] - origin[a]) * inv_dir[a];
+			float far_t = (hi[a] - origin[a]) * inv_dir[a];
+			if (near_t > far_t) std::swap(near_t, far_t);
+			// NaN from 0 * inf stays out of the comparison
+			if (near_t > t0) t0 = near_t;
+			if (far_t < t1) t1 = far_t;
+			if (t0 > t1) return -1;
+		}
+		return t0;
+	}
+}
+
+// Moller-Trumbore against entry i of order, both facings
+bool EDBvh::hit_triangle(int i, const float origin[3], const float direction[3], float t_max, Hit & hit) const
+{
+	float v0[] = { tris[i], tris[stride + i], tris[stride * 2 + i] };
+	float e1[] = { tris[stride * 3 + i], tris[stride * 4 + i], tris[stride * 5 + i] };
+	float e2[] = { tris[stride * 6 + i], tris[stride * 7 + i], tris[stride * 8 + i] };
+	float p[] = {
+		direction[1] * e2[2] - direction[2] * e2[1],
+		direction[2] * e2[0] - direction[0] * e2[2],
+		direction[0] * e2[1] - direction[1] * e2[0] };
+	float det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+	if (std::abs(det) < 1e-12f) return false;
+	float inv_det = 1.0f / det;
+	float s[] = { origin[0] - v0[0], origin[1] - v0[1], origin[2] - v0[2] };
+	float u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inv_det;
+	if (u < -EDKernels::kEdgeSlack || u > 1 + EDKernels::kEdgeSlack) return false;
+	float q[] = {
+		s[1] * e1[2] - s[2] * e1[1],
+		s[2] * e1[0] - s[0] * e1[2],
+		s[0] * e1[1] - s[1] * e1[0] };
+	float v = (direction[0] * q[0] + direction[1] * q[1] + direction[2] * q[2]) * inv_det;
+	if (v < -EDKernels::kEdgeSlack || u + v > 1 + EDKernels::kEdgeSlack) return false;
+	float t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * inv_det;
+	if (t < 0 || t > t_max) return false;
+
+	hit.t = t;
+	hit.triangle = order[i];
+	hit.u = u;
+	hit.v = v;
+	return true;
+}
+
+bool EDBvh::intersect(const float origin[3], const float direction[3], Hit & hit, float t_max) const
+{
+	if (nodes.empty()) return false;
+
+	float inv_dir[3];
+	for (int a = 0; a < 3; a++)
+	{
+		inv_dir[a] = direction[a] != 0 ? 1.0f / direction[a] : std::numeric_limits<float>::max();
+	}
+
+	auto & kernels = EDKernels::get();
+	bool found = false;
+	float best_t = t_max;
+
+	int stack[kMaxDepth + 2];
+	int top = 0;
+	if (enter_box(nodes[0].lo, nodes[0].hi, origin, inv_dir, best_t) < 0) return false;
+	stack[top++] = 0;
+
+	while (top > 0)
+	{
+		auto & node = nodes[stack[--top]];
+		if (node.count > 0)
+		{
+			float t, u, v;
+			int i = kernels.nearest_triangle(&tris[0], stride, node.first, node.count, origin, direction, best_t, t, u, v);
+			if (i >= 0)
+			{
+				best_t = t;
+				hit.t = t;
+				hit.triangle = order[i];
+				hit.u = u;
+				hit.v = v;
+				found = true;
+			}
+			continue;
+		}
+
+		// visit the nearer child first
+		auto & l = nodes[node.first];
+		auto & r = nodes[node.first + 1];
+		float tl = enter_box(l.lo, l.hi, origin, inv_dir, best_t);
+		float tr = enter_box(r.lo, r.hi, origin, inv_dir, best_t);
+		if (tl >= 0 && tr >= 0)
+		{
+			if (tl < tr)
+			{
+				stack[top++] = node.first + 1;
+				stack[top++] = node.first;
+			}
+			else
+			{
+				stack[top++] = node.first;
+				stack[top++] = node.first + 1;
+			}
+		}
+		else if (tl >= 0)
+		{
+			stack[top++] = node.first;
+		}
+		else if (tr >= 0)
+		{
+			stack[top++] = node.first + 1;
+		}
+	}
+	return found;
+}
+
+void EDBvh::intersect_all(const float origin[3], const float direction[3], std::vector<Hit> & hits, float t_max) const
+{
+	if (nodes.empty()) return;
+
+	float inv_dir[3];
+	for (int a = 0; a < 3; a++)
+	{
+		inv_dir[a] = direction[a] != 0 ? 1.0f / direction[a] : std::numeric_limits<float>::max();
+	}
+
+	int stack[kMaxDepth + 2];
+	int top = 0;
+	stack[top++] = 0;
+	while (top > 0)
+	{
+		auto & node = nodes[stack[--top]];
+		if (enter_box(node.lo, node.hi, origin, inv_dir, t_max) < 0) continue;
+
+		if (node.count > 0)
+		{
+			Hit hit;
+			for (int i = node.first; i < node.first + node.count; i++)
+			{
+				if (hit_triangle(i, origin, direction, t_max, hit)) hits.push_back(hit);
+			}
+			continue;
+		}
+		stack[top++] = node.first;
+		stack[top++] = node.first + 1;
+	}
+}
+
+void EDBvh::bounds(float lo[3], float hi[3]) const
+{
+	for (int a = 0; a < 3; a++)
+	{
+		lo[a] = nodes.empty() ? 0 : nodes[0].lo[a];
+		hi[a] = nodes.empty() ? 0 : nodes[0].hi[a];
+	}
+}
@@ -0,0 +1,86 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// Bounding volume hierarchy over triangles, for batched ray casts.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+///
+//  Binned-SAH BVH. Triangles are copied in as (v0, e1, e2) so the tree owns
+//  everything a ray test needs; leaves are tested several triangles at once
+//  by the EDKernels leaf kernel. Const queries are safe from many threads.
+///
+class EDBvh
+{
+public:
+	struct Hit
+	{
+		float t;
+		int triangle;  // index in the list given to build
+		float u, v;
+	};
+
+	// triangle i has corners triangles[3i..3i+2], indices into the axis arrays
+	void build(const float * x, const float * y, const float * z, const int * triangles, size_t triangle_count);
+	void clear();
+
+	bool empty() const { return nodes.empty(); }
+	size_t triangle_count() const { return order.size(); }
+
+	// nearest hit with t in [0, t_max]
+	bool intersect(const float origin[3], const float direction[3], Hit & hit,
+		float t_max = std::numeric_limits<float>::max()) const;
+	// appends every hit with t in [0, t_max], in no particular order
+	void intersect_all(const float origin[3], const float direction[3], std::vector<Hit> & hits,
+		float t_max = std::numeric_limits<float>::max()) const;
+
+	// bounds of everything in the tree
+	void bounds(float lo[3], float hi[3]) const;
+
+private:
+	struct Node
+	{
+		float lo[3];
+		float hi[3];
+		int first;  // leaf: first entry in order; inner: left child (right is first + 1)
+		int count;  // 0 for inner nodes
+	};
+
+	// traversal keeps a fixed stack, so the tree depth is capped
+	static const int kMaxDepth = 60;
+	static const size_t kPadding = 8;
+
+	struct Build;
+	bool hit_triangle(int i, const float origin[3], const float direction[3], float t_max, Hit & hit) const;
+	void build_node(Build & b, int index, int begin, int end, int depth);
+
+	std::vector<Node> nodes;
+	std::vector<int> order;
+	// 9 rows of stride floats, one per component of v0, e1, e2, entries in leaf order
+	std::vector<float> tris;
+	size_t stride = 0;
+};
@@ -0,0 +1,176 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+// Created: Oct 19, 2026
+
+#include "EDCurveFit.h"
+#include "EDEnvelopeCholesky.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// weight of the pull towards the chord, relative to one sample
+	const double kChordPull = 1e-6;
+}
+
+void EDCurveFit::knots(size_t control_count, std::vector<double> & out)
+{
+	auto spans = control_count - kDegree;
+	out.assign(control_count + kDegree + 1, 0.0);
+	for (size_t k = 0; k < out.size(); k++)
+	{
+		if (k <= static_cast<size_t>(kDegree)) continue;
+		out[k] = k >= control_count ? 1.0 : static_cast<double>(k - kDegree) / spans;
+	}
+}
+
+// Cox-de Boor, non-zero terms only
+size_t EDCurveFit::basis(const std::vector<double> & knot_vector, size_t control_count, double t, double values[kDegree + 1])
+{
+	auto & u = knot_vector;
+	size_t span = std::min<size_t>(control_count - 1,
+		std::upper_bound(u.begin() + kDegree, u.begin() + control_count, t) - u.begin() - 1);
+
+	double left[kDegree + 1], right[kDegree + 1];
+	values[0] = 1.0;
+	for (int j = 1; j <= kDegree; j++)
+	{
+		left[j] = t - u[span + 1 - j];
+		right[j] = u[span + j] - t;
+		double saved = 0.0;
+		for (int r = 0; r < j; r++)
+		{
+			double term = values[r] / (right[r + 1] + left[j - r]);
+			values[r] = saved + right[r + 1] * term;
+			saved = left[j - r] * term;
+		}
+		values[j] = saved;
+	}
+	return span - kDegree;
+}
+
+void EDCurveFit::evaluate(const std::vector<double> & control_points, double t, double p[3])
+{
+	auto count = control_points.size() / 3;
+	std::vector<double> u;
+	knots(count, u);
+	double n[kDegree + 1];
+	auto first = basis(u, count, std::min(std::max(t, 0.0), 1.0), n);
+	p[0] = p[1] = p[2] = 0;
+	for (int k = 0; k <= kDegree; k++)
+	{
+		for (int a = 0; a < 3; a++) p[a] += n[k] * control_points[(first + k) * 3 + a];
+	}
+}
+
+bool EDCurveFit::fit(const std::vector<double> & samples, int spans, std::vector<double> & control_points)
+{
+	auto sample_count = samples.size() / 3;
+	control_points.clear();
+	if (sample_count < 2) return false;
+
+	// chord-length parameters
+	std::vector<double> t(sample_count, 0.0);
+	for (size_t i = 1; i < sample_count; i++)
+	{
+		double d[3];
+		for (int a = 0; a < 3; a++) d[a] = samples[i * 3 + a] - samples[(i - 1) * 3 + a];
+		t[i] = t[i - 1] + std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+	}
+	auto total = t.back();
+	for (size_t i = 0; i < sample_count; i++)
+	{
+		t[i] = total > 0 ? t[i] / total : static_cast<double>(i) / (sample_count - 1);
+	}
+
+	spans = std::max(1, std::min(spans, static_cast<int>(sample_count) - 1));
+	size_t count = spans + kDegree;
+	std::vector<double> u;
+	knots(count, u);
+
+	const double * first = &samples[0];
+	const double * last = &samples[(sample_count - 1) * 3];
+	control_points.resize(count * 3);
+	for (int a = 0; a < 3; a++)
+	{
+		control_points[a] = first[a];
+		control_points[(count - 1) * 3 + a] = last[a];
+	}
+
+	// unknowns are the interior control points 1 .. count - 2
+	size_t n = count - 2;
+	std::vector<EDEnvelopeCholesky::Entry> entries;
+	std::vector<double> rhs[3];
+	for (int a = 0; a < 3; a++) rhs[a].assign(n, 0.0);
+
+	for (size_t i = 0; i < sample_count; i++)
+	{
+		double values[kDegree + 1];
+		auto base = basis(u, count, t[i], values);
+
+		// the fixed ends move to the right-hand side
+		double residual[3];
+		for (int a = 0; a < 3; a++) residual[a] = samples[i * 3 + a];
+		for (int k = 0; k <= kDegree; k++)
+		{
+			auto j = base + k;
+			if (j != 0 && j != count - 1) continue;
+			for (int a = 0; a < 3; a++) residual[a] -= values[k] * control_points[j * 3 + a];
+		}
+
+		for (int k = 0; k <= kDegree; k++)
+		{
+			auto j = base + k;
+			if (j == 0 || j == count - 1) continue;
+			for (int a = 0; a < 3; a++) rhs[a][j - 1] += values[k] * residual[a];
+			for (int l = 0; l <= k; l++)
+			{
+				auto m = base + l;
+				if (m == 0 || m == count - 1) continue;
+				EDEnvelopeCholesky::Entry e = { static_cast<int>(j - 1), static_cast<int>(m - 1), values[k] * values[l] };
+				entries.push_back(e);
+			}
+		}
+	}
+
+	// pull each interior point towards the chord at its Greville abscissa
+	for (size_t j = 1; j + 1 < count; j++)
+	{
+		double g = (u[j + 1] + u[j + 2] + u[j + 3]) / kDegree;
+		EDEnvelopeCholesky::Entry e = { static_cast<int>(j - 1), static_cast<int>(j - 1), kChordPull };
+		entries.push_back(e);
+		for (int a = 0; a < 3; a++) rhs[a][j - 1] += kChordPull * ((1 - g) * first[a] + g * last[a]);
+	}
+
+	EDEnvelopeCholesky solver;
+	if (!solver.factor(n, entries, n * n))
+	{
+		control_points.clear();
+		return false;
+	}
+	for (int a = 0; a < 3; a++)
+	{
+		solver.solve(rhs[a]);
+		for (size_t j = 0; j < n; j++) control_points[(j + 1) * 3 + a] = rhs[a][j];
+	}
+	return true;
+}
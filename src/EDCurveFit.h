@@ -0,0 +1,57 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+// Least-squares cubic B-spline through projected stroke samples.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+///
+//  The curves the plugin builds from strokes: a clamped uniform cubic
+//  B-spline with a fixed number of spans that keeps the end points and fits
+//  the samples in between by least squares at chord-length parameters.
+//
+//  The normal equations are banded (each sample touches 4 control points),
+//  so they go through EDEnvelopeCholesky. A light pull towards the chord
+//  keeps short strokes with fewer samples than control points solvable.
+///
+class EDCurveFit
+{
+public:
+	static const int kDegree = 3;
+
+	// xyz interleaved samples in, xyz interleaved control points out (spans + 3 of them);
+	// spans drop for strokes too short to support them. false for fewer than 2 samples
+	static bool fit(const std::vector<double> & samples, int spans, std::vector<double> & control_points);
+
+	// the clamped uniform knot vector for this many control points
+	static void knots(size_t control_count, std::vector<double> & out);
+
+	// point at parameter t in [0, 1]
+	static void evaluate(const std::vector<double> & control_points, double t, double p[3]);
+
+private:
+	// the kDegree + 1 non-zero basis values at t, and the first control point they weigh
+	static size_t basis(const std::vector<double> & knot_vector, size_t control_count, double t, double values[kDegree + 1]);
+};
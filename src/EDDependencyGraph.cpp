@@ -0,0 +1,144 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+// Created: Oct 19, 2026
+
+#include "EDDependencyGraph.h"
+#include "EDParallel.h"
+
+#include <algorithm>
+
+namespace
+{
+	const std::vector<EDDependencyGraph::NodeId> no_nodes;
+
+	void erase_value(std::vector<EDDependencyGraph::NodeId> & list, EDDependencyGraph::NodeId n)
+	{
+		list.erase(std::remove(list.begin(), list.end(), n), list.end());
+	}
+}
+
+void EDDependencyGraph::add_edge(NodeId upstream, NodeId downstream)
+{
+	auto & d = down[upstream];
+	if (std::find(d.begin(), d.end(), downstream) != d.end()) return;
+
+	d.push_back(downstream);
+	up[downstream].push_back(upstream);
+}
+
+void EDDependencyGraph::remove_node(NodeId n)
+{
+	auto d = down.find(n);
+	if (d != down.end())
+	{
+		for (auto m : d->second) erase_value(up[m], n);
+		down.erase(d);
+	}
+
+	auto u = up.find(n);
+	if (u != up.end())
+	{
+		for (auto m : u->second) erase_value(down[m], n);
+		up.erase(u);
+	}
+	dirty.erase(n);
+}
+
+void EDDependencyGraph::clear()
+{
+	down.clear();
+	up.clear();
+	dirty.clear();
+}
+
+const std::vector<EDDependencyGraph::NodeId> & EDDependencyGraph::downstream_of(NodeId n) const
+{
+	auto it = down.find(n);
+	return it == down.end() ? no_nodes : it->second;
+}
+
+const std::vector<EDDependencyGraph::NodeId> & EDDependencyGraph::upstream_of(NodeId n) const
+{
+	auto it = up.find(n);
+	return it == up.end() ? no_nodes : it->second;
+}
+
+void EDDependencyGraph::mark_dirty(NodeId n)
+{
+	std::vector<NodeId> stack(1, n);
+	while (!stack.empty())
+	{
+		auto m = stack.back();
+		stack.pop_back();
+		if (!dirty.insert(m).second) continue;
+
+		for (auto d : downstream_of(m)) stack.push_back(d);
+	}
+}
+
+void EDDependencyGraph::dirty_levels(std::vector<std::vector<NodeId>> & levels) const
+{
+	levels.clear();
+
+	// Kahn's algorithm restricted to the dirty subgraph
+	std::unordered_map<NodeId, size_t> pending;
+	std::vector<NodeId> current;
+	for (auto n : dirty)
+	{
+		size_t count = 0;
+		for (auto u : upstream_of(n))
+		{
+			if (dirty.count(u)) count++;
+		}
+		pending[n] = count;
+		if (count == 0) current.push_back(n);
+	}
+
+	while (!current.empty())
+	{
+		levels.push_back(current);
+		std::vector<NodeId> next;
+		for (auto n : current)
+		{
+			for (auto d : downstream_of(n))
+			{
+				auto it = pending.find(d);
+				if (it != pending.end() && --it->second == 0) next.push_back(d);
+			}
+		}
+		current.swap(next);
+	}
+}
+
+void EDDependencyGraph::evaluate(const std::function<void(NodeId)> & fn, bool parallel)
+{
+	std::vector<std::vector<NodeId>> levels;
+	dirty_levels(levels);
+
+	for (auto & level : levels)
+	{
+		EDParallel::for_each_index(level.size(), [&](size_t i)
+		{
+			fn(level[i]);
+		}, parallel);
+	}
+	dirty.clear();
+}
@@ -0,0 +1,69 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+// Curve -> patch -> volume dependencies with dirty propagation.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+///
+//  DAG of generated shapes. Marking a node dirty dirties everything
+//  downstream of it; evaluate() then visits only the dirty nodes, level by
+//  level, so a node runs after all of its dirty inputs. Nodes on the same
+//  level do not depend on each other and may run in parallel.
+///
+class EDDependencyGraph
+{
+public:
+	typedef uint64_t NodeId;
+
+	void add_edge(NodeId upstream, NodeId downstream);
+	void remove_node(NodeId n);
+	void clear();
+
+	const std::vector<NodeId> & downstream_of(NodeId n) const;
+	const std::vector<NodeId> & upstream_of(NodeId n) const;
+
+	void mark_dirty(NodeId n);
+	bool is_dirty(NodeId n) const { return dirty.count(n) > 0; }
+	bool has_dirty() const { return !dirty.empty(); }
+
+	// dirty nodes grouped in topological levels
+	void dirty_levels(std::vector<std::vector<NodeId>> & levels) const;
+
+	///
+	//  Calls fn on every dirty node in dependency order and clears them.
+	//  With parallel set, the nodes of a level run on separate threads,
+	//  so fn must then be thread safe.
+	///
+	void evaluate(const std::function<void(NodeId)> & fn, bool parallel = false);
+
+private:
+	std::unordered_map<NodeId, std::vector<NodeId>> down;
+	std::unordered_map<NodeId, std::vector<NodeId>> up;
+	std::unordered_set<NodeId> dirty;
+};
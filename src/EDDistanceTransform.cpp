@@ -0,0 +1,129 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// Created: Oct 19, 2026
+
+#include "EDDistanceTransform.h"
+#include "EDParallel.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+	const size_t kRowBlock = 16;
+}
+
+void EDDistanceTransform::clear()
+{
+	w = h = 0;
+	nearest.clear();
+	column_nearest.clear();
+}
+
+const EDDistanceTransform::Nearest & EDDistanceTransform::nearest_at(int x, int y) const
+{
+	x = std::min(std::max(x, 0), w - 1);
+	y = std::min(std::max(y, 0), h - 1);
+	return nearest[y * w + x];
+}
+
+void EDDistanceTransform::build(const EDRasterizer & raster, bool parallel)
+{
+	w = raster.width();
+	h = raster.height();
+	nearest.resize(static_cast<size_t>(w) * h);
+	column_nearest.resize(static_cast<size_t>(w) * h);
+	if (w == 0 || h == 0) return;
+
+	// columns: two sweeps
+	EDParallel::for_each_index(w, [&](size_t col)
+	{
+		int x = static_cast<int>(col);
+		int last = -1;
+		for (int y = 0; y < h; y++)
+		{
+			if (raster.triangle_at(x, y) != EDRasterizer::kNoTriangle) last = y;
+			column_nearest[y * w + x] = last;
+		}
+		last = -1;
+		for (int y = h - 1; y >= 0; y--)
+		{
+			auto & c = column_nearest[y * w + x];
+			if (c == y) last = y;
+			if (last >= 0 && (c < 0 || last - y < y - c)) c = last;
+		}
+	}, parallel);
+
+	// rows: lower envelope of f(q) + (x - q)^2, f(q) = squared column distance
+	auto blocks = (static_cast<size_t>(h) + kRowBlock - 1) / kRowBlock;
+	EDParallel::for_each_index(blocks, [&](size_t block)
+	{
+		std::vector<int> v(w);
+		std::vector<double> z(w + 1);
+		std::vector<double> f(w);
+
+		int y_end = std::min(h, static_cast<int>((block + 1) * kRowBlock));
+		for (int y = static_cast<int>(block * kRowBlock); y < y_end; y++)
+		{
+			const int * row = &column_nearest[y * w];
+			Nearest * out = &nearest[y * w];
+
+			int k = -1;
+			for (int q = 0; q < w; q++)
+			{
+				if (row[q] < 0) continue;
+				double dy = row[q] - y;
+				f[q] = dy * dy;
+
+				double s = 0;
+				while (k >= 0)
+				{
+					int p = v[k];
+					s = ((f[q] + q * q) - (f[p] + p * p)) / (2.0 * (q - p));
+					if (s > z[k]) break;
+					k--;
+				}
+				k++;
+				v[k] = q;
+				z[k] = k == 0 ? -std::numeric_limits<double>::infinity() : s;
+				z[k + 1] = std::numeric_limits<double>::infinity();
+			}
+
+			if (k < 0)
+			{
+				Nearest none = { -1, -1, EDRasterizer::kNoTriangle };
+				std::fill(out, out + w, none);
+				continue;
+			}
+
+			int j = 0;
+			for (int x = 0; x < w; x++)
+			{
+				while (z[j + 1] < x) j++;
+				int nx = v[j];
+				int ny = row[nx];
+				Nearest n = { nx, ny, raster.triangle_at(nx, ny) };
+				out[x] = n;
+			}
+		}
+	}, parallel);
+}
@@ -0,0 +1,65 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// Screen-space distance transform of the rasterized mesh.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include "EDRasterizer.h"
+
+#include <vector>
+
+///
+//  For every pixel, the nearest pixel covered by the mesh and the triangle
+//  under it, stored together so a lookup is one read.
+//
+//  Exact Euclidean distances in two separable passes (Felzenszwalb and
+//  Huttenlocher): nearest covered pixel per column, then the lower envelope
+//  of parabolas along each row. O(pixels), rows and columns in parallel.
+///
+class EDDistanceTransform
+{
+public:
+	struct Nearest
+	{
+		int x, y;      // -1 if nothing is covered
+		int triangle;
+	};
+
+	void build(const EDRasterizer & raster, bool parallel = true);
+	void clear();
+
+	bool empty() const { return nearest.empty(); }
+	int width() const { return w; }
+	int height() const { return h; }
+
+	// out-of-port pixels are clamped to the border; not for an empty transform
+	const Nearest & nearest_at(int x, int y) const;
+
+private:
+	int w = 0;
+	int h = 0;
+	std::vector<Nearest> nearest;
+	// nearest covered row in the same column, -1 if none
+	std::vector<int> column_nearest;
+};
@@ -0,0 +1,224 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// Created: Oct 19, 2026
+
+#include "EDEnvelopeCholesky.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+
+namespace
+{
+	// reverse Cuthill-McKee over a symmetric adjacency, one component at a time
+	void reverse_cuthill_mckee(const std::vector<std::vector<int>> & adjacency, std::vector<int> & order)
+	{
+		auto n = adjacency.size();
+		order.clear();
+		order.reserve(n);
+		std::vector<bool> placed(n);
+
+		auto degree = [&](int v) { return adjacency[v].size(); };
+		auto by_degree = [&](int a, int b) { return degree(a) < degree(b); };
+
+		std::vector<int> by_start(n);
+		for (size_t i = 0; i < n; i++) by_start[i] = static_cast<int>(i);
+		std::stable_sort(by_start.begin(), by_start.end(), by_degree);
+
+		std::vector<int> next;
+		for (auto start : by_start)
+		{
+			if (placed[start]) continue;
+
+			// walk to a far node of the component first; its level structure is narrower
+			std::deque<int> frontier;
+			std::vector<int> seen;
+			frontier.push_back(start);
+			placed[start] = true;
+			seen.push_back(start);
+			int far_node = start;
+			while (!frontier.empty())
+			{
+				auto v = frontier.front();
+				frontier.pop_front();
+				far_node = v;
+				for (auto w : adjacency[v])
+				{
+					if (placed[w]) continue;
+					placed[w] = true;
+					seen.push_back(w);
+					frontier.push_back(w);
+				}
+			}
+			for (auto v : seen) placed[v] = false;
+
+			auto begin = order.size();
+			order.push_back(far_node);
+			placed[far_node] = true;
+			for (auto i = begin; i < order.size(); i++)
+			{
+				next.clear();
+				for (auto w : adjacency[order[i]])
+				{
+					if (!placed[w])
+					{
+						placed[w] = true;
+						next.push_back(w);
+					}
+				}
+				std::sort(next.begin(), next.end(), by_degree);
+				order.insert(order.end(), next.begin(), next.end());
+			}
+		}
+		std::reverse(order.begin(), order.end());
+	}
+}
+
+void EDEnvelopeCholesky::clear()
+{
+	first.clear();
+	diagonal_index.clear();
+	values.clear();
+	order.clear();
+	position.clear();
+}
+
+bool EDEnvelopeCholesky::factor(size_t n, const std::vector<Entry> & entries, size_t max_entries)
+{
+	clear();
+	if (n == 0) return false;
+
+	std::vector<std::vector<int>> adjacency(n);
+	for (auto & e : entries)
+	{
+		if (e.row == e.col) continue;
+		adjacency[e.row].push_back(e.col);
+		adjacency[e.col].push_back(e.row);
+	}
+	for (auto & list : adjacency)
+	{
+		std::sort(list.begin(), list.end());
+		list.erase(std::unique(list.begin(), list.end()), list.end());
+	}
+
+	reverse_cuthill_mckee(adjacency, order);
+	position.resize(n);
+	for (size_t i = 0; i < n; i++) position[order[i]] = static_cast<int>(i);
+
+	// profile of the permuted lower triangle
+	first.resize(n);
+	for (size_t i = 0; i < n; i++) first[i] = static_cast<int>(i);
+	for (auto & e : entries)
+	{
+		int r = position[e.row], c = position[e.col];
+		if (r < c) std::swap(r, c);
+		first[r] = std::min(first[r], c);
+	}
+
+	diagonal_index.resize(n);
+	size_t total = 0;
+	for (size_t i = 0; i < n; i++)
+	{
+		total += i - first[i] + 1;
+		if (total > max_entries)
+		{
+			clear();
+			return false;
+		}
+		diagonal_index[i] = total - 1;
+	}
+
+	values.assign(total, 0.0);
+	auto at = [&](int r, int c) -> double & { return values[diagonal_index[r] - (r - c)]; };
+	for (auto & e : entries)
+	{
+		int r = position[e.row], c = position[e.col];
+		if (r < c) std::swap(r, c);
+		at(r, c) += e.value;
+	}
+
+	// row by row: L[i][j] = (A[i][j] - sum_k L[i][k] L[j][k]) / L[j][j]
+	for (size_t ui = 0; ui < n; ui++)
+	{
+		int i = static_cast<int>(ui);
+		double * row_i = &values[diagonal_index[i] - (i - first[i])] - first[i];
+		for (int j = first[i]; j < i; j++)
+		{
+			const double * row_j = &values[diagonal_index[j] - (j - first[j])] - first[j];
+			double s = row_i[j];
+			for (int k = std::max(first[i], first[j]); k < j; k++)
+			{
+				s -= row_i[k] * row_j[k];
+			}
+			row_i[j] = s / row_j[j];
+		}
+
+		double d = row_i[i];
+		for (int k = first[i]; k < i; k++)
+		{
+			d -= row_i[k] * row_i[k];
+		}
+		if (!(d > 0))
+		{
+			clear();
+			return false;
+		}
+		row_i[i] = std::sqrt(d);
+	}
+	return true;
+}
+
+void EDEnvelopeCholesky::solve(std::vector<double> & b) const
+{
+	auto n = first.size();
+	if (n == 0 || b.size() != n) return;
+
+	std::vector<double> y(n);
+	for (size_t i = 0; i < n; i++) y[i] = b[order[i]];
+
+	// L y' = y
+	for (size_t ui = 0; ui < n; ui++)
+	{
+		int i = static_cast<int>(ui);
+		const double * row = &values[diagonal_index[i] - (i - first[i])] - first[i];
+		double s = y[i];
+		for (int k = first[i]; k < i; k++)
+		{
+			s -= row[k] * y[k];
+		}
+		y[i] = s / row[i];
+	}
+
+	// L^T x = y', walking the rows backwards
+	for (size_t ui = n; ui-- > 0;)
+	{
+		int i = static_cast<int>(ui);
+		const double * row = &values[diagonal_index[i] - (i - first[i])] - first[i];
+		y[i] /= row[i];
+		for (int k = first[i]; k < i; k++)
+		{
+			y[k] -= row[k] * y[i];
+		}
+	}
+
+	for (size_t i = 0; i < n; i++) b[order[i]] = y[i];
+}
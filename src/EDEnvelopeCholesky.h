@@ -0,0 +1,68 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// Envelope (profile) Cholesky factorization for sparse SPD systems.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+///
+//  Factors a sparse symmetric positive definite matrix once and solves for
+//  any number of right-hand sides by back-substitution. Rows are reordered
+//  with reverse Cuthill-McKee so the envelope (everything between a row's
+//  first non-zero and its diagonal) stays narrow; fill-in never leaves it.
+///
+class EDEnvelopeCholesky
+{
+public:
+	struct Entry
+	{
+		int row;
+		int col;
+		double value;
+	};
+
+	// entries may repeat (they are summed) and need only one triangle;
+	// false if the matrix is not positive definite or the envelope would
+	// exceed max_entries
+	bool factor(size_t n, const std::vector<Entry> & entries, size_t max_entries);
+	void clear();
+
+	bool empty() const { return diagonal_index.empty(); }
+	size_t size() const { return first.size(); }
+	size_t envelope_size() const { return values.size(); }
+
+	// solves A x = b in place
+	void solve(std::vector<double> & b) const;
+
+private:
+	// permuted row i holds columns first[i]..i at values[diagonal_index[i] - (i - first[i])]
+	std::vector<int> first;
+	std::vector<size_t> diagonal_index;
+	std::vector<double> values;
+	// permuted index -> original index, and back
+	std::vector<int> order;
+	std::vector<int> position;
+};
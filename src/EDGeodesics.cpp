@@ -0,0 +1,292 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// Created: Oct 19, 2026
+
+#include "EDGeodesics.h"
+
+#include "EDMeshSnapshot.h"
+#include "EDSparseCholesky.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+	struct Vec
+	{
+		double x, y, z;
+	};
+
+	inline Vec sub(const Vec & a, const Vec & b) { Vec r = { a.x - b.x, a.y - b.y, a.z - b.z }; return r; }
+	inline double dot(const Vec & a, const Vec & b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+	inline Vec cross(const Vec & a, const Vec & b)
+	{
+		Vec r = { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+		return r;
+	}
+	inline double norm(const Vec & a) { return std::sqrt(dot(a, a)); }
+
+	inline Vec point(const EDMeshSnapshot & mesh, int v)
+	{
+		Vec p = { mesh.x[v], mesh.y[v], mesh.z[v] };
+		return p;
+	}
+
+	int find_root(std::vector<int> & root, int v)
+	{
+		while (root[v] != v)
+		{
+			root[v] = root[root[v]];
+			v = root[v];
+		}
+		return v;
+	}
+}
+
+struct EDGeodesics::Factors
+{
+	MeshPtr mesh;
+	EDSparseCholesky heat;
+	EDSparseCholesky poisson;
+	// cotangents of each triangle's corners, 3 per triangle
+	std::vector<double> cotangents;
+	// connected component of each vertex; heat never crosses between them
+	std::vector<int> component;
+};
+
+void EDGeodesics::request(const EDMeshSnapshot & mesh)
+{
+	ready();
+	if (mesh.revision() == requested) return;
+	requested = mesh.revision();
+
+	if (mesh.empty())
+	{
+		queued.reset();
+		return;
+	}
+	// a running factorization cannot be stopped; this one follows it
+	auto copy = std::make_shared<const EDMeshSnapshot>(mesh);
+	if (job.valid())
+	{
+		queued = copy;
+	}
+	else
+	{
+		start(copy);
+	}
+}
+
+bool EDGeodesics::ready()
+{
+	if (job.valid() && job.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+	{
+		current = job.get();
+		if (queued)
+		{
+			start(queued);
+			queued.reset();
+		}
+	}
+	return current && current->mesh->revision() == requested;
+}
+
+void EDGeodesics::clear()
+{
+	if (job.valid()) job.wait();
+	job = std::future<FactorsPtr>();
+	current.reset();
+	queued.reset();
+	requested = 0;
+}
+
+unsigned EDGeodesics::mesh_revision() const
+{
+	return current ? current->mesh->revision() : 0;
+}
+
+void EDGeodesics::start(MeshPtr mesh)
+{
+	job = std::async(std::launch::async, &EDGeodesics::build, mesh);
+}
+
+EDGeodesics::FactorsPtr EDGeodesics::build(MeshPtr mesh)
+{
+	auto & snapshot = *mesh;
+	auto n = snapshot.vertex_count();
+	auto triangles = snapshot.triangle_count();
+	if (n == 0 || triangles == 0) return FactorsPtr();
+
+	auto factors = std::make_shared<Factors>();
+	factors->mesh = mesh;
+
+	// components by union-find over the triangles; loose vertices are their own
+	auto & component = factors->component;
+	component.resize(n);
+	for (size_t i = 0; i < n; i++) component[i] = static_cast<int>(i);
+	for (size_t t = 0; t < triangles; t++)
+	{
+		auto tri = &snapshot.triangles[t * 3];
+		auto a = find_root(component, tri[0]);
+		for (int k = 1; k < 3; k++)
+		{
+			auto b = find_root(component, tri[k]);
+			component[b] = a;
+		}
+	}
+	for (size_t i = 0; i < n; i++) component[i] = find_root(component, static_cast<int>(i));
+
+	// cotangent weights, lumped mass and mean edge length
+	auto & cotangents = factors->cotangents;
+	cotangents.resize(triangles * 3);
+	std::vector<double> mass(n, 0.0);
+	std::vector<EDSparseCholesky::Entry> laplacian;
+	laplacian.reserve(triangles * 9);
+	double edge_sum = 0;
+	for (size_t t = 0; t < triangles; t++)
+	{
+		auto tri = &snapshot.triangles[t * 3];
+		Vec p[] = { point(snapshot, tri[0]), point(snapshot, tri[1]), point(snapshot, tri[2]) };
+		auto double_area = norm(cross(sub(p[1], p[0]), sub(p[2], p[0])));
+		for (int k = 0; k < 3; k++)
+		{
+			auto a = sub(p[(k + 1) % 3], p[k]);
+			auto b = sub(p[(k + 2) % 3], p[k]);
+			auto c = dot(a, b) / std::max(norm(cross(a, b)), 1e-20);
+			cotangents[t * 3 + k] = c;
+			edge_sum += norm(a);
+
+			// the corner's cotangent weighs the edge across from it
+			int i = tri[(k + 1) % 3], j = tri[(k + 2) % 3];
+			EDSparseCholesky::Entry off = { i, j, -0.5 * c };
+			EDSparseCholesky::Entry di = { i, i, 0.5 * c };
+			EDSparseCholesky::Entry dj = { j, j, 0.5 * c };
+			laplacian.push_back(off);
+			laplacian.push_back(di);
+			laplacian.push_back(dj);
+
+			mass[tri[k]] += double_area / 6;
+		}
+	}
+	auto h = edge_sum / (triangles * 3);
+	if (!(h > 0)) return FactorsPtr();
+
+	// loose vertices get a token mass so both systems stay definite
+	double mean_mass = 0;
+	for (auto m : mass) mean_mass += m;
+	mean_mass /= n;
+	for (auto & m : mass) m = std::max(m, 1e-6 * mean_mass);
+
+	auto time = h * h;
+	std::vector<EDSparseCholesky::Entry> entries;
+	entries.reserve(laplacian.size() + n);
+
+	for (auto e : laplacian)
+	{
+		e.value *= time;
+		entries.push_back(e);
+	}
+	for (size_t i = 0; i < n; i++)
+	{
+		EDSparseCholesky::Entry e = { static_cast<int>(i), static_cast<int>(i), mass[i] };
+		entries.push_back(e);
+	}
+	if (!factors->heat.factor(n, entries, kMaxEntries)) return FactorsPtr();
+
+	// L is only semidefinite; a whisper of mass pins the constant
+	entries.assign(laplacian.begin(), laplacian.end());
+	for (size_t i = 0; i < n; i++)
+	{
+		EDSparseCholesky::Entry e = { static_cast<int>(i), static_cast<int>(i), 1e-8 * mass[i] / time };
+		entries.push_back(e);
+	}
+	if (!factors->poisson.factor(n, entries, kMaxEntries)) return FactorsPtr();
+	return factors;
+}
+
+bool EDGeodesics::distances(int source, std::vector<float> & out) const
+{
+	if (!current) return false;
+	auto & mesh = current->mesh;
+	auto & cotangents = current->cotangents;
+	auto & component = current->component;
+	auto n = component.size();
+	if (source < 0 || static_cast<size_t>(source) >= n) return false;
+
+	// heat after a short time
+	std::vector<double> u(n, 0.0);
+	u[source] = 1;
+	current->heat.solve(u);
+
+	// integrated divergence of the normalized, reversed heat gradient
+	std::vector<double> divergence(n, 0.0);
+	auto triangles = mesh->triangle_count();
+	for (size_t t = 0; t < triangles; t++)
+	{
+		auto tri = &mesh->triangles[t * 3];
+		Vec p[] = { point(*mesh, tri[0]), point(*mesh, tri[1]), point(*mesh, tri[2]) };
+		auto normal = cross(sub(p[1], p[0]), sub(p[2], p[0]));
+		auto double_area = norm(normal);
+		if (!(double_area > 0)) continue;
+
+		// grad u = sum u_k (N x e_k) / 2A, e_k the edge across from corner k
+		Vec grad = { 0, 0, 0 };
+		for (int k = 0; k < 3; k++)
+		{
+			auto g = cross(normal, sub(p[(k + 2) % 3], p[(k + 1) % 3]));
+			auto w = u[tri[k]] / (double_area * double_area);
+			grad.x += w * g.x;
+			grad.y += w * g.y;
+			grad.z += w * g.z;
+		}
+		auto length = norm(grad);
+		if (!(length > 0)) continue;
+		Vec x = { -grad.x / length, -grad.y / length, -grad.z / length };
+
+		for (int k = 0; k < 3; k++)
+		{
+			int j = (k + 1) % 3, l = (k + 2) % 3;
+			auto e1 = sub(p[j], p[k]);
+			auto e2 = sub(p[l], p[k]);
+			// cot of the corner across from each edge
+			divergence[tri[k]] += 0.5 * (cotangents[t * 3 + l] * dot(e1, x) + cotangents[t * 3 + j] * dot(e2, x));
+		}
+	}
+
+	// L phi = -div, with L positive semidefinite
+	for (auto & d : divergence) d = -d;
+	current->poisson.solve(divergence);
+
+	// phi is only defined up to a constant on each component, and the
+	// source's says nothing about the others
+	auto base = divergence[source];
+	out.resize(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		auto d = divergence[i] - base;
+		out[i] = component[i] == component[source] && std::isfinite(d) ?
+			static_cast<float>(std::max(d, 0.0)) : std::numeric_limits<float>::max();
+	}
+	return true;
+}
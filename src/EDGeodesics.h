@@ -0,0 +1,81 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// Geodesic distances on the mesh snapshot by the heat method.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <vector>
+
+class EDMeshSnapshot;
+
+///
+//  Heat method (Crane et al. 2013): diffuse heat from the source for a short
+//  time, normalize its gradient, and recover the distance whose gradient
+//  that is. Both linear systems (heat flow M + tL and the Poisson L) depend
+//  only on the mesh, so they are factored once per snapshot revision and
+//  every source costs two back-substitutions.
+//
+//  Factoring takes a copy of the snapshot to a worker thread; the caller
+//  polls ready() and uses straight-line distances until then. A revision
+//  requested while another is factoring is started once that one is done.
+///
+class EDGeodesics
+{
+public:
+	// non-zeros per factor; about 100 MB of rows and values
+	static const size_t kMaxEntries = 1 << 23;
+
+	// starts factoring the mesh unless its revision is the last requested
+	void request(const EDMeshSnapshot & mesh);
+	// takes a finished factorization; true if one for the last requested revision is in use
+	bool ready();
+	// waits for a running factorization and drops everything
+	void clear();
+	// waits for a running factorization; ready() then takes it
+	void wait() const { if (job.valid()) job.wait(); }
+
+	// revision of the factors in use, 0 if none
+	unsigned mesh_revision() const;
+
+	// distance from the source vertex to every vertex; FLT_MAX on the other
+	// components of the mesh
+	bool distances(int source, std::vector<float> & out) const;
+
+private:
+	struct Factors;
+	typedef std::shared_ptr<const Factors> FactorsPtr;
+	typedef std::shared_ptr<const EDMeshSnapshot> MeshPtr;
+
+	// null if the mesh is degenerate or too large to factor
+	static FactorsPtr build(MeshPtr mesh);
+	void start(MeshPtr mesh);
+
+	FactorsPtr current;
+	std::future<FactorsPtr> job;
+	MeshPtr queued;
+	unsigned requested = 0;
+};
@@ -0,0 +1,125 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// Created: Oct 19, 2026
+
+#include "EDHeightField.h"
+
+#include <algorithm>
+#include <cmath>
+
+void EDHeightField::clear()
+{
+	tree.reset();
+	tree_size = 0;
+	x.clear();
+	y.clear();
+	z.clear();
+	h.clear();
+}
+
+void EDHeightField::add(float px, float py, float pz, float height)
+{
+	x.push_back(px);
+	y.push_back(py);
+	z.push_back(pz);
+	h.push_back(height);
+}
+
+void EDHeightField::build()
+{
+	if (pending() <= kMinPending + tree_size / 8) return;
+
+	tree.reset();
+	tree_size = h.size();
+	cloud.field = this;
+	tree.reset(new Tree(3 /*dim*/, cloud, nanoflann::KDTreeSingleIndexAdaptorParams(10)));
+	tree->buildIndex();
+}
+
+bool EDHeightField::evaluate(const float p[3], float & height,
+	const float * extra_heights, const float * extra_distances, size_t extra_count) const
+{
+	float sum = 0, weight_sum = 0;
+	for (size_t k = 0; k < extra_count; k++)
+	{
+		auto d = extra_distances[k];
+		if (d < 1e-6f)
+		{
+			height = extra_heights[k];
+			return true;
+		}
+		auto w = 1 / (d * d);
+		sum += w * extra_heights[k];
+		weight_sum += w;
+	}
+
+	if (!h.empty())
+	{
+		size_t index[kNeighbours];
+		float dist_sq[kNeighbours];
+		size_t found = 0;
+		if (tree)
+		{
+			found = std::min<size_t>(kNeighbours, tree_size);
+			tree->knnSearch(p, found, index, dist_sq);
+		}
+
+		// pending sites go into the same nearest-first list
+		for (auto i = tree_size; i < h.size(); i++)
+		{
+			float dx = x[i] - p[0], dy = y[i] - p[1], dz = z[i] - p[2];
+			float d = dx * dx + dy * dy + dz * dz;
+			if (found == kNeighbours && d >= dist_sq[found - 1]) continue;
+
+			size_t k = found < kNeighbours ? found++ : found - 1;
+			for (; k > 0 && dist_sq[k - 1] > d; k--)
+			{
+				dist_sq[k] = dist_sq[k - 1];
+				index[k] = index[k - 1];
+			}
+			dist_sq[k] = d;
+			index[k] = i;
+		}
+
+		// results come nearest first
+		if (dist_sq[0] < 1e-12f || (found == 1 && extra_count == 0))
+		{
+			height = h[index[0]];
+			return true;
+		}
+
+		// Wendland C2 support just beyond the farthest neighbour
+		auto support = std::sqrt(dist_sq[found - 1]) * 1.05f;
+		for (size_t k = 0; k < found; k++)
+		{
+			auto r = std::sqrt(dist_sq[k]) / support;
+			auto s = 1 - r;
+			auto w = s * s * s * s * (4 * r + 1) / dist_sq[k];
+			sum += w * h[index[k]];
+			weight_sum += w;
+		}
+	}
+	if (!(weight_sum > 0)) return false;
+
+	height = sum / weight_sum;
+	return true;
+}
@@ -0,0 +1,104 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// Heights above the mesh, interpolated from scattered known ones.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include <nanoflann.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+///
+//  Known heights at points on the surface (anchors, projected curve
+//  samples) in a 3D kd-tree. A query blends its k nearest sites with
+//  Wendland weights whose support reaches just past the k-th one, divided
+//  by squared distance so known sites are matched exactly. No system is
+//  solved, so adding sites costs only the tree build.
+//
+//  Callers may pass extra sites known only by their distance to the query
+//  (a stroke's own ends, measured along the surface). They are always
+//  blended in, weighted by inverse squared distance.
+//
+//  Sites added after the last tree build wait in a short pending list that
+//  queries scan directly; the tree is only rebuilt once that list has grown
+//  past a fraction of it, so adding one curve's samples costs no rebuild.
+///
+class EDHeightField
+{
+public:
+	static const int kNeighbours = 8;
+
+	void clear();
+	void add(float x, float y, float z, float height);
+	// call after adding sites, before evaluating; rebuilds the tree only when the pending list is long
+	void build();
+
+	bool empty() const { return h.empty(); }
+	size_t size() const { return h.size(); }
+	size_t pending() const { return h.size() - tree_size; }
+
+	bool evaluate(const float p[3], float & height,
+		const float * extra_heights = nullptr, const float * extra_distances = nullptr, size_t extra_count = 0) const;
+
+private:
+	struct Cloud
+	{
+		const EDHeightField * field = nullptr;
+
+		size_t kdtree_get_point_count() const { return field->tree_size; }
+
+		float kdtree_distance(const float * p, const size_t i, size_t /*size*/) const
+		{
+			const float d0 = p[0] - field->x[i];
+			const float d1 = p[1] - field->y[i];
+			const float d2 = p[2] - field->z[i];
+			return d0 * d0 + d1 * d1 + d2 * d2;
+		}
+
+		float kdtree_get_pt(const size_t i, int dim) const
+		{
+			return dim == 0 ? field->x[i] : dim == 1 ? field->y[i] : field->z[i];
+		}
+
+		template <class BBOX>
+		bool kdtree_get_bbox(BBOX & /*bb*/) const { return false; }
+	};
+
+	typedef nanoflann::KDTreeSingleIndexAdaptor<
+		nanoflann::L2_Simple_Adaptor<float, Cloud>,
+		Cloud,
+		3 /* dim */
+	> Tree;
+
+	// pending sites scanned directly, past this plus a fraction of the tree
+	static const size_t kMinPending = 256;
+
+	std::vector<float> x, y, z, h;
+	// sites [0, tree_size) are in the tree, the rest are pending
+	size_t tree_size = 0;
+	Cloud cloud;
+	std::unique_ptr<Tree> tree;
+};
@@ -0,0 +1,143 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+// Bounded undo/redo journal of strokes.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <list>
+
+///
+//  Done strokes and undone strokes. Records are moved between the two
+//  lists by splicing, never copied. When the journal grows over its memory
+//  cap the oldest done strokes are dropped and can no longer be undone.
+//
+//  Record needs memory_size() and a size_t counted the journal keeps its
+//  last count of the record in (EDStrokeRecord in the plugin).
+///
+template <typename Record>
+class EDJournal
+{
+public:
+	///
+	//  Adds a new done stroke. The redo list survives until confirm(), so a
+	//  stroke that fails to commit can be dropped with discard_last() and
+	//  leave the history as it was.
+	///
+	Record & push()
+	{
+		done.emplace_back();
+		update_memory();
+		return done.back();
+	}
+
+	// the last pushed stroke committed; what was undone before it can no longer be redone
+	void confirm()
+	{
+		for (auto & r : undone) used -= r.counted;
+		undone.clear();
+	}
+
+	// forgets the last done stroke, e.g. when it failed to commit
+	void discard_last()
+	{
+		if (done.empty()) return;
+
+		used -= done.back().counted;
+		done.pop_back();
+	}
+
+	// the record that was undone/redone, nullptr if there is none
+	Record * undo()
+	{
+		if (done.empty()) return nullptr;
+
+		undone.splice(undone.end(), done, std::prev(done.end()));
+		return &undone.back();
+	}
+
+	Record * redo()
+	{
+		if (undone.empty()) return nullptr;
+
+		done.splice(done.end(), undone, std::prev(undone.end()));
+		return &done.back();
+	}
+
+	// recount the latest stroke after it was filled in or changed in place
+	void update_memory()
+	{
+		if (done.empty()) return;
+
+		auto & r = done.back();
+		used -= r.counted;
+		r.counted = r.memory_size();
+		used += r.counted;
+	}
+
+	// drops the oldest strokes until under the cap; returns how many
+	size_t trim()
+	{
+		size_t dropped = 0;
+		// the redo list goes first, furthest from the present first
+		while (used > memory_cap && !undone.empty())
+		{
+			used -= undone.front().counted;
+			undone.pop_front();
+		}
+		// always keep the latest stroke undoable
+		while (used > memory_cap && done.size() > 1)
+		{
+			used -= done.front().counted;
+			done.pop_front();
+			dropped++;
+		}
+		return dropped;
+	}
+
+	void clear()
+	{
+		done.clear();
+		undone.clear();
+		used = 0;
+	}
+
+	bool can_undo() const { return !done.empty(); }
+	bool can_redo() const { return !undone.empty(); }
+	size_t undo_count() const { return done.size(); }
+	size_t redo_count() const { return undone.size(); }
+
+	void set_memory_cap(size_t bytes) { memory_cap = bytes; }
+	size_t get_memory_cap() const { return memory_cap; }
+	size_t memory_used() const { return used; }
+
+private:
+	std::list<Record> done;
+	std::list<Record> undone;
+	size_t memory_cap = 64 * 1024 * 1024;
+	// running total of counted over both lists
+	size_t used = 0;
+};
@@ -0,0 +1,126 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+// Created: Oct 19, 2026
+
+#include "EDKernels.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define ED_CPUID_MSVC
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#define ED_CPUID_GCC
+#endif
+
+namespace
+{
+	std::once_flag selected;
+	const EDKernelTable * active = nullptr;
+
+	// registers eax, ebx, ecx, edx of CPUID leaf / subleaf
+	bool cpuid(unsigned leaf, unsigned subleaf, unsigned r[4])
+	{
+#if defined(ED_CPUID_MSVC)
+		int regs[4];
+		__cpuid(regs, 0);
+		if (static_cast<unsigned>(regs[0]) < leaf) return false;
+		__cpuidex(regs, static_cast<int>(leaf), static_cast<int>(subleaf));
+		for (int k = 0; k < 4; k++) r[k] = static_cast<unsigned>(regs[k]);
+		return true;
+#elif defined(ED_CPUID_GCC)
+		if (__get_cpuid_max(0, nullptr) < leaf) return false;
+		__cpuid_count(leaf, subleaf, r[0], r[1], r[2], r[3]);
+		return true;
+#else
+		(void)leaf;
+		(void)subleaf;
+		(void)r;
+		return false;
+#endif
+	}
+
+	// XCR0: which register states the OS saves on a context switch
+	unsigned long long xgetbv0()
+	{
+#if defined(ED_CPUID_MSVC)
+		return _xgetbv(0);
+#elif defined(ED_CPUID_GCC)
+		unsigned lo, hi;
+		__asm__ volatile(".byte 0x0f, 0x01, 0xd0" : "=a"(lo), "=d"(hi) : "c"(0));
+		return (static_cast<unsigned long long>(hi) << 32) | lo;
+#else
+		return 0;
+#endif
+	}
+
+	bool has_avx2()
+	{
+		unsigned r[4];
+		if (!cpuid(1, 0, r)) return false;
+		const unsigned kFma = 1u << 12, kOsXsave = 1u << 27, kAvx = 1u << 28;
+		if ((r[2] & (kFma | kOsXsave | kAvx)) != (kFma | kOsXsave | kAvx)) return false;
+		// xmm and ymm state
+		if ((xgetbv0() & 6) != 6) return false;
+
+		if (!cpuid(7, 0, r)) return false;
+		const unsigned kAvx2 = 1u << 5;
+		return (r[1] & kAvx2) != 0;
+	}
+}
+
+EDKernels::Isa EDKernels::detect()
+{
+	auto cap = std::getenv("EASYDRESS_SIMD");
+	if (cap && std::strcmp(cap, "baseline") == 0) return kBaseline;
+
+	return has_avx2() ? kAVX2 : kBaseline;
+}
+
+const EDKernelTable * EDKernels::table(Isa isa)
+{
+	switch (isa)
+	{
+	case kAVX2:
+		return avx2_table();
+	default:
+		return baseline_table();
+	}
+}
+
+// call_once rather than a function-local static: VS2013 does not make those thread safe
+const EDKernelTable & EDKernels::select()
+{
+	std::call_once(selected, []
+	{
+		auto chosen = table(detect());
+		active = chosen ? chosen : baseline_table();
+	});
+	return *active;
+}
+
+const EDKernelTable & EDKernels::get()
+{
+	return select();
+}
@@ -0,0 +1,94 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+// SIMD kernels of the projection path, one table per instruction set.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include <cstddef>
+
+struct EDRayBatch;
+struct EDPlane;
+
+///
+//  Every kernel is compiled once per instruction set, each set in its own
+//  translation unit: EDKernelsBaseline.cpp (SSE2 where the target has it,
+//  plain C++ otherwise) and EDKernelsAVX2.cpp (AVX2 and FMA, enabled per
+//  function rather than per file). select() asks CPUID which sets the CPU
+//  and OS can run and keeps the widest, so one binary runs everywhere.
+//
+//  Callers go through the wrappers in EDRays and EDBvh rather than the table.
+///
+struct EDKernelTable
+{
+	const char * name;
+
+	// rays [begin, end) through pixels; m is the inverse view-projection, (sx, sy) = 2 / port size
+	void (*unproject)(const float m[4][4], float sx, float sy, const float * px, const float * py, size_t begin, size_t end,
+		EDRayBatch & rays);
+
+	void (*project_on_plane)(const EDRayBatch & rays, size_t begin, size_t end, const EDPlane & plane,
+		float * x, float * y, float * z);
+
+	void (*minimum_skew_viewplanes)(size_t count, const float * rx, const float * ry, const float * rz,
+		const float * dx, const float * dy, const float * dz, float * nx, float * ny, float * nz);
+
+	// world to port pixels with the view-projection m; points behind the camera become NaN
+	void (*to_port)(const float m[4][4], float width, float height, const float * x, const float * y, const float * z,
+		size_t count, float * px, float * py, float * pz);
+
+	///
+	//  Nearest of the triangles [first, first + count) of a BVH leaf hit with t
+	//  in [0, t_max]. tris holds 9 rows of stride floats (v0, e1, e2 by axis)
+	//  and must stay readable 8 floats past the last triangle. Barycentrics
+	//  may overshoot by EDKernels::kEdgeSlack. Returns the triangle or -1.
+	///
+	int (*nearest_triangle)(const float * tris, size_t stride, int first, int count,
+		const float origin[3], const float direction[3], float t_max, float & t, float & u, float & v);
+};
+
+namespace EDKernels
+{
+	enum Isa
+	{
+		kBaseline,
+		kAVX2
+	};
+
+	// how far a hit's barycentrics may stray outside its triangle, so a ray
+	// down an edge two triangles share cannot round its way between them
+	const float kEdgeSlack = 1e-5f;
+
+	// widest set the CPU and OS support; EASYDRESS_SIMD=baseline caps it
+	Isa detect();
+
+	// picks the table once, whichever thread asks first; later calls return it
+	const EDKernelTable & select();
+	const EDKernelTable & get();
+
+	// null if this build has no table for the set
+	const EDKernelTable * table(Isa isa);
+
+	// defined by the per-set translation units
+	const EDKernelTable * baseline_table();
+	const EDKernelTable * avx2_table();
+}
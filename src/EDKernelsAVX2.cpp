@@ -0,0 +1,272 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+// Kernels for CPUs with AVX2 and FMA. Built with the project's usual flags:
+// only the functions here are compiled for AVX2, so inline library code
+// they pull in stays baseline and the linker cannot pick a VEX copy of it.
+//
+// Created: Oct 19, 2026
+
+#include "EDKernels.h"
+#include "EDRays.h"
+
+// MSVC emits AVX2 intrinsics without /arch; GCC and Clang need them enabled per function
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define ED_KERNELS_AVX2
+#define ED_AVX2
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define ED_KERNELS_AVX2
+#define ED_AVX2 __attribute__((target("avx2,fma")))
+#endif
+
+#ifdef ED_KERNELS_AVX2
+#include <immintrin.h>
+#include <limits>
+#endif
+
+#ifdef ED_KERNELS_AVX2
+
+namespace
+{
+	// remainders of fewer than 8 go to the baseline kernels
+	const EDKernelTable & tail()
+	{
+		return *EDKernels::baseline_table();
+	}
+
+	ED_AVX2 inline __m256 dot(__m256 a0, __m256 a1, __m256 a2, __m256 b0, __m256 b1, __m256 b2)
+	{
+		return _mm256_fmadd_ps(a0, b0, _mm256_fmadd_ps(a1, b1, _mm256_mul_ps(a2, b2)));
+	}
+
+	// a x b, one component
+	ED_AVX2 inline __m256 cross(__m256 a1, __m256 a2, __m256 b1, __m256 b2)
+	{
+		return _mm256_fmsub_ps(a1, b2, _mm256_mul_ps(a2, b1));
+	}
+
+	ED_AVX2 void unproject(const float m[4][4], float sx, float sy, const float * px, const float * py, size_t begin, size_t end,
+		EDRayBatch & rays)
+	{
+		size_t i = begin;
+		const __m256 one = _mm256_set1_ps(1.0f);
+		const __m256 scale_x = _mm256_set1_ps(sx), scale_y = _mm256_set1_ps(sy);
+		__m256 row0[4], row1[4], row2[4], row3[4];
+		for (int c = 0; c < 4; c++)
+		{
+			row0[c] = _mm256_set1_ps(m[0][c]);
+			row1[c] = _mm256_set1_ps(m[1][c]);
+			row2[c] = _mm256_set1_ps(m[2][c]);
+			row3[c] = _mm256_set1_ps(m[3][c]);
+		}
+		for (; i + 8 <= end; i += 8)
+		{
+			__m256 nx = _mm256_fmsub_ps(_mm256_loadu_ps(px + i), scale_x, one);
+			__m256 ny = _mm256_fmsub_ps(_mm256_loadu_ps(py + i), scale_y, one);
+
+			__m256 near_h[4], far_h[4];
+			for (int c = 0; c < 4; c++)
+			{
+				__m256 base = _mm256_fmadd_ps(nx, row0[c], _mm256_fmadd_ps(ny, row1[c], row3[c]));
+				near_h[c] = _mm256_sub_ps(base, row2[c]);
+				far_h[c] = _mm256_add_ps(base, row2[c]);
+			}
+			__m256 near_w = _mm256_div_ps(one, near_h[3]);
+			__m256 far_w = _mm256_div_ps(one, far_h[3]);
+
+			__m256 o[3], d[3];
+			for (int c = 0; c < 3; c++)
+			{
+				o[c] = _mm256_mul_ps(near_h[c], near_w);
+				d[c] = _mm256_fmsub_ps(far_h[c], far_w, o[c]);
+			}
+			__m256 inv_length = _mm256_div_ps(one, _mm256_sqrt_ps(dot(d[0], d[1], d[2], d[0], d[1], d[2])));
+
+			_mm256_storeu_ps(&rays.ox[i], o[0]);
+			_mm256_storeu_ps(&rays.oy[i], o[1]);
+			_mm256_storeu_ps(&rays.oz[i], o[2]);
+			_mm256_storeu_ps(&rays.dx[i], _mm256_mul_ps(d[0], inv_length));
+			_mm256_storeu_ps(&rays.dy[i], _mm256_mul_ps(d[1], inv_length));
+			_mm256_storeu_ps(&rays.dz[i], _mm256_mul_ps(d[2], inv_length));
+		}
+		tail().unproject(m, sx, sy, px, py, i, end, rays);
+	}
+
+	ED_AVX2 void project_on_plane(const EDRayBatch & rays, size_t begin, size_t end, const EDPlane & plane,
+		float * x, float * y, float * z)
+	{
+		auto & p = plane.point;
+		auto & n = plane.normal;
+		size_t i = begin;
+		const __m256 px = _mm256_set1_ps(static_cast<float>(p[0])), py = _mm256_set1_ps(static_cast<float>(p[1])), pz = _mm256_set1_ps(static_cast<float>(p[2]));
+		const __m256 nx = _mm256_set1_ps(static_cast<float>(n[0])), ny = _mm256_set1_ps(static_cast<float>(n[1])), nz = _mm256_set1_ps(static_cast<float>(n[2]));
+		for (; i + 8 <= end; i += 8)
+		{
+			__m256 ox = _mm256_loadu_ps(&rays.ox[i]), oy = _mm256_loadu_ps(&rays.oy[i]), oz = _mm256_loadu_ps(&rays.oz[i]);
+			__m256 dx = _mm256_loadu_ps(&rays.dx[i]), dy = _mm256_loadu_ps(&rays.dy[i]), dz = _mm256_loadu_ps(&rays.dz[i]);
+
+			__m256 num = dot(_mm256_sub_ps(px, ox), _mm256_sub_ps(py, oy), _mm256_sub_ps(pz, oz), nx, ny, nz);
+			__m256 t = _mm256_div_ps(num, dot(dx, dy, dz, nx, ny, nz));
+
+			_mm256_storeu_ps(x + i, _mm256_fmadd_ps(t, dx, ox));
+			_mm256_storeu_ps(y + i, _mm256_fmadd_ps(t, dy, oy));
+			_mm256_storeu_ps(z + i, _mm256_fmadd_ps(t, dz, oz));
+		}
+		tail().project_on_plane(rays, i, end, plane, x, y, z);
+	}
+
+	ED_AVX2 void minimum_skew_viewplanes(size_t count, const float * rx, const float * ry, const float * rz,
+		const float * dx, const float * dy, const float * dz, float * nx, float * ny, float * nz)
+	{
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 r[] = { _mm256_loadu_ps(rx + i), _mm256_loadu_ps(ry + i), _mm256_loadu_ps(rz + i) };
+			__m256 d[] = { _mm256_loadu_ps(dx + i), _mm256_loadu_ps(dy + i), _mm256_loadu_ps(dz + i) };
+
+			// c = r x d, then d x c
+			__m256 c[] = { cross(r[1], r[2], d[1], d[2]), cross(r[2], r[0], d[2], d[0]), cross(r[0], r[1], d[0], d[1]) };
+			_mm256_storeu_ps(nx + i, cross(d[1], d[2], c[1], c[2]));
+			_mm256_storeu_ps(ny + i, cross(d[2], d[0], c[2], c[0]));
+			_mm256_storeu_ps(nz + i, cross(d[0], d[1], c[0], c[1]));
+		}
+		tail().minimum_skew_viewplanes(count - i, rx + i, ry + i, rz + i, dx + i, dy + i, dz + i, nx + i, ny + i, nz + i);
+	}
+
+	ED_AVX2 void to_port(const float m[4][4], float width, float height, const float * x, const float * y, const float * z,
+		size_t count, float * px, float * py, float * pz)
+	{
+		size_t i = 0;
+		const __m256 one = _mm256_set1_ps(1.0f), near_w = _mm256_set1_ps(1e-6f);
+		const __m256 w_scale = _mm256_set1_ps(width * 0.5f), h_scale = _mm256_set1_ps(height * 0.5f);
+		const __m256 not_a_number = _mm256_set1_ps(std::numeric_limits<float>::quiet_NaN());
+		__m256 row0[4], row1[4], row2[4], row3[4];
+		for (int c = 0; c < 4; c++)
+		{
+			row0[c] = _mm256_set1_ps(m[0][c]);
+			row1[c] = _mm256_set1_ps(m[1][c]);
+			row2[c] = _mm256_set1_ps(m[2][c]);
+			row3[c] = _mm256_set1_ps(m[3][c]);
+		}
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 wx = _mm256_loadu_ps(x + i), wy = _mm256_loadu_ps(y + i), wz = _mm256_loadu_ps(z + i);
+			__m256 clip[4];
+			for (int c = 0; c < 4; c++)
+			{
+				clip[c] = _mm256_fmadd_ps(wx, row0[c], _mm256_fmadd_ps(wy, row1[c], _mm256_fmadd_ps(wz, row2[c], row3[c])));
+			}
+			__m256 in_front = _mm256_cmp_ps(clip[3], near_w, _CMP_GT_OQ);
+			__m256 inv_w = _mm256_div_ps(one, clip[3]);
+
+			__m256 sx = _mm256_mul_ps(_mm256_fmadd_ps(clip[0], inv_w, one), w_scale);
+			__m256 sy = _mm256_mul_ps(_mm256_fmadd_ps(clip[1], inv_w, one), h_scale);
+			__m256 sz = _mm256_mul_ps(clip[2], inv_w);
+			_mm256_storeu_ps(px + i, _mm256_blendv_ps(not_a_number, sx, in_front));
+			_mm256_storeu_ps(py + i, _mm256_blendv_ps(not_a_number, sy, in_front));
+			_mm256_storeu_ps(pz + i, _mm256_blendv_ps(not_a_number, sz, in_front));
+		}
+		tail().to_port(m, width, height, x + i, y + i, z + i, count - i, px + i, py + i, pz + i);
+	}
+
+	ED_AVX2 int nearest_triangle(const float * tris, size_t stride, int first, int count,
+		const float origin[3], const float direction[3], float t_max, float & t, float & u, float & v)
+	{
+		const float * rows[9];
+		for (int r = 0; r < 9; r++) rows[r] = tris + stride * r;
+
+		const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f), tiny = _mm256_set1_ps(1e-12f);
+		const __m256 low = _mm256_set1_ps(-EDKernels::kEdgeSlack), high = _mm256_set1_ps(1.0f + EDKernels::kEdgeSlack);
+		const __m256 sign = _mm256_set1_ps(-0.0f);
+		const __m256 lane = _mm256_set_ps(7, 6, 5, 4, 3, 2, 1, 0);
+		const __m256 o[] = { _mm256_set1_ps(origin[0]), _mm256_set1_ps(origin[1]), _mm256_set1_ps(origin[2]) };
+		const __m256 d[] = { _mm256_set1_ps(direction[0]), _mm256_set1_ps(direction[1]), _mm256_set1_ps(direction[2]) };
+		int best = -1;
+		for (int k = 0; k < count; k += 8)
+		{
+			int i = first + k;
+			__m256 a[] = { _mm256_loadu_ps(rows[0] + i), _mm256_loadu_ps(rows[1] + i), _mm256_loadu_ps(rows[2] + i) };
+			__m256 b[] = { _mm256_loadu_ps(rows[3] + i), _mm256_loadu_ps(rows[4] + i), _mm256_loadu_ps(rows[5] + i) };
+			__m256 c[] = { _mm256_loadu_ps(rows[6] + i), _mm256_loadu_ps(rows[7] + i), _mm256_loadu_ps(rows[8] + i) };
+
+			// lanes past the leaf belong to the next one
+			__m256 valid = _mm256_cmp_ps(lane, _mm256_set1_ps(static_cast<float>(count - k)), _CMP_LT_OQ);
+
+			__m256 p[] = { cross(d[1], d[2], c[1], c[2]), cross(d[2], d[0], c[2], c[0]), cross(d[0], d[1], c[0], c[1]) };
+			__m256 det = dot(b[0], b[1], b[2], p[0], p[1], p[2]);
+			valid = _mm256_and_ps(valid, _mm256_cmp_ps(_mm256_andnot_ps(sign, det), tiny, _CMP_GE_OQ));
+			if (!_mm256_movemask_ps(valid)) continue;
+			__m256 inv_det = _mm256_div_ps(one, det);
+
+			__m256 s[] = { _mm256_sub_ps(o[0], a[0]), _mm256_sub_ps(o[1], a[1]), _mm256_sub_ps(o[2], a[2]) };
+			__m256 lu = _mm256_mul_ps(dot(s[0], s[1], s[2], p[0], p[1], p[2]), inv_det);
+			valid = _mm256_and_ps(valid, _mm256_and_ps(_mm256_cmp_ps(lu, low, _CMP_GE_OQ), _mm256_cmp_ps(lu, high, _CMP_LE_OQ)));
+
+			__m256 q[] = { cross(s[1], s[2], b[1], b[2]), cross(s[2], s[0], b[2], b[0]), cross(s[0], s[1], b[0], b[1]) };
+			__m256 lv = _mm256_mul_ps(dot(d[0], d[1], d[2], q[0], q[1], q[2]), inv_det);
+			valid = _mm256_and_ps(valid, _mm256_and_ps(_mm256_cmp_ps(lv, low, _CMP_GE_OQ), _mm256_cmp_ps(_mm256_add_ps(lu, lv), high, _CMP_LE_OQ)));
+
+			__m256 lt = _mm256_mul_ps(dot(c[0], c[1], c[2], q[0], q[1], q[2]), inv_det);
+			valid = _mm256_and_ps(valid, _mm256_and_ps(_mm256_cmp_ps(lt, zero, _CMP_GE_OQ), _mm256_cmp_ps(lt, _mm256_set1_ps(t_max), _CMP_LE_OQ)));
+
+			int mask = _mm256_movemask_ps(valid);
+			if (!mask) continue;
+
+			float ts[8], us[8], vs[8];
+			_mm256_storeu_ps(ts, lt);
+			_mm256_storeu_ps(us, lu);
+			_mm256_storeu_ps(vs, lv);
+			for (int j = 0; j < 8; j++)
+			{
+				if (!(mask & (1 << j)) || ts[j] > t_max) continue;
+				t_max = ts[j];
+				best = i + j;
+				t = ts[j];
+				u = us[j];
+				v = vs[j];
+			}
+		}
+		return best;
+	}
+
+	const EDKernelTable kTable =
+	{
+		"avx2",
+		unproject,
+		project_on_plane,
+		minimum_skew_viewplanes,
+		to_port,
+		nearest_triangle
+	};
+}
+
+const EDKernelTable * EDKernels::avx2_table()
+{
+	return &kTable;
+}
+
+#else
+
+const EDKernelTable * EDKernels::avx2_table()
+{
+	return nullptr;
+}
+
+#endif
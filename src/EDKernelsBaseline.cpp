@@ -0,0 +1,348 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+// Kernels for every x86-64 CPU: SSE2, or plain C++ on other targets.
+//
+// Created: Oct 19, 2026
+
+#include "EDKernels.h"
+#include "EDMathCore.h"
+#include "EDRays.h"
+
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ED_KERNELS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	void unproject(const float m[4][4], float sx, float sy, const float * px, const float * py, size_t begin, size_t end,
+		EDRayBatch & rays)
+	{
+		size_t i = begin;
+#ifdef ED_KERNELS_SSE2
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 scale_x = _mm_set1_ps(sx), scale_y = _mm_set1_ps(sy);
+		__m128 row0[4], row1[4], row2[4], row3[4];
+		for (int c = 0; c < 4; c++)
+		{
+			row0[c] = _mm_set1_ps(m[0][c]);
+			row1[c] = _mm_set1_ps(m[1][c]);
+			row2[c] = _mm_set1_ps(m[2][c]);
+			row3[c] = _mm_set1_ps(m[3][c]);
+		}
+		for (; i + 4 <= end; i += 4)
+		{
+			// to normalized device coordinates
+			__m128 nx = _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(px + i), scale_x), one);
+			__m128 ny = _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(py + i), scale_y), one);
+
+			// (nx, ny, -1, 1) and (nx, ny, 1, 1) times the matrix share everything but row 2
+			__m128 base[4], near_h[4], far_h[4];
+			for (int c = 0; c < 4; c++)
+			{
+				base[c] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, row0[c]), _mm_mul_ps(ny, row1[c])), row3[c]);
+				near_h[c] = _mm_sub_ps(base[c], row2[c]);
+				far_h[c] = _mm_add_ps(base[c], row2[c]);
+			}
+			__m128 near_w = _mm_div_ps(one, near_h[3]);
+			__m128 far_w = _mm_div_ps(one, far_h[3]);
+
+			__m128 o[3], d[3];
+			for (int c = 0; c < 3; c++)
+			{
+				o[c] = _mm_mul_ps(near_h[c], near_w);
+				d[c] = _mm_sub_ps(_mm_mul_ps(far_h[c], far_w), o[c]);
+			}
+			__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(d[0], d[0]), _mm_mul_ps(d[1], d[1])), _mm_mul_ps(d[2], d[2])));
+			__m128 inv_length = _mm_div_ps(one, length);
+
+			_mm_storeu_ps(&rays.ox[i], o[0]);
+			_mm_storeu_ps(&rays.oy[i], o[1]);
+			_mm_storeu_ps(&rays.oz[i], o[2]);
+			_mm_storeu_ps(&rays.dx[i], _mm_mul_ps(d[0], inv_length));
+			_mm_storeu_ps(&rays.dy[i], _mm_mul_ps(d[1], inv_length));
+			_mm_storeu_ps(&rays.dz[i], _mm_mul_ps(d[2], inv_length));
+		}
+#endif
+
+		for (; i < end; i++)
+		{
+			float nx = px[i] * sx - 1.0f, ny = py[i] * sy - 1.0f;
+			float near_h[4], far_h[4];
+			for (int c = 0; c < 4; c++)
+			{
+				float base = nx * m[0][c] + ny * m[1][c] + m[3][c];
+				near_h[c] = base - m[2][c];
+				far_h[c] = base + m[2][c];
+			}
+			float near_w = 1.0f / near_h[3], far_w = 1.0f / far_h[3];
+			float o[3], d[3];
+			for (int c = 0; c < 3; c++)
+			{
+				o[c] = near_h[c] * near_w;
+				d[c] = far_h[c] * far_w - o[c];
+			}
+			float inv_length = 1.0f / std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+
+			rays.ox[i] = o[0];
+			rays.oy[i] = o[1];
+			rays.oz[i] = o[2];
+			rays.dx[i] = d[0] * inv_length;
+			rays.dy[i] = d[1] * inv_length;
+			rays.dz[i] = d[2] * inv_length;
+		}
+	}
+
+	void project_on_plane(const EDRayBatch & rays, size_t begin, size_t end, const EDPlane & plane,
+		float * x, float * y, float * z)
+	{
+		auto & p = plane.point;
+		auto & n = plane.normal;
+		size_t i = begin;
+		// four rays at a time through the EDMathCore template, SSE2 where the target has it
+		typedef EDVec3<EDFloat4> Vec4;
+		const Vec4 point(static_cast<float>(p[0]), static_cast<float>(p[1]), static_cast<float>(p[2]));
+		const Vec4 normal(static_cast<float>(n[0]), static_cast<float>(n[1]), static_cast<float>(n[2]));
+		for (; i + 4 <= end; i += 4)
+		{
+			Vec4 origin(EDFloat4::load(&rays.ox[i]), EDFloat4::load(&rays.oy[i]), EDFloat4::load(&rays.oz[i]));
+			Vec4 direction(EDFloat4::load(&rays.dx[i]), EDFloat4::load(&rays.dy[i]), EDFloat4::load(&rays.dz[i]));
+			auto hit = EDMath::project_on_plane(point, normal, origin, direction);
+			hit.x.store(x + i);
+			hit.y.store(y + i);
+			hit.z.store(z + i);
+		}
+		for (; i < end; i++)
+		{
+			double o[] = { rays.ox[i], rays.oy[i], rays.oz[i] };
+			double d[] = { rays.dx[i], rays.dy[i], rays.dz[i] };
+			double t = ((p[0] - o[0]) * n[0] + (p[1] - o[1]) * n[1] + (p[2] - o[2]) * n[2])
+				/ (d[0] * n[0] + d[1] * n[1] + d[2] * n[2]);
+			x[i] = static_cast<float>(o[0] + t * d[0]);
+			y[i] = static_cast<float>(o[1] + t * d[1]);
+			z[i] = static_cast<float>(o[2] + t * d[2]);
+		}
+	}
+
+	void minimum_skew_viewplanes(size_t count, const float * rx, const float * ry, const float * rz,
+		const float * dx, const float * dy, const float * dz, float * nx, float * ny, float * nz)
+	{
+		size_t i = 0;
+		typedef EDVec3<EDFloat4> Vec4;
+		for (; i + 4 <= count; i += 4)
+		{
+			Vec4 r(EDFloat4::load(rx + i), EDFloat4::load(ry + i), EDFloat4::load(rz + i));
+			Vec4 d(EDFloat4::load(dx + i), EDFloat4::load(dy + i), EDFloat4::load(dz + i));
+			auto n = EDMath::minimum_skew_viewplane(r, d);
+			n.x.store(nx + i);
+			n.y.store(ny + i);
+			n.z.store(nz + i);
+		}
+		for (; i < count; i++)
+		{
+			double r[] = { rx[i], ry[i], rz[i] };
+			double d[] = { dx[i], dy[i], dz[i] };
+			double c[] = { r[1] * d[2] - r[2] * d[1], r[2] * d[0] - r[0] * d[2], r[0] * d[1] - r[1] * d[0] };
+			nx[i] = static_cast<float>(d[1] * c[2] - d[2] * c[1]);
+			ny[i] = static_cast<float>(d[2] * c[0] - d[0] * c[2]);
+			nz[i] = static_cast<float>(d[0] * c[1] - d[1] * c[0]);
+		}
+	}
+
+	void to_port(const float m[4][4], float width, float height, const float * x, const float * y, const float * z,
+		size_t count, float * px, float * py, float * pz)
+	{
+		const float nan = std::numeric_limits<float>::quiet_NaN();
+		size_t i = 0;
+#ifdef ED_KERNELS_SSE2
+		const __m128 one = _mm_set1_ps(1.0f), near_w = _mm_set1_ps(1e-6f);
+		const __m128 w_scale = _mm_set1_ps(width * 0.5f), h_scale = _mm_set1_ps(height * 0.5f);
+		const __m128 not_a_number = _mm_set1_ps(nan);
+		__m128 row0[4], row1[4], row2[4], row3[4];
+		for (int c = 0; c < 4; c++)
+		{
+			row0[c] = _mm_set1_ps(m[0][c]);
+			row1[c] = _mm_set1_ps(m[1][c]);
+			row2[c] = _mm_set1_ps(m[2][c]);
+			row3[c] = _mm_set1_ps(m[3][c]);
+		}
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 wx = _mm_loadu_ps(x + i), wy = _mm_loadu_ps(y + i), wz = _mm_loadu_ps(z + i);
+			__m128 clip[4];
+			for (int c = 0; c < 4; c++)
+			{
+				clip[c] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(wx, row0[c]), _mm_mul_ps(wy, row1[c])),
+					_mm_add_ps(_mm_mul_ps(wz, row2[c]), row3[c]));
+			}
+			__m128 in_front = _mm_cmpgt_ps(clip[3], near_w);
+			__m128 inv_w = _mm_div_ps(one, clip[3]);
+
+			// (ndc * 0.5 + 0.5) * size = (ndc + 1) * size / 2
+			__m128 sx = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(clip[0], inv_w), one), w_scale);
+			__m128 sy = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(clip[1], inv_w), one), h_scale);
+			__m128 sz = _mm_mul_ps(clip[2], inv_w);
+			_mm_storeu_ps(px + i, _mm_or_ps(_mm_and_ps(in_front, sx), _mm_andnot_ps(in_front, not_a_number)));
+			_mm_storeu_ps(py + i, _mm_or_ps(_mm_and_ps(in_front, sy), _mm_andnot_ps(in_front, not_a_number)));
+			_mm_storeu_ps(pz + i, _mm_or_ps(_mm_and_ps(in_front, sz), _mm_andnot_ps(in_front, not_a_number)));
+		}
+#endif
+		for (; i < count; i++)
+		{
+			float clip[4];
+			for (int c = 0; c < 4; c++)
+			{
+				clip[c] = x[i] * m[0][c] + y[i] * m[1][c] + z[i] * m[2][c] + m[3][c];
+			}
+			if (!(clip[3] > 1e-6f))
+			{
+				px[i] = py[i] = pz[i] = nan;
+				continue;
+			}
+			px[i] = (clip[0] / clip[3] * 0.5f + 0.5f) * width;
+			py[i] = (clip[1] / clip[3] * 0.5f + 0.5f) * height;
+			pz[i] = clip[2] / clip[3];
+		}
+	}
+
+	// Moller-Trumbore, both facings
+	int nearest_triangle(const float * tris, size_t stride, int first, int count,
+		const float origin[3], const float direction[3], float t_max, float & t, float & u, float & v)
+	{
+		const float * v0[] = { tris, tris + stride, tris + stride * 2 };
+		const float * e1[] = { tris + stride * 3, tris + stride * 4, tris + stride * 5 };
+		const float * e2[] = { tris + stride * 6, tris + stride * 7, tris + stride * 8 };
+		int best = -1;
+		int k = 0;
+#ifdef ED_KERNELS_SSE2
+		const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f), tiny = _mm_set1_ps(1e-12f);
+		const __m128 low = _mm_set1_ps(-EDKernels::kEdgeSlack), high = _mm_set1_ps(1.0f + EDKernels::kEdgeSlack);
+		const __m128 sign = _mm_set1_ps(-0.0f);
+		const __m128 lane = _mm_set_ps(3, 2, 1, 0);
+		const __m128 o[] = { _mm_set1_ps(origin[0]), _mm_set1_ps(origin[1]), _mm_set1_ps(origin[2]) };
+		const __m128 d[] = { _mm_set1_ps(direction[0]), _mm_set1_ps(direction[1]), _mm_set1_ps(direction[2]) };
+		for (; k < count; k += 4)
+		{
+			int i = first + k;
+			__m128 a[] = { _mm_loadu_ps(v0[0] + i), _mm_loadu_ps(v0[1] + i), _mm_loadu_ps(v0[2] + i) };
+			__m128 b[] = { _mm_loadu_ps(e1[0] + i), _mm_loadu_ps(e1[1] + i), _mm_loadu_ps(e1[2] + i) };
+			__m128 c[] = { _mm_loadu_ps(e2[0] + i), _mm_loadu_ps(e2[1] + i), _mm_loadu_ps(e2[2] + i) };
+
+			// lanes past the leaf belong to the next one
+			__m128 valid = _mm_cmplt_ps(lane, _mm_set1_ps(static_cast<float>(count - k)));
+
+			__m128 p[] = {
+				_mm_sub_ps(_mm_mul_ps(d[1], c[2]), _mm_mul_ps(d[2], c[1])),
+				_mm_sub_ps(_mm_mul_ps(d[2], c[0]), _mm_mul_ps(d[0], c[2])),
+				_mm_sub_ps(_mm_mul_ps(d[0], c[1]), _mm_mul_ps(d[1], c[0])) };
+			__m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(b[0], p[0]), _mm_mul_ps(b[1], p[1])), _mm_mul_ps(b[2], p[2]));
+			valid = _mm_and_ps(valid, _mm_cmpge_ps(_mm_andnot_ps(sign, det), tiny));
+			if (!_mm_movemask_ps(valid)) continue;
+			__m128 inv_det = _mm_div_ps(one, det);
+
+			__m128 s[] = { _mm_sub_ps(o[0], a[0]), _mm_sub_ps(o[1], a[1]), _mm_sub_ps(o[2], a[2]) };
+			__m128 lu = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(s[0], p[0]), _mm_mul_ps(s[1], p[1])), _mm_mul_ps(s[2], p[2])), inv_det);
+			valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(lu, low), _mm_cmple_ps(lu, high)));
+
+			__m128 q[] = {
+				_mm_sub_ps(_mm_mul_ps(s[1], b[2]), _mm_mul_ps(s[2], b[1])),
+				_mm_sub_ps(_mm_mul_ps(s[2], b[0]), _mm_mul_ps(s[0], b[2])),
+				_mm_sub_ps(_mm_mul_ps(s[0], b[1]), _mm_mul_ps(s[1], b[0])) };
+			__m128 lv = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(d[0], q[0]), _mm_mul_ps(d[1], q[1])), _mm_mul_ps(d[2], q[2])), inv_det);
+			valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(lv, low), _mm_cmple_ps(_mm_add_ps(lu, lv), high)));
+
+			__m128 lt = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(c[0], q[0]), _mm_mul_ps(c[1], q[1])), _mm_mul_ps(c[2], q[2])), inv_det);
+			valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(lt, zero), _mm_cmple_ps(lt, _mm_set1_ps(t_max))));
+
+			int mask = _mm_movemask_ps(valid);
+			if (!mask) continue;
+
+			float ts[4], us[4], vs[4];
+			_mm_storeu_ps(ts, lt);
+			_mm_storeu_ps(us, lu);
+			_mm_storeu_ps(vs, lv);
+			for (int j = 0; j < 4; j++)
+			{
+				if (!(mask & (1 << j)) || ts[j] > t_max) continue;
+				t_max = ts[j];
+				best = i + j;
+				t = ts[j];
+				u = us[j];
+				v = vs[j];
+			}
+		}
+#endif
+		for (; k < count; k++)
+		{
+			int i = first + k;
+			float a[] = { v0[0][i], v0[1][i], v0[2][i] };
+			float b[] = { e1[0][i], e1[1][i], e1[2][i] };
+			float c[] = { e2[0][i], e2[1][i], e2[2][i] };
+			float p[] = {
+				direction[1] * c[2] - direction[2] * c[1],
+				direction[2] * c[0] - direction[0] * c[2],
+				direction[0] * c[1] - direction[1] * c[0] };
+			float det = b[0] * p[0] + b[1] * p[1] + b[2] * p[2];
+			if (std::abs(det) < 1e-12f) continue;
+			float inv_det = 1.0f / det;
+			float s[] = { origin[0] - a[0], origin[1] - a[1], origin[2] - a[2] };
+			float lu = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inv_det;
+			if (lu < -EDKernels::kEdgeSlack || lu > 1 + EDKernels::kEdgeSlack) continue;
+			float q[] = {
+				s[1] * b[2] - s[2] * b[1],
+				s[2] * b[0] - s[0] * b[2],
+				s[0] * b[1] - s[1] * b[0] };
+			float lv = (direction[0] * q[0] + direction[1] * q[1] + direction[2] * q[2]) * inv_det;
+			if (lv < -EDKernels::kEdgeSlack || lu + lv > 1 + EDKernels::kEdgeSlack) continue;
+			float lt = (c[0] * q[0] + c[1] * q[1] + c[2] * q[2]) * inv_det;
+			if (lt < 0 || lt > t_max) continue;
+
+			t_max = lt;
+			best = i;
+			t = lt;
+			u = lu;
+			v = lv;
+		}
+		return best;
+	}
+
+	const EDKernelTable kTable =
+	{
+#ifdef ED_KERNELS_SSE2
+		"sse2",
+#else
+		"scalar",
+#endif
+		unproject,
+		project_on_plane,
+		minimum_skew_viewplanes,
+		to_port,
+		nearest_triangle
+	};
+}
+
+const EDKernelTable * EDKernels::baseline_table()
+{
+	return &kTable;
+}
@@ -21,16 +21,19 @@
 // Created: Mar 29, 2016
 
 #include "EDMath.h"
+#include "EDMathMaya.h"
 
 #include <maya/MPoint.h>
+#include <maya/MMatrix.h>
 #include <maya/MFnMesh.h>
 
+#include <cmath>
+
 MPoint EDMath::projectOnPlane
 	(const MPoint & point, const MVector & plane_normal
 		, const MPoint & ray_origin, const MVector & unit_direction)
 {
-	return ray_origin + ((point - ray_origin) * plane_normal) * unit_direction
-        / (unit_direction * plane_normal);
+	return project_on_plane(point, plane_normal, ray_origin, unit_direction);
 }
 
 ///
@@ -41,8 +44,7 @@ MPoint EDMath::projectOnPlane
 ///
 MVector EDMath::minimumSkewViewplane(const MVector & ray_direction, const MVector & d)
 {
-	// ^ is cross
-	return d ^ (ray_direction ^ d);
+	return minimum_skew_viewplane(ray_direction, d);
 }
 
 ///
@@ -53,8 +55,7 @@ MVector EDMath::minimumSkewViewplane(const MVector & ray_direction, const MVecto
 ///
 MVector EDMath::minimumSkewViewplane(const MPoint & camera, const MPoint & p, const MVector & d)
 {
-	auto r = (p - camera).normal();
-	return d ^ (r ^ d);
+	return minimum_skew_viewplane(camera, p, d);
 }
 
 double EDMath::distance_to_mesh(const MFnMesh * selected_mesh, const MPoint & p)
@@ -74,3 +75,17 @@ double EDMath::distance_to_mesh(const MFnMesh * selected_mesh, const MPoint & p)
 	}
 
 }
+
+///
+//  Moller-Trumbore. Returns false only if the ray is parallel to the plane.
+///
+bool EDMath::intersectTriangle(const MPoint & v0, const MPoint & v1, const MPoint & v2
+	, const MPoint & ray_origin, const MVector & ray_direction, double & t, double & u, double & v)
+{
+	return intersect_triangle(v0, v1, v2, ray_origin, ray_direction, t, u, v);
+}
+
+bool EDMath::toPort(const MPoint & p, const MMatrix & view_projection, int width, int height, float & x, float & y, float & z)
+{
+	return to_port(view_projection.matrix, p.x, p.y, p.z, width, height, x, y, z);
+}
@@ -26,9 +26,12 @@
 
 class MPoint;
 class MVector;
+class MMatrix;
 class MFnMesh;
 
 
+// Maya entry points; they forward to the templates in EDMathCore.h, which
+// code without Maya uses directly
 namespace EDMath
 {
 	 MPoint projectOnPlane(const MPoint & point, const MVector & plane_normal
@@ -38,6 +41,13 @@ namespace EDMath
 	 MVector minimumSkewViewplane(const MPoint & camera, const MPoint & p, const MVector & d);
 	 double distance_to_mesh(const MFnMesh * selected_mesh, const MPoint & p);
 
+	 // world point to port pixels and NDC depth; false if it is behind the camera
+	 bool toPort(const MPoint & p, const MMatrix & view_projection, int width, int height, float & x, float & y, float & z);
+
+	 // ray against the plane of a triangle; u, v are barycentrics and are not range-checked
+	 bool intersectTriangle(const MPoint & v0, const MPoint & v1, const MPoint & v2
+		 , const MPoint & ray_origin, const MVector & ray_direction, double & t, double & u, double & v);
+
 	 template <typename T>
 	 struct PointCloud
 	 {
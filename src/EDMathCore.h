@@ -0,0 +1,272 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+// Maya-free geometry behind EDMath, templated on the vector type.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ED_MATH_SSE2
+#include <emmintrin.h>
+#endif
+
+///
+//  Four floats that act as one scalar, lane by lane. EDVec3<EDFloat4> is
+//  four vectors at once, so the templates below run four rays per call;
+//  the baseline kernels in EDKernelsBaseline.cpp run on it. The templates
+//  that can fail (intersect_triangle, contour_plane) fail for EDFloat4 if
+//  any of the four lanes would.
+///
+struct EDFloat4
+{
+#ifdef ED_MATH_SSE2
+	__m128 v;
+
+	EDFloat4() {}
+	EDFloat4(float s) : v(_mm_set1_ps(s)) {}
+	explicit EDFloat4(__m128 v) : v(v) {}
+
+	static EDFloat4 load(const float * p) { return EDFloat4(_mm_loadu_ps(p)); }
+	void store(float * p) const { _mm_storeu_ps(p, v); }
+#else
+	float v[4];
+
+	EDFloat4() {}
+	EDFloat4(float s) { v[0] = v[1] = v[2] = v[3] = s; }
+
+	static EDFloat4 load(const float * p) { EDFloat4 r; for (int k = 0; k < 4; k++) r.v[k] = p[k]; return r; }
+	void store(float * p) const { for (int k = 0; k < 4; k++) p[k] = v[k]; }
+#endif
+};
+
+#ifdef ED_MATH_SSE2
+inline EDFloat4 operator+(const EDFloat4 & a, const EDFloat4 & b) { return EDFloat4(_mm_add_ps(a.v, b.v)); }
+inline EDFloat4 operator-(const EDFloat4 & a, const EDFloat4 & b) { return EDFloat4(_mm_sub_ps(a.v, b.v)); }
+inline EDFloat4 operator*(const EDFloat4 & a, const EDFloat4 & b) { return EDFloat4(_mm_mul_ps(a.v, b.v)); }
+inline EDFloat4 operator/(const EDFloat4 & a, const EDFloat4 & b) { return EDFloat4(_mm_div_ps(a.v, b.v)); }
+inline EDFloat4 operator-(const EDFloat4 & a) { return EDFloat4(_mm_sub_ps(_mm_setzero_ps(), a.v)); }
+inline EDFloat4 sqrt(const EDFloat4 & a) { return EDFloat4(_mm_sqrt_ps(a.v)); }
+inline EDFloat4 abs(const EDFloat4 & a) { return EDFloat4(_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)); }
+#else
+#define ED_FLOAT4_LANES(expr) EDFloat4 r; for (int k = 0; k < 4; k++) r.v[k] = (expr); return r
+inline EDFloat4 operator+(const EDFloat4 & a, const EDFloat4 & b) { ED_FLOAT4_LANES(a.v[k] + b.v[k]); }
+inline EDFloat4 operator-(const EDFloat4 & a, const EDFloat4 & b) { ED_FLOAT4_LANES(a.v[k] - b.v[k]); }
+inline EDFloat4 operator*(const EDFloat4 & a, const EDFloat4 & b) { ED_FLOAT4_LANES(a.v[k] * b.v[k]); }
+inline EDFloat4 operator/(const EDFloat4 & a, const EDFloat4 & b) { ED_FLOAT4_LANES(a.v[k] / b.v[k]); }
+inline EDFloat4 operator-(const EDFloat4 & a) { ED_FLOAT4_LANES(-a.v[k]); }
+inline EDFloat4 sqrt(const EDFloat4 & a) { ED_FLOAT4_LANES(std::sqrt(a.v[k])); }
+inline EDFloat4 abs(const EDFloat4 & a) { ED_FLOAT4_LANES(std::abs(a.v[k])); }
+#undef ED_FLOAT4_LANES
+#endif
+
+///
+//  Plain 3-vector over float, double or EDFloat4; used for points as well.
+///
+template <typename T>
+struct EDVec3
+{
+	T x, y, z;
+
+	EDVec3() {}
+	EDVec3(T x, T y, T z) : x(x), y(y), z(z) {}
+};
+
+template <typename T> inline EDVec3<T> operator+(const EDVec3<T> & a, const EDVec3<T> & b) { return EDVec3<T>(a.x + b.x, a.y + b.y, a.z + b.z); }
+template <typename T> inline EDVec3<T> operator-(const EDVec3<T> & a, const EDVec3<T> & b) { return EDVec3<T>(a.x - b.x, a.y - b.y, a.z - b.z); }
+template <typename T> inline EDVec3<T> operator-(const EDVec3<T> & a) { return EDVec3<T>(-a.x, -a.y, -a.z); }
+template <typename T> inline EDVec3<T> operator*(const EDVec3<T> & a, const T & s) { return EDVec3<T>(a.x * s, a.y * s, a.z * s); }
+template <typename T> inline EDVec3<T> operator*(const T & s, const EDVec3<T> & a) { return a * s; }
+template <typename T> inline EDVec3<T> operator/(const EDVec3<T> & a, const T & s) { return EDVec3<T>(a.x / s, a.y / s, a.z / s); }
+
+namespace EDMath
+{
+	// a > bound, in every lane for EDFloat4; false for NaN
+	template <typename T>
+	inline bool all_greater(const T & a, double bound) { return a > bound; }
+
+	inline bool all_greater(const EDFloat4 & a, double bound)
+	{
+#ifdef ED_MATH_SSE2
+		return _mm_movemask_ps(_mm_cmpgt_ps(a.v, _mm_set1_ps(static_cast<float>(bound)))) == 0xF;
+#else
+		for (int k = 0; k < 4; k++)
+		{
+			if (!(a.v[k] > bound)) return false;
+		}
+		return true;
+#endif
+	}
+
+	///
+	//  Dot and cross products of a vector type V, plus its scalar type.
+	//  Specialised here for EDVec3 and in EDMathMaya.h for MVector; points
+	//  only need P - P -> V and P + V * Scalar -> P.
+	///
+	template <typename V>
+	struct VectorOps;
+
+	template <typename T>
+	struct VectorOps<EDVec3<T>>
+	{
+		typedef T Scalar;
+
+		static T dot(const EDVec3<T> & a, const EDVec3<T> & b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+		static EDVec3<T> cross(const EDVec3<T> & a, const EDVec3<T> & b)
+		{
+			return EDVec3<T>(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+		}
+		static EDVec3<T> normalized(const EDVec3<T> & a)
+		{
+			using std::sqrt;
+			return a / sqrt(dot(a, a));
+		}
+	};
+
+	template <typename P, typename V>
+	P project_on_plane(const P & point, const V & plane_normal, const P & ray_origin, const V & unit_direction)
+	{
+		typedef VectorOps<V> Ops;
+		return ray_origin + unit_direction * (Ops::dot(point - ray_origin, plane_normal) / Ops::dot(unit_direction, plane_normal));
+	}
+
+	///
+	//  Normal of the plane through direction d that faces the ray best
+	//  (the minimum-skew viewplane). ray_direction and d should be unit length.
+	///
+	template <typename V>
+	V minimum_skew_viewplane(const V & ray_direction, const V & d)
+	{
+		typedef VectorOps<V> Ops;
+		return Ops::cross(d, Ops::cross(ray_direction, d));
+	}
+
+	// same, through point p seen from camera
+	template <typename P, typename V>
+	V minimum_skew_viewplane(const P & camera, const P & p, const V & d)
+	{
+		return minimum_skew_viewplane(VectorOps<V>::normalized(p - camera), d);
+	}
+
+	///
+	//  Moller-Trumbore against the plane of a triangle; u, v are barycentrics
+	//  and are not range-checked. Returns false only if the ray is parallel
+	//  to the plane.
+	///
+	template <typename P, typename V>
+	bool intersect_triangle(const P & v0, const P & v1, const P & v2, const P & ray_origin, const V & ray_direction,
+		typename VectorOps<V>::Scalar & t, typename VectorOps<V>::Scalar & u, typename VectorOps<V>::Scalar & v)
+	{
+		typedef VectorOps<V> Ops;
+		using std::abs;
+		V e1 = v1 - v0;
+		V e2 = v2 - v0;
+		V p = Ops::cross(ray_direction, e2);
+		auto det = Ops::dot(e1, p);
+		if (!all_greater(abs(det), 1e-12))
+		{
+			return false;
+		}
+
+		auto inv_det = 1 / det;
+		V s = ray_origin - v0;
+		u = Ops::dot(s, p) * inv_det;
+		V q = Ops::cross(s, e1);
+		v = Ops::dot(ray_direction, q) * inv_det;
+		t = Ops::dot(e2, q) * inv_det;
+		return true;
+	}
+
+	///
+	//  World point (x, y, z) to port pixels and NDC depth through a row-vector
+	//  view-projection; false if it is behind the camera.
+	///
+	template <typename T>
+	bool to_port(const double view_projection[4][4], T x, T y, T z, int width, int height, float & px, float & py, float & pz)
+	{
+		auto & m = view_projection;
+		double clip[4];
+		for (int c = 0; c < 4; c++)
+		{
+			clip[c] = x * m[0][c] + y * m[1][c] + z * m[2][c] + m[3][c];
+		}
+		if (clip[3] <= 1e-6)
+		{
+			return false;
+		}
+
+		px = static_cast<float>((clip[0] / clip[3] * 0.5 + 0.5) * width);
+		py = static_cast<float>((clip[1] / clip[3] * 0.5 + 0.5) * height);
+		pz = static_cast<float>(clip[2] / clip[3]);
+		return true;
+	}
+
+	///
+	//  The geometric half of the projection strategies: each picks the point
+	//  a hit stands for, or the plane the stroke is projected onto. Hit tests
+	//  stay with the caller.
+	///
+	template <typename P, typename V>
+	struct Plane
+	{
+		P point;
+		V normal;
+	};
+
+	// a sample h above its hit, back along the ray towards the camera (shell)
+	template <typename P, typename V>
+	P lift(const P & hit, const V & unit_direction, typename VectorOps<V>::Scalar height)
+	{
+		return hit + unit_direction * -height;
+	}
+
+	// holds the surface normal at the first hit and faces the camera as well as it can (normal)
+	template <typename P, typename V>
+	Plane<P, V> normal_plane(const P & first_hit, const V & surface_normal, const V & first_direction)
+	{
+		Plane<P, V> plane = { first_hit, minimum_skew_viewplane(first_direction, surface_normal) };
+		return plane;
+	}
+
+	// through both ends of the stroke; false if they coincide (contour)
+	template <typename P, typename V>
+	bool contour_plane(const P & first, const P & last, const V & first_direction, Plane<P, V> & plane)
+	{
+		typedef VectorOps<V> Ops;
+		V d = last - first;
+		if (!all_greater(Ops::dot(d, d), 1e-20)) return false;
+
+		plane.point = first;
+		plane.normal = minimum_skew_viewplane(first_direction, Ops::normalized(d));
+		return true;
+	}
+
+	// parallel to the surface, h above the middle hit (tangent)
+	template <typename P, typename V>
+	Plane<P, V> tangent_plane(const P & middle_hit, const V & middle_direction, typename VectorOps<V>::Scalar height,
+		const V & surface_normal)
+	{
+		Plane<P, V> plane = { lift(middle_hit, middle_direction, height), surface_normal };
+		return plane;
+	}
+}
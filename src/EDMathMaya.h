@@ -0,0 +1,44 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+// Connects the EDMathCore templates to Maya's vector types.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include "EDMathCore.h"
+
+#include <maya/MPoint.h>
+#include <maya/MVector.h>
+
+namespace EDMath
+{
+	// MPoint - MPoint is an MVector and MPoint + MVector an MPoint, so MPoint needs nothing
+	template <>
+	struct VectorOps<MVector>
+	{
+		typedef double Scalar;
+
+		static double dot(const MVector & a, const MVector & b) { return a * b; }
+		static MVector cross(const MVector & a, const MVector & b) { return a ^ b; }
+		static MVector normalized(const MVector & a) { return a.normal(); }
+	};
+}
@@ -0,0 +1,106 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// Created: Oct 19, 2026
+
+#include "EDMeshAdjacency.h"
+
+#include <cmath>
+#include <unordered_set>
+
+void EDMeshAdjacency::build(const EDMeshSnapshot & snapshot)
+{
+	mesh = &snapshot;
+	revision = snapshot.revision();
+
+	auto vertex_count = snapshot.vertex_count();
+	auto triangle_count = snapshot.triangle_count();
+	auto & tris = snapshot.triangles;
+
+	face_offsets.assign(vertex_count + 1, 0);
+	for (auto v : tris) face_offsets[v + 1]++;
+	for (size_t v = 0; v < vertex_count; v++) face_offsets[v + 1] += face_offsets[v];
+
+	vertex_faces.resize(tris.size());
+	std::vector<int> fill(face_offsets.begin(), face_offsets.end() - 1);
+	for (size_t t = 0; t < triangle_count; t++)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			vertex_faces[fill[tris[t * 3 + k]]++] = static_cast<int>(t);
+		}
+	}
+
+	// interior edges are counted twice, which does not move the mean much
+	double total = 0;
+	for (size_t t = 0; t < triangle_count; t++)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			int a = tris[t * 3 + k];
+			int b = tris[t * 3 + (k + 1) % 3];
+			double dx = snapshot.x[a] - snapshot.x[b], dy = snapshot.y[a] - snapshot.y[b], dz = snapshot.z[a] - snapshot.z[b];
+			total += std::sqrt(dx * dx + dy * dy + dz * dz);
+		}
+	}
+	edge_length = triangle_count ? static_cast<float>(total / (triangle_count * 3)) : 0.0f;
+}
+
+void EDMeshAdjacency::clear()
+{
+	mesh = nullptr;
+	revision = 0;
+	face_offsets.clear();
+	vertex_faces.clear();
+	edge_length = 0;
+}
+
+void EDMeshAdjacency::expand_rings(const std::vector<int> & seeds, int rings, std::vector<int> & vertices, std::vector<int> * ring_of) const
+{
+	vertices.clear();
+	if (ring_of) ring_of->clear();
+	if (empty()) return;
+
+	std::unordered_set<int> seen(seeds.begin(), seeds.end());
+	vertices.assign(seen.begin(), seen.end());
+	if (ring_of) ring_of->assign(vertices.size(), 0);
+	size_t ring_begin = 0;
+	for (int r = 0; r < rings; r++)
+	{
+		auto ring_end = vertices.size();
+		for (auto i = ring_begin; i < ring_end; i++)
+		{
+			auto v = vertices[i];
+			for (auto f = faces_begin(v); f != faces_end(v); ++f)
+			{
+				for (int k = 0; k < 3; k++)
+				{
+					int w = mesh->triangles[*f * 3 + k];
+					if (!seen.insert(w).second) continue;
+					vertices.push_back(w);
+					if (ring_of) ring_of->push_back(r + 1);
+				}
+			}
+		}
+		if (ring_end == vertices.size()) break;
+		ring_begin = ring_end;
+	}
+}
@@ -0,0 +1,64 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// Vertex -> triangle adjacency of the mesh snapshot.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include "EDMeshSnapshot.h"
+
+#include <vector>
+
+///
+//  Compressed (CSR) lists of the triangles around each vertex. Built once
+//  per snapshot revision; ring expansion reads these flat arrays.
+///
+class EDMeshAdjacency
+{
+public:
+	void build(const EDMeshSnapshot & mesh);
+	void clear();
+
+	bool empty() const { return !mesh || face_offsets.empty(); }
+	unsigned mesh_revision() const { return revision; }
+
+	// triangles around vertex v
+	const int * faces_begin(int v) const { return vertex_faces.data() + face_offsets[v]; }
+	const int * faces_end(int v) const { return vertex_faces.data() + face_offsets[v + 1]; }
+
+	// mean length of the triangle edges, to turn distances into ring counts
+	float mean_edge_length() const { return edge_length; }
+
+	///
+	//  Vertices at most "rings" edges away from the seeds, seeds included,
+	//  in breadth-first order. ring_of, if given, gets each one's ring.
+	///
+	void expand_rings(const std::vector<int> & seeds, int rings, std::vector<int> & vertices, std::vector<int> * ring_of = nullptr) const;
+
+private:
+	const EDMeshSnapshot * mesh = nullptr;
+	unsigned revision = 0;
+	std::vector<int> face_offsets;  // vertex count + 1
+	std::vector<int> vertex_faces;
+	float edge_length = 0;
+};
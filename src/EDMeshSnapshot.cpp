@@ -0,0 +1,180 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// Created: Oct 19, 2026
+
+#include "EDMeshSnapshot.h"
+#include "EDParallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	const uint64_t kFnvOffset = 14695981039346656037ULL;
+	const uint64_t kFnvPrime = 1099511628211ULL;
+	// fixed so the hash does not depend on the thread count
+	const size_t kHashChunk = 1 << 16;
+	const size_t kTransformChunk = 1 << 14;
+
+	uint64_t mix(uint64_t h, uint64_t value)
+	{
+		return (h ^ value) * kFnvPrime;
+	}
+}
+
+uint64_t EDMeshSnapshot::hash_words(const uint32_t * words, size_t count, bool parallel)
+{
+	auto chunks = (count + kHashChunk - 1) / kHashChunk;
+	std::vector<uint64_t> chunk_hashes(chunks);
+	EDParallel::for_each_index(chunks, [&](size_t c)
+	{
+		auto begin = c * kHashChunk;
+		auto end = std::min(count, begin + kHashChunk);
+		uint64_t h = kFnvOffset;
+		for (auto i = begin; i < end; i++) h = mix(h, words[i]);
+		chunk_hashes[c] = h;
+	}, parallel);
+
+	uint64_t h = mix(kFnvOffset, count);
+	for (auto c : chunk_hashes) h = mix(h, c);
+	return h;
+}
+
+bool EDMeshSnapshot::update(const float * raw_points, size_t vertex_count, const double world_matrix[4][4], uint64_t topology_key, bool parallel)
+{
+	static_assert(sizeof(float) == sizeof(uint32_t), "points are hashed as 32-bit words");
+	uint32_t matrix_words[32];
+	std::memcpy(matrix_words, world_matrix, sizeof(matrix_words));
+
+	auto h = hash_words(reinterpret_cast<const uint32_t *>(raw_points), vertex_count * 3, parallel);
+	h = mix(h, hash_words(matrix_words, 32, false));
+	h = mix(h, topology_key);
+
+	topology_dirty = topology_key != topology || triangles.empty();
+	if (!empty() && h == content_hash && !topology_dirty)
+	{
+		return false;
+	}
+
+	content_hash = h;
+	topology = topology_key;
+	rev++;
+
+	x.resize(vertex_count);
+	y.resize(vertex_count);
+	z.resize(vertex_count);
+	const double (*m)[4] = world_matrix;
+	auto chunks = (vertex_count + kTransformChunk - 1) / kTransformChunk;
+	EDParallel::for_each_index(chunks, [&](size_t c)
+	{
+		auto begin = c * kTransformChunk;
+		auto end = std::min(vertex_count, begin + kTransformChunk);
+		for (auto i = begin; i < end; i++)
+		{
+			// row vectors, as MPoint * MMatrix
+			double px = raw_points[i * 3], py = raw_points[i * 3 + 1], pz = raw_points[i * 3 + 2];
+			x[i] = static_cast<float>(px * m[0][0] + py * m[1][0] + pz * m[2][0] + m[3][0]);
+			y[i] = static_cast<float>(px * m[0][1] + py * m[1][1] + pz * m[2][1] + m[3][1]);
+			z[i] = static_cast<float>(px * m[0][2] + py * m[1][2] + pz * m[2][2] + m[3][2]);
+		}
+	}, parallel);
+	return true;
+}
+
+void EDMeshSnapshot::set_triangles(std::vector<int> && indices)
+{
+	triangles = std::move(indices);
+	topology_dirty = false;
+}
+
+void EDMeshSnapshot::clear()
+{
+	if (!empty()) rev++;
+	x.clear();
+	y.clear();
+	z.clear();
+	triangles.clear();
+	face_normals.clear();
+	vertex_normals.clear();
+	content_hash = 0;
+	topology = 0;
+	topology_dirty = false;
+}
+
+void EDMeshSnapshot::build_normals(bool parallel)
+{
+	auto tri_count = triangle_count();
+	auto vert_count = vertex_count();
+	// cross products are twice the triangle area, which is the weight we want
+	std::vector<float> weighted(tri_count * 3);
+	face_normals.resize(tri_count * 3);
+	vertex_normals.assign(vert_count * 3, 0.0f);
+
+	auto normalize = [](const float * in, float * out)
+	{
+		auto length = std::sqrt(in[0] * in[0] + in[1] * in[1] + in[2] * in[2]);
+		auto inv = length > 0 ? 1.0f / length : 0.0f;
+		out[0] = in[0] * inv;
+		out[1] = in[1] * inv;
+		out[2] = in[2] * inv;
+	};
+
+	auto face_chunks = (tri_count + kTransformChunk - 1) / kTransformChunk;
+	EDParallel::for_each_index(face_chunks, [&](size_t c)
+	{
+		auto end = std::min(tri_count, (c + 1) * kTransformChunk);
+		for (auto t = c * kTransformChunk; t < end; t++)
+		{
+			int a = triangles[t * 3], b = triangles[t * 3 + 1], d = triangles[t * 3 + 2];
+			float e1[] = { x[b] - x[a], y[b] - y[a], z[b] - z[a] };
+			float e2[] = { x[d] - x[a], y[d] - y[a], z[d] - z[a] };
+			float * n = &weighted[t * 3];
+			n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+			n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+			n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+			normalize(n, &face_normals[t * 3]);
+		}
+	}, parallel);
+
+	// scattering to shared vertices stays serial
+	for (size_t t = 0; t < tri_count; t++)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			float * v = &vertex_normals[triangles[t * 3 + k] * 3];
+			v[0] += weighted[t * 3];
+			v[1] += weighted[t * 3 + 1];
+			v[2] += weighted[t * 3 + 2];
+		}
+	}
+
+	auto vertex_chunks = (vert_count + kTransformChunk - 1) / kTransformChunk;
+	EDParallel::for_each_index(vertex_chunks, [&](size_t c)
+	{
+		auto end = std::min(vert_count, (c + 1) * kTransformChunk);
+		for (auto i = c * kTransformChunk; i < end; i++)
+		{
+			normalize(&vertex_normals[i * 3], &vertex_normals[i * 3]);
+		}
+	}, parallel);
+}
@@ -0,0 +1,74 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// Compact world-space copy of the selected mesh, shared by every query structure.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+///
+//  Positions as one float array per axis plus the triangle index buffer.
+//  Built straight from the mesh's raw object-space floats; a content hash of
+//  those floats, the world matrix and a topology key tells whether anything
+//  changed, so unchanged meshes are not copied or transformed again.
+//
+//  Everything built from the mesh (raster, kd-trees, normals, adjacency)
+//  reads these arrays and compares revision() to know when to rebuild.
+///
+class EDMeshSnapshot
+{
+public:
+	// returns true if the mesh changed since the last update
+	bool update(const float * raw_points, size_t vertex_count, const double world_matrix[4][4], uint64_t topology_key, bool parallel = true);
+	// after update(), whether the triangles must be set again
+	bool topology_changed() const { return topology_dirty; }
+	void set_triangles(std::vector<int> && indices);
+	// face normals and area-weighted vertex normals, once positions and triangles are set
+	void build_normals(bool parallel = true);
+	void clear();
+
+	bool empty() const { return x.empty(); }
+	size_t vertex_count() const { return x.size(); }
+	size_t triangle_count() const { return triangles.size() / 3; }
+	unsigned revision() const { return rev; }
+	uint64_t hash() const { return content_hash; }
+
+	// world space
+	std::vector<float> x, y, z;
+	// 3 vertex indices per triangle
+	std::vector<int> triangles;
+	// unit length, xyz interleaved
+	std::vector<float> face_normals;
+	std::vector<float> vertex_normals;
+
+	static uint64_t hash_words(const uint32_t * words, size_t count, bool parallel = true);
+
+private:
+	uint64_t content_hash = 0;
+	uint64_t topology = 0;
+	bool topology_dirty = false;
+	unsigned rev = 0;
+};
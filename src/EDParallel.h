@@ -0,0 +1,64 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// Splitting index ranges over worker threads.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace EDParallel
+{
+	///
+	//  Calls fn(i) for every i in [0, count), spread over the hardware
+	//  threads. Indices are handed out one at a time, so uneven work balances
+	//  itself; the calling thread works too.
+	///
+	template <typename F>
+	void for_each_index(size_t count, const F & fn, bool parallel = true)
+	{
+		size_t threads = parallel ? std::min<size_t>(count, std::thread::hardware_concurrency()) : 1;
+		if (threads <= 1)
+		{
+			for (size_t i = 0; i < count; i++) fn(i);
+			return;
+		}
+
+		std::atomic<size_t> next(0);
+		auto work = [&]()
+		{
+			for (size_t i = next++; i < count; i = next++) fn(i);
+		};
+		std::vector<std::thread> workers;
+		for (size_t t = 1; t < threads; t++)
+		{
+			workers.push_back(std::thread(work));
+		}
+		work();
+		for (auto & w : workers) w.join();
+	}
+}
@@ -0,0 +1,99 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+// Index-addressed arena with reference counts.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+///
+//  Objects live in one contiguous vector and are addressed by index.
+//  Freed slots are reused; an index stays valid while its count is above 0.
+///
+template <typename T>
+class EDPool
+{
+public:
+	static const size_t kNone = static_cast<size_t>(-1);
+
+	size_t create(const T & value)
+	{
+		size_t index;
+		if (!free_slots.empty())
+		{
+			index = free_slots.back();
+			free_slots.pop_back();
+			items[index] = value;
+			ref_counts[index] = 0;
+		}
+		else
+		{
+			index = items.size();
+			items.push_back(value);
+			ref_counts.push_back(0);
+		}
+		live++;
+		return index;
+	}
+
+	void retain(size_t index) { ref_counts[index]++; }
+
+	// returns true if the object was freed
+	bool release(size_t index)
+	{
+		if (ref_counts[index] > 0 && --ref_counts[index] > 0) return false;
+		destroy(index);
+		return true;
+	}
+
+	void destroy(size_t index)
+	{
+		if (ref_counts[index] < 0) return;
+		ref_counts[index] = -1;
+		free_slots.push_back(index);
+		live--;
+	}
+
+	void clear()
+	{
+		items.clear();
+		ref_counts.clear();
+		free_slots.clear();
+		live = 0;
+	}
+
+	bool alive(size_t index) const { return index < items.size() && ref_counts[index] >= 0; }
+	size_t slot_count() const { return items.size(); }
+	size_t size() const { return live; }
+
+	T & operator[](size_t index) { return items[index]; }
+	const T & operator[](size_t index) const { return items[index]; }
+
+private:
+	std::vector<T> items;
+	// -1 marks a free slot
+	std::vector<int> ref_counts;
+	std::vector<size_t> free_slots;
+	size_t live = 0;
+};
@@ -0,0 +1,56 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+// What a stroke projection learned about its curve.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include "EDMathCore.h"
+
+#include <vector>
+
+///
+//  Kept with each curve so that part of it can be re-projected later
+//  without casting its rays again: per-sample heights above the body for
+//  shell strokes, or the plane the stroke was projected on.
+///
+struct EDProjectionData
+{
+	std::vector<float> heights;
+
+	bool has_plane = false;
+	EDVec3<double> plane_point;
+	EDVec3<double> plane_normal;
+
+	void clear()
+	{
+		heights.clear();
+		has_plane = false;
+	}
+
+	void set_plane(const EDVec3<double> & point, const EDVec3<double> & normal)
+	{
+		has_plane = true;
+		plane_point = point;
+		plane_normal = normal;
+	}
+};
@@ -0,0 +1,303 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// Created: Oct 19, 2026
+
+#include "EDRasterizer.h"
+#include "EDParallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ED_RASTER_SSE2
+#include <emmintrin.h>
+#endif
+
+const int EDRasterizer::kNoTriangle;
+const float EDRasterizer::kFar = std::numeric_limits<float>::max();
+
+namespace
+{
+	// w(x, y) = a * x + b * y + c, positive inside for counter-clockwise triangles
+	struct EdgeFunction
+	{
+		float a, b, c;
+
+		void setup(const EDRasterizer::Vertex & p, const EDRasterizer::Vertex & q)
+		{
+			a = p.y - q.y;
+			b = q.x - p.x;
+			c = -(a * p.x + b * p.y);
+		}
+
+		float at(float x, float y) const { return a * x + b * y + c; }
+	};
+
+	// signed distance to the near plane z = -w, positive in front of it
+	float near_distance(const EDRasterizer::ClipVertex & v)
+	{
+		return v.z + v.w;
+	}
+
+	EDRasterizer::ClipVertex lerp(const EDRasterizer::ClipVertex & a, const EDRasterizer::ClipVertex & b, float t)
+	{
+		EDRasterizer::ClipVertex v = { a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t, a.w + (b.w - a.w) * t };
+		return v;
+	}
+
+	// to pixels, clamped in float so far-off coordinates stay in int range
+	int to_pixel(float v, int lo, int hi)
+	{
+		return static_cast<int>(std::floor(std::max(static_cast<float>(lo), std::min(v, static_cast<float>(hi)))));
+	}
+}
+
+void EDRasterizer::resize(int width, int height)
+{
+	w = std::max(width, 0);
+	h = std::max(height, 0);
+	stride = (static_cast<size_t>(w) + 3) & ~static_cast<size_t>(3);
+	tiles_x = (w + kTileSize - 1) / kTileSize;
+	tiles_y = (h + kTileSize - 1) / kTileSize;
+
+	depth.resize(stride * h);
+	ids.resize(stride * h);
+	tile_bins.resize(static_cast<size_t>(tiles_x) * tiles_y);
+	clear();
+}
+
+void EDRasterizer::clear()
+{
+	std::fill(depth.begin(), depth.end(), kFar);
+	std::fill(ids.begin(), ids.end(), kNoTriangle);
+	for (auto & b : tile_bins) b.clear();
+}
+
+void EDRasterizer::rasterize(const std::vector<Vertex> & vertices, const std::vector<int> & indices, bool parallel)
+{
+	draw(vertices, indices, nullptr, parallel);
+}
+
+void EDRasterizer::rasterize(const std::vector<ClipVertex> & vertices, const std::vector<int> & indices, bool parallel)
+{
+	clipped_vertices.clear();
+	clipped_indices.clear();
+	clipped_ids.clear();
+
+	auto emit = [&](const ClipVertex & v)
+	{
+		Vertex s;
+		s.x = (v.x / v.w * 0.5f + 0.5f) * w;
+		s.y = (v.y / v.w * 0.5f + 0.5f) * h;
+		s.z = v.z / v.w;
+		clipped_vertices.push_back(s);
+		clipped_indices.push_back(static_cast<int>(clipped_vertices.size() - 1));
+	};
+
+	auto triangle_count = indices.size() / 3;
+	for (size_t t = 0; t < triangle_count; t++)
+	{
+		const ClipVertex * corners[] = { &vertices[indices[t * 3]], &vertices[indices[t * 3 + 1]], &vertices[indices[t * 3 + 2]] };
+
+		// Sutherland-Hodgman against the one plane: 3 corners in, at most 4 out
+		ClipVertex polygon[4];
+		int count = 0;
+		for (int k = 0; k < 3; k++)
+		{
+			auto & a = *corners[k];
+			auto & b = *corners[(k + 1) % 3];
+			float da = near_distance(a);
+			float db = near_distance(b);
+			if (da >= 0) polygon[count++] = a;
+			if ((da >= 0) != (db >= 0)) polygon[count++] = lerp(a, b, da / (da - db));
+		}
+		if (count < 3) continue;
+
+		// the plane cuts w = 0 off for perspective views, but not for a degenerate matrix
+		bool finite = true;
+		for (int k = 0; k < count; k++) finite = finite && polygon[k].w > 0;
+		if (!finite) continue;
+
+		// a fan of one or two triangles
+		for (int k = 1; k + 1 < count; k++)
+		{
+			emit(polygon[0]);
+			emit(polygon[k]);
+			emit(polygon[k + 1]);
+			clipped_ids.push_back(static_cast<int>(t));
+		}
+	}
+
+	draw(clipped_vertices, clipped_indices, clipped_ids.data(), parallel);
+}
+
+void EDRasterizer::draw(const std::vector<Vertex> & vertices, const std::vector<int> & indices, const int * source_ids, bool parallel)
+{
+	clear();
+	if (w == 0 || h == 0) return;
+
+	bin(vertices, indices);
+
+	EDParallel::for_each_index(tile_bins.size(), [&](size_t t)
+	{
+		fill_tile(t, vertices, indices, source_ids);
+	}, parallel);
+}
+
+void EDRasterizer::bin(const std::vector<Vertex> & vertices, const std::vector<int> & indices)
+{
+	auto triangle_count = indices.size() / 3;
+	for (size_t t = 0; t < triangle_count; t++)
+	{
+		auto & v0 = vertices[indices[t * 3]];
+		auto & v1 = vertices[indices[t * 3 + 1]];
+		auto & v2 = vertices[indices[t * 3 + 2]];
+
+		// also drops NaN positions
+		auto area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+		if (!(std::fabs(area) > 0)) continue;
+
+		auto min_x = std::min(v0.x, std::min(v1.x, v2.x));
+		auto max_x = std::max(v0.x, std::max(v1.x, v2.x));
+		auto min_y = std::min(v0.y, std::min(v1.y, v2.y));
+		auto max_y = std::max(v0.y, std::max(v1.y, v2.y));
+		if (max_x < 0 || max_y < 0 || min_x >= w || min_y >= h) continue;
+
+		int tx0 = to_pixel(min_x, 0, w - 1) / kTileSize;
+		int ty0 = to_pixel(min_y, 0, h - 1) / kTileSize;
+		int tx1 = to_pixel(max_x, 0, w - 1) / kTileSize;
+		int ty1 = to_pixel(max_y, 0, h - 1) / kTileSize;
+		for (int ty = ty0; ty <= ty1; ty++)
+		{
+			for (int tx = tx0; tx <= tx1; tx++)
+			{
+				tile_bins[ty * tiles_x + tx].push_back(static_cast<int>(t));
+			}
+		}
+	}
+}
+
+void EDRasterizer::fill_tile(size_t tile, const std::vector<Vertex> & vertices, const std::vector<int> & indices, const int * source_ids)
+{
+	auto & triangles = tile_bins[tile];
+	if (triangles.empty()) return;
+
+	int tile_x0 = static_cast<int>(tile % tiles_x) * kTileSize;
+	int tile_y0 = static_cast<int>(tile / tiles_x) * kTileSize;
+	int tile_x1 = std::min(tile_x0 + kTileSize, w) - 1;
+	int tile_y1 = std::min(tile_y0 + kTileSize, h) - 1;
+
+	for (auto t : triangles)
+	{
+		auto v0 = vertices[indices[t * 3]];
+		auto v1 = vertices[indices[t * 3 + 1]];
+		auto v2 = vertices[indices[t * 3 + 2]];
+
+		// both facings are drawn, as a ray cast would hit either
+		auto area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+		if (area < 0)
+		{
+			std::swap(v1, v2);
+			area = -area;
+		}
+
+		EdgeFunction e0, e1, e2;
+		e0.setup(v1, v2);
+		e1.setup(v2, v0);
+		e2.setup(v0, v1);
+
+		// depth is affine in screen space
+		float inv_area = 1.0f / area;
+		float zx = (e0.a * v0.z + e1.a * v1.z + e2.a * v2.z) * inv_area;
+		float zy = (e0.b * v0.z + e1.b * v1.z + e2.b * v2.z) * inv_area;
+		float zc = (e0.c * v0.z + e1.c * v1.z + e2.c * v2.z) * inv_area;
+
+		int x0 = to_pixel(std::min(v0.x, std::min(v1.x, v2.x)), tile_x0, tile_x1 + 1);
+		int x1 = to_pixel(std::max(v0.x, std::max(v1.x, v2.x)), tile_x0 - 1, tile_x1);
+		int y0 = to_pixel(std::min(v0.y, std::min(v1.y, v2.y)), tile_y0, tile_y1 + 1);
+		int y1 = to_pixel(std::max(v0.y, std::max(v1.y, v2.y)), tile_y0 - 1, tile_y1);
+		if (x0 > x1 || y0 > y1) continue;
+		int id_value = source_ids ? source_ids[t] : t;
+
+#ifdef ED_RASTER_SSE2
+		// groups of 4 never cross a tile, tiles start on multiples of 4
+		x0 &= ~3;
+		const __m128 lane = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128i id = _mm_set1_epi32(id_value);
+		const __m128 step0 = _mm_set1_ps(e0.a * 4), step1 = _mm_set1_ps(e1.a * 4), step2 = _mm_set1_ps(e2.a * 4);
+		const __m128 zstep = _mm_set1_ps(zx * 4);
+
+		for (int y = y0; y <= y1; y++)
+		{
+			float py = y + 0.5f;
+			__m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x0)), lane);
+			__m128 w0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(e0.a), px), _mm_set1_ps(e0.b * py + e0.c));
+			__m128 w1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(e1.a), px), _mm_set1_ps(e1.b * py + e1.c));
+			__m128 w2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(e2.a), px), _mm_set1_ps(e2.b * py + e2.c));
+			__m128 z = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(zx), px), _mm_set1_ps(zy * py + zc));
+
+			float * depth_row = &depth[y * stride];
+			int * id_row = &ids[y * stride];
+			for (int x = x0; x <= x1; x += 4)
+			{
+				__m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(w0, zero), _mm_cmpge_ps(w1, zero)), _mm_cmpge_ps(w2, zero));
+				if (_mm_movemask_ps(inside))
+				{
+					__m128 old_z = _mm_loadu_ps(depth_row + x);
+					__m128 pass = _mm_and_ps(inside, _mm_cmplt_ps(z, old_z));
+					_mm_storeu_ps(depth_row + x, _mm_or_ps(_mm_and_ps(pass, z), _mm_andnot_ps(pass, old_z)));
+
+					__m128i pass_i = _mm_castps_si128(pass);
+					__m128i old_id = _mm_loadu_si128(reinterpret_cast<const __m128i *>(id_row + x));
+					_mm_storeu_si128(reinterpret_cast<__m128i *>(id_row + x),
+						_mm_or_si128(_mm_and_si128(pass_i, id), _mm_andnot_si128(pass_i, old_id)));
+				}
+				w0 = _mm_add_ps(w0, step0);
+				w1 = _mm_add_ps(w1, step1);
+				w2 = _mm_add_ps(w2, step2);
+				z = _mm_add_ps(z, zstep);
+			}
+		}
+#else
+		for (int y = y0; y <= y1; y++)
+		{
+			float py = y + 0.5f;
+			float * depth_row = &depth[y * stride];
+			int * id_row = &ids[y * stride];
+			for (int x = x0; x <= x1; x++)
+			{
+				float px = x + 0.5f;
+				if (e0.at(px, py) < 0 || e1.at(px, py) < 0 || e2.at(px, py) < 0) continue;
+
+				float z = zx * px + zy * py + zc;
+				if (z < depth_row[x])
+				{
+					depth_row[x] = z;
+					id_row[x] = id_value;
+				}
+			}
+		}
+#endif
+	}
+}
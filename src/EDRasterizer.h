@@ -0,0 +1,104 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// CPU depth and triangle-ID buffers.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+///
+//  Rasterizes screen-space triangles into a depth buffer and a triangle-ID
+//  buffer, so that "which triangle is under this pixel" is one read.
+//
+//  The screen is cut into tiles; each tile only sees the triangles whose
+//  bounds touch it, and tiles are filled in parallel. Inner loops do four
+//  pixels at a time with SSE2 where available.
+///
+class EDRasterizer
+{
+public:
+	struct Vertex
+	{
+		float x, y; // pixels, (0, 0) is the bottom-left corner of the port
+		float z;    // depth, smaller is nearer
+	};
+
+	// homogeneous clip space, as a row-vector view-projection gives it
+	struct ClipVertex
+	{
+		float x, y, z, w;
+	};
+
+	static const int kNoTriangle = -1;
+
+	void resize(int width, int height);
+	void clear();
+
+	// triangles are index triples into vertices; triangle i gets id i
+	void rasterize(const std::vector<Vertex> & vertices, const std::vector<int> & indices, bool parallel = true);
+
+	///
+	//  Same from clip space. Triangles are clipped against the near plane
+	//  (z = -w) first, so ones reaching behind the camera keep the part in
+	//  front of it; the pieces keep the id of the triangle they came from.
+	///
+	void rasterize(const std::vector<ClipVertex> & vertices, const std::vector<int> & indices, bool parallel = true);
+
+	int width() const { return w; }
+	int height() const { return h; }
+	bool inside(int x, int y) const { return x >= 0 && y >= 0 && x < w && y < h; }
+
+	int triangle_at(int x, int y) const { return inside(x, y) ? ids[y * stride + x] : kNoTriangle; }
+	float depth_at(int x, int y) const { return inside(x, y) ? depth[y * stride + x] : kFar; }
+
+	// rows are padded to a multiple of 4 pixels
+	size_t row_stride() const { return stride; }
+	const std::vector<int> & triangle_ids() const { return ids; }
+
+private:
+	static const int kTileSize = 64;
+	static const float kFar;
+
+	// source_ids maps a triangle to the id written for it; nullptr means its own index
+	void draw(const std::vector<Vertex> & vertices, const std::vector<int> & indices, const int * source_ids, bool parallel);
+	void bin(const std::vector<Vertex> & vertices, const std::vector<int> & indices);
+	void fill_tile(size_t tile, const std::vector<Vertex> & vertices, const std::vector<int> & indices, const int * source_ids);
+
+	int w = 0;
+	int h = 0;
+	size_t stride = 0;
+	int tiles_x = 0;
+	int tiles_y = 0;
+
+	std::vector<float> depth;
+	std::vector<int> ids;
+	// triangles touching each tile
+	std::vector<std::vector<int>> tile_bins;
+
+	// near-clipped triangles of the clip-space path, kept to reuse their storage
+	std::vector<Vertex> clipped_vertices;
+	std::vector<int> clipped_indices;
+	std::vector<int> clipped_ids;
+};
@@ -0,0 +1,125 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// Created: Oct 19, 2026
+
+#include "EDRays.h"
+#include "EDKernels.h"
+
+void EDRayBatch::resize(size_t count)
+{
+	ox.resize(count);
+	oy.resize(count);
+	oz.resize(count);
+	dx.resize(count);
+	dy.resize(count);
+	dz.resize(count);
+}
+
+void EDRayBatch::generate(const double inverse_view_projection[4][4], int width, int height,
+	const float * px, const float * py, size_t count)
+{
+	resize(count);
+	if (count == 0 || width <= 0 || height <= 0) return;
+
+	float m[4][4];
+	for (int r = 0; r < 4; r++)
+	{
+		for (int c = 0; c < 4; c++) m[r][c] = static_cast<float>(inverse_view_projection[r][c]);
+	}
+	EDKernels::get().unproject(m, 2.0f / width, 2.0f / height, px, py, 0, count, *this);
+}
+
+void EDRays::project_on_plane(const EDRayBatch & rays, size_t begin, size_t end, const EDPlane & plane,
+	float * x, float * y, float * z)
+{
+	EDKernels::get().project_on_plane(rays, begin, end, plane, x, y, z);
+}
+
+void EDRays::project_on_planes(const EDRayBatch & rays, const size_t * begins, const size_t * ends, const EDPlane * planes, size_t plane_count,
+	float * x, float * y, float * z)
+{
+	auto & kernels = EDKernels::get();
+	for (size_t k = 0; k < plane_count; k++)
+	{
+		kernels.project_on_plane(rays, begins[k], ends[k], planes[k], x, y, z);
+	}
+}
+
+void EDRays::minimum_skew_viewplanes(size_t count, const float * rx, const float * ry, const float * rz,
+	const float * dx, const float * dy, const float * dz, float * nx, float * ny, float * nz)
+{
+	EDKernels::get().minimum_skew_viewplanes(count, rx, ry, rz, dx, dy, dz, nx, ny, nz);
+}
+
+void EDRays::project_misses(const EDRayBatch & rays, const std::vector<bool> & hit_list, float * x, float * y, float * z)
+{
+	auto length = hit_list.size();
+	std::vector<size_t> begins, ends;
+	for (size_t i = 1; i + 1 < length; i++)
+	{
+		if (hit_list[i]) continue;
+
+		size_t next = i;
+		while (next + 1 < length && !hit_list[next]) next++;
+		begins.push_back(i);
+		ends.push_back(next);
+		i = next;
+	}
+	if (begins.empty()) return;
+
+	// every plane is fixed before any miss is written
+	auto runs = begins.size();
+	std::vector<float> r(runs * 3), d(runs * 3), n(runs * 3);
+	for (size_t k = 0; k < runs; k++)
+	{
+		auto before = begins[k] - 1;
+		auto after = ends[k];
+		r[k] = rays.dx[before];
+		r[runs + k] = rays.dy[before];
+		r[runs * 2 + k] = rays.dz[before];
+		d[k] = x[after] - x[before];
+		d[runs + k] = y[after] - y[before];
+		d[runs * 2 + k] = z[after] - z[before];
+	}
+	minimum_skew_viewplanes(runs, &r[0], &r[runs], &r[runs * 2], &d[0], &d[runs], &d[runs * 2],
+		&n[0], &n[runs], &n[runs * 2]);
+
+	std::vector<EDPlane> planes(runs);
+	for (size_t k = 0; k < runs; k++)
+	{
+		auto before = begins[k] - 1;
+		EDPlane plane = { { x[before], y[before], z[before] }, { n[k], n[runs + k], n[runs * 2 + k] } };
+		planes[k] = plane;
+	}
+	project_on_planes(rays, &begins[0], &ends[0], &planes[0], runs, x, y, z);
+}
+
+void EDRays::to_port(const double view_projection[4][4], int width, int height,
+	const float * x, const float * y, const float * z, size_t count, float * px, float * py, float * pz)
+{
+	float m[4][4];
+	for (int r = 0; r < 4; r++)
+	{
+		for (int c = 0; c < 4; c++) m[r][c] = static_cast<float>(view_projection[r][c]);
+	}
+	EDKernels::get().to_port(m, static_cast<float>(width), static_cast<float>(height), x, y, z, count, px, py, pz);
+}
@@ -0,0 +1,92 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// Camera rays of a whole stroke, generated in one pass.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+///
+//  One float array per component. Rays are unprojected from the inverse
+//  view-projection captured once per stroke instead of one viewToWorld call
+//  per sample; like viewToWorld, origins lie on the near plane and
+//  directions are unit length.
+///
+struct EDRayBatch
+{
+	std::vector<float> ox, oy, oz;
+	std::vector<float> dx, dy, dz;
+
+	size_t size() const { return ox.size(); }
+	bool empty() const { return ox.empty(); }
+	void resize(size_t count);
+
+	///
+	//  Rays through port pixels (px[i], py[i]), origin at the bottom left.
+	//  inverse_view_projection takes clip space back to world space, with
+	//  row vectors as in Maya.
+	///
+	void generate(const double inverse_view_projection[4][4], int width, int height,
+		const float * px, const float * py, size_t count);
+};
+
+struct EDPlane
+{
+	double point[3];
+	double normal[3];
+};
+
+///
+//  Batch versions of EDMath::projectOnPlane, minimumSkewViewplane and
+//  toPort over SoA arrays, run by the kernels EDKernels picked for this CPU.
+//  The SIMD paths work in floats and agree with the double-precision scalar
+//  path to about 1e-6 of the distance along the ray; tests/test_rays.cpp
+//  holds every table the CPU can run to 1e-5 of a double reference.
+///
+namespace EDRays
+{
+	// where rays [begin, end) meet the plane, written at the same indices
+	void project_on_plane(const EDRayBatch & rays, size_t begin, size_t end, const EDPlane & plane,
+		float * x, float * y, float * z);
+
+	// rays [begins[k], ends[k]) meet planes[k]
+	void project_on_planes(const EDRayBatch & rays, const size_t * begins, const size_t * ends, const EDPlane * planes, size_t plane_count,
+		float * x, float * y, float * z);
+
+	// normals d x (r x d) of the planes through d that face the rays r best
+	void minimum_skew_viewplanes(size_t count, const float * rx, const float * ry, const float * rz,
+		const float * dx, const float * dy, const float * dz, float * nx, float * ny, float * nz);
+
+	///
+	//  Runs of rays that missed, between the two ends, go on the minimum-skew
+	//  plane through the points on either side of the run. The points are
+	//  indexed like the rays; only the misses are written.
+	///
+	void project_misses(const EDRayBatch & rays, const std::vector<bool> & hit_list, float * x, float * y, float * z);
+
+	// world points to port pixels and depth as EDMath::toPort; points behind the camera get NaN
+	void to_port(const double view_projection[4][4], int width, int height,
+		const float * x, const float * y, const float * z, size_t count, float * px, float * py, float * pz);
+}
@@ -0,0 +1,498 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// Created: Oct 19, 2026
+
+#include "EDSceneBvh.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// inverse of an affine row-vector matrix
+	void invert_affine(const double m[4][4], double out[4][4])
+	{
+		double a = m[0][0], b = m[0][1], c = m[0][2];
+		double d = m[1][0], e = m[1][1], f = m[1][2];
+		double g = m[2][0], h = m[2][1], i = m[2][2];
+		double det = a * (e * i - f * h) - b * (d * i - f * g) + c * (d * h - e * g);
+		double s = std::abs(det) > 1e-300 ? 1 / det : 0;
+
+		out[0][0] = (e * i - f * h) * s;
+		out[0][1] = (c * h - b * i) * s;
+		out[0][2] = (b * f - c * e) * s;
+		out[1][0] = (f * g - d * i) * s;
+		out[1][1] = (a * i - c * g) * s;
+		out[1][2] = (c * d - a * f) * s;
+		out[2][0] = (d * h - e * g) * s;
+		out[2][1] = (b * g - a * h) * s;
+		out[2][2] = (a * e - b * d) * s;
+		for (int k = 0; k < 3; k++)
+		{
+			out[3][k] = -(m[3][0] * out[0][k] + m[3][1] * out[1][k] + m[3][2] * out[2][k]);
+			out[k][3] = 0;
+		}
+		out[3][3] = 1;
+	}
+
+	inline void transform(const double m[4][4], const float p[3], double w, float out[3])
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			out[k] = static_cast<float>(p[0] * m[0][k] + p[1] * m[1][k] + p[2] * m[2][k] + w * m[3][k]);
+		}
+	}
+
+	inline float enter_box(const float lo[3], const float hi[3], const float origin[3], const float direction[3], float t_max)
+	{
+		float t0 = 0, t1 = t_max;
+		for (int a = 0; a < 3; a++)
+		{
+			float inv = direction[a] != 0 ? 1.0f / direction[a] : std::numeric_limits<float>::max();
+			float near_t = (lo[a] - origin[a]) * inv;
+			float far_t = (hi[a] - origin[a]) * inv;
+			if (near_t > far_t) std::swap(near_t, far_t);
+			if (near_t > t0) t0 = near_t;
+			if (far_t < t1) t1 = far_t;
+			if (t0 > t1) return -1;
+		}
+		return t0;
+	}
+}
+
+namespace
+{
+	float area(const float lo[3], const float hi[3])
+	{
+		float d[] = { hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2] };
+		return d[0] * d[1] + d[1] * d[2] + d[2] * d[0];
+	}
+
+	float union_area(const float lo_a[3], const float hi_a[3], const float lo_b[3], const float hi_b[3])
+	{
+		float lo[3], hi[3];
+		for (int a = 0; a < 3; a++)
+		{
+			lo[a] = std::min(lo_a[a], lo_b[a]);
+			hi[a] = std::max(hi_a[a], hi_b[a]);
+		}
+		return area(lo, hi);
+	}
+}
+
+void EDSceneBvh::clear()
+{
+	instances.clear();
+	free_instances.clear();
+	live = 0;
+	nodes.clear();
+	free_nodes.clear();
+	root = -1;
+}
+
+int EDSceneBvh::find(const std::string & key) const
+{
+	for (size_t i = 0; i < instances.size(); i++)
+	{
+		if (instances[i] && instances[i]->key == key) return static_cast<int>(i);
+	}
+	return -1;
+}
+
+int EDSceneBvh::add_instance(const std::string & key)
+{
+	int index;
+	if (!free_instances.empty())
+	{
+		index = free_instances.back();
+		free_instances.pop_back();
+	}
+	else
+	{
+		index = static_cast<int>(instances.size());
+		instances.push_back(nullptr);
+	}
+	instances[index].reset(new Instance);
+	auto & instance = *instances[index];
+	instance.key = key;
+	instance.hash = 0;
+	instance.touched = false;
+	instance.pinned = false;
+	instance.leaf = -1;
+	// never equal to a real matrix, so the first update counts as a move
+	std::fill(&instance.to_world[0][0], &instance.to_world[0][0] + 16, std::numeric_limits<double>::quiet_NaN());
+	live++;
+	return index;
+}
+
+void EDSceneBvh::drop_instance(int instance)
+{
+	remove_leaf(instance);
+	instances[instance].reset();
+	free_instances.push_back(instance);
+	live--;
+}
+
+void EDSceneBvh::begin_update()
+{
+	for (auto & instance : instances)
+	{
+		if (instance) instance->touched = false;
+	}
+}
+
+bool EDSceneBvh::update_instance(const std::string & key, uint64_t geometry_hash, const double world_matrix[4][4])
+{
+	auto index = find(key);
+	bool rebuild = false;
+	if (index < 0)
+	{
+		index = add_instance(key);
+		rebuild = true;
+	}
+	auto & instance = *instances[index];
+	if (instance.hash != geometry_hash || instance.blas.empty())
+	{
+		rebuild = true;
+	}
+
+	bool moved = !std::equal(&world_matrix[0][0], &world_matrix[0][0] + 16, &instance.to_world[0][0]);
+	instance.hash = geometry_hash;
+	instance.touched = true;
+	if (moved)
+	{
+		std::copy(&world_matrix[0][0], &world_matrix[0][0] + 16, &instance.to_world[0][0]);
+		invert_affine(instance.to_world, instance.to_object);
+	}
+
+	if (rebuild)
+	{
+		// back in the tree once set_geometry() gives it a bottom level
+		remove_leaf(index);
+		instance.blas.clear();
+	}
+	else if (moved)
+	{
+		remove_leaf(index);
+		world_bounds(instance);
+		insert_leaf(index);
+	}
+	return rebuild;
+}
+
+void EDSceneBvh::set_geometry(const std::string & key, const float * points, size_t vertex_count, const std::vector<int> & triangles)
+{
+	auto index = find(key);
+	if (index < 0) return;
+
+	auto & instance = *instances[index];
+	build_geometry(instance.blas, points, vertex_count, triangles);
+
+	remove_leaf(index);
+	if (instance.blas.empty()) return;
+	world_bounds(instance);
+	insert_leaf(index);
+}
+
+void EDSceneBvh::build_geometry(EDBvh & blas, const float * points, size_t vertex_count, const std::vector<int> & triangles)
+{
+	std::vector<float> x(vertex_count), y(vertex_count), z(vertex_count);
+	for (size_t i = 0; i < vertex_count; i++)
+	{
+		x[i] = points[i * 3];
+		y[i] = points[i * 3 + 1];
+		z[i] = points[i * 3 + 2];
+	}
+	blas.build(x.data(), y.data(), z.data(), triangles.data(), triangles.size() / 3);
+}
+
+void EDSceneBvh::end_update()
+{
+	for (size_t i = 0; i < instances.size(); i++)
+	{
+		auto & instance = instances[i];
+		if (instance && !instance->pinned && !instance->touched)
+		{
+			drop_instance(static_cast<int>(i));
+		}
+	}
+}
+
+void EDSceneBvh::insert_instance(const std::string & key, const float * points, size_t vertex_count, const std::vector<int> & triangles, const double world_matrix[4][4])
+{
+	auto index = find(key);
+	if (index < 0) index = add_instance(key);
+
+	auto & instance = *instances[index];
+	instance.pinned = true;
+	std::copy(&world_matrix[0][0], &world_matrix[0][0] + 16, &instance.to_world[0][0]);
+	invert_affine(instance.to_world, instance.to_object);
+	set_geometry(key, points, vertex_count, triangles);
+}
+
+void EDSceneBvh::insert_instance(const std::string & key, EDBvh && blas, const double world_matrix[4][4])
+{
+	auto index = find(key);
+	if (index < 0) index = add_instance(key);
+
+	auto & instance = *instances[index];
+	instance.pinned = true;
+	std::copy(&world_matrix[0][0], &world_matrix[0][0] + 16, &instance.to_world[0][0]);
+	invert_affine(instance.to_world, instance.to_object);
+	instance.blas = std::move(blas);
+
+	remove_leaf(index);
+	if (instance.blas.empty()) return;
+	world_bounds(instance);
+	insert_leaf(index);
+}
+
+void EDSceneBvh::remove_instance(const std::string & key)
+{
+	auto index = find(key);
+	if (index >= 0) drop_instance(index);
+}
+
+void EDSceneBvh::world_bounds(Instance & instance)
+{
+	float lo[3], hi[3];
+	instance.blas.bounds(lo, hi);
+	for (int a = 0; a < 3; a++)
+	{
+		instance.lo[a] = std::numeric_limits<float>::max();
+		instance.hi[a] = -std::numeric_limits<float>::max();
+	}
+	for (int corner = 0; corner < 8; corner++)
+	{
+		float p[] = { corner & 1 ? hi[0] : lo[0], corner & 2 ? hi[1] : lo[1], corner & 4 ? hi[2] : lo[2] };
+		float w[3];
+		transform(instance.to_world, p, 1, w);
+		for (int a = 0; a < 3; a++)
+		{
+			instance.lo[a] = std::min(instance.lo[a], w[a]);
+			instance.hi[a] = std::max(instance.hi[a], w[a]);
+		}
+	}
+}
+
+int EDSceneBvh::allocate_node()
+{
+	if (!free_nodes.empty())
+	{
+		auto index = free_nodes.back();
+		free_nodes.pop_back();
+		return index;
+	}
+	nodes.push_back(Node());
+	return static_cast<int>(nodes.size()) - 1;
+}
+
+// bounds of node from its children, up to the root
+void EDSceneBvh::refit(int node)
+{
+	for (; node >= 0; node = nodes[node].parent)
+	{
+		auto & n = nodes[node];
+		auto & l = nodes[n.left];
+		auto & r = nodes[n.right];
+		for (int a = 0; a < 3; a++)
+		{
+			n.lo[a] = std::min(l.lo[a], r.lo[a]);
+			n.hi[a] = std::max(l.hi[a], r.hi[a]);
+		}
+	}
+}
+
+///
+//  Walks down towards the sibling whose union with the new box costs the
+//  least surface area, counting what every ancestor on the way grows by.
+///
+void EDSceneBvh::insert_leaf(int instance)
+{
+	auto & inst = *instances[instance];
+	auto leaf = allocate_node();
+	inst.leaf = leaf;
+	{
+		auto & n = nodes[leaf];
+		std::copy(inst.lo, inst.lo + 3, n.lo);
+		std::copy(inst.hi, inst.hi + 3, n.hi);
+		n.parent = n.left = n.right = -1;
+		n.instance = instance;
+	}
+	if (root < 0)
+	{
+		root = leaf;
+		return;
+	}
+
+	auto index = root;
+	while (nodes[index].instance < 0)
+	{
+		auto & n = nodes[index];
+		auto own = area(n.lo, n.hi);
+		auto combined = union_area(n.lo, n.hi, inst.lo, inst.hi);
+		// making a new parent here, and what descending adds to this node
+		auto cost = 2 * combined;
+		auto inherited = 2 * (combined - own);
+
+		auto child_cost = [&](int c)
+		{
+			auto & child = nodes[c];
+			auto grown = union_area(child.lo, child.hi, inst.lo, inst.hi);
+			return (child.instance >= 0 ? grown : grown - area(child.lo, child.hi)) + inherited;
+		};
+		auto cost_left = child_cost(n.left);
+		auto cost_right = child_cost(n.right);
+		if (cost < cost_left && cost < cost_right) break;
+		index = cost_left < cost_right ? n.left : n.right;
+	}
+
+	auto sibling = index;
+	auto old_parent = nodes[sibling].parent;
+	auto parent = allocate_node();
+	nodes[parent].parent = old_parent;
+	nodes[parent].left = sibling;
+	nodes[parent].right = leaf;
+	nodes[parent].instance = -1;
+	if (old_parent < 0)
+	{
+		root = parent;
+	}
+	else if (nodes[old_parent].left == sibling)
+	{
+		nodes[old_parent].left = parent;
+	}
+	else
+	{
+		nodes[old_parent].right = parent;
+	}
+	nodes[sibling].parent = parent;
+	nodes[leaf].parent = parent;
+	refit(parent);
+}
+
+void EDSceneBvh::remove_leaf(int instance)
+{
+	auto & inst = *instances[instance];
+	auto leaf = inst.leaf;
+	if (leaf < 0) return;
+	inst.leaf = -1;
+	free_nodes.push_back(leaf);
+
+	if (leaf == root)
+	{
+		root = -1;
+		return;
+	}
+
+	// the sibling takes the parent's place
+	auto parent = nodes[leaf].parent;
+	auto grand = nodes[parent].parent;
+	auto sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+	free_nodes.push_back(parent);
+	nodes[sibling].parent = grand;
+	if (grand < 0)
+	{
+		root = sibling;
+		return;
+	}
+	if (nodes[grand].left == parent)
+		nodes[grand].left = sibling;
+	else
+		nodes[grand].right = sibling;
+	refit(grand);
+}
+
+bool EDSceneBvh::intersect(const float origin[3], const float direction[3], Hit & hit, float t_max) const
+{
+	if (root < 0) return false;
+
+	bool found = false;
+	float best_t = t_max;
+	std::vector<int> stack(1, root);
+	while (!stack.empty())
+	{
+		auto & node = nodes[stack.back()];
+		stack.pop_back();
+		if (enter_box(node.lo, node.hi, origin, direction, best_t) < 0) continue;
+
+		if (node.instance < 0)
+		{
+			stack.push_back(node.left);
+			stack.push_back(node.right);
+			continue;
+		}
+
+		// the ray in object space keeps its parameter, so t compares across instances
+		auto & instance = *instances[node.instance];
+		float o[3], d[3];
+		transform(instance.to_object, origin, 1, o);
+		transform(instance.to_object, direction, 0, d);
+		EDBvh::Hit local;
+		if (instance.blas.intersect(o, d, local, best_t))
+		{
+			best_t = local.t;
+			hit.t = local.t;
+			hit.instance = node.instance;
+			hit.triangle = local.triangle;
+			hit.u = local.u;
+			hit.v = local.v;
+			found = true;
+		}
+	}
+	return found;
+}
+
+void EDSceneBvh::intersect_all(const float origin[3], const float direction[3], std::vector<Hit> & hits, float t_max) const
+{
+	hits.clear();
+	if (root < 0) return;
+
+	std::vector<EDBvh::Hit> local;
+	std::vector<int> stack(1, root);
+	while (!stack.empty())
+	{
+		auto & node = nodes[stack.back()];
+		stack.pop_back();
+		if (enter_box(node.lo, node.hi, origin, direction, t_max) < 0) continue;
+
+		if (node.instance < 0)
+		{
+			stack.push_back(node.left);
+			stack.push_back(node.right);
+			continue;
+		}
+
+		auto & instance = *instances[node.instance];
+		float o[3], d[3];
+		transform(instance.to_object, origin, 1, o);
+		transform(instance.to_object, direction, 0, d);
+		local.clear();
+		instance.blas.intersect_all(o, d, local, t_max);
+		for (auto & l : local)
+		{
+			Hit hit = { l.t, node.instance, l.triangle, l.u, l.v };
+			hits.push_back(hit);
+		}
+	}
+	std::sort(hits.begin(), hits.end(), [](const Hit & a, const Hit & b) { return a.t < b.t; });
+}
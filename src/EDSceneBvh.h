@@ -0,0 +1,133 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// Two-level BVH over every mesh strokes can land on.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include "EDBvh.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+///
+//  One bottom-level EDBvh per mesh, built in the mesh's object space, and
+//  a dynamic top-level tree over the instances' world bounds. Instances are
+//  inserted next to the sibling that grows the least and removed by
+//  splicing in their sibling, so adding, moving or dropping one mesh never
+//  rebuilds the others. A bottom level is rebuilt only when its geometry
+//  hash changes.
+//
+//  Selected meshes are refreshed between begin_update() and end_update();
+//  pinned instances (shapes the tool generated) stay until removed.
+///
+class EDSceneBvh
+{
+public:
+	struct Hit
+	{
+		float t;
+		int instance;
+		int triangle;
+		float u, v;
+	};
+
+	// unpinned instances not updated between begin_update() and end_update() are dropped
+	void begin_update();
+	///
+	//  key names the instance (its DAG path); geometry_hash covers its
+	//  object-space points and topology. Returns true if the geometry must
+	//  be given again with set_geometry().
+	///
+	bool update_instance(const std::string & key, uint64_t geometry_hash, const double world_matrix[4][4]);
+	// xyz interleaved object-space points, 3 indices per triangle
+	void set_geometry(const std::string & key, const float * points, size_t vertex_count, const std::vector<int> & triangles);
+	void end_update();
+
+	// adds or replaces a pinned instance, outside of any update
+	void insert_instance(const std::string & key, const float * points, size_t vertex_count, const std::vector<int> & triangles, const double world_matrix[4][4]);
+	// same, with a bottom level already built by build_geometry(), e.g. on another thread
+	void insert_instance(const std::string & key, EDBvh && blas, const double world_matrix[4][4]);
+	static void build_geometry(EDBvh & blas, const float * points, size_t vertex_count, const std::vector<int> & triangles);
+	void remove_instance(const std::string & key);
+	void clear();
+
+	bool empty() const { return root < 0; }
+	size_t instance_count() const { return live; }
+	bool has_instance(const std::string & key) const { return find(key) >= 0; }
+	const std::string & instance_key(int instance) const { return instances[instance]->key; }
+
+	bool intersect(const float origin[3], const float direction[3], Hit & hit,
+		float t_max = std::numeric_limits<float>::max()) const;
+	// every hit along the ray, nearest first, from one traversal
+	void intersect_all(const float origin[3], const float direction[3], std::vector<Hit> & hits,
+		float t_max = std::numeric_limits<float>::max()) const;
+
+private:
+	struct Instance
+	{
+		std::string key;
+		uint64_t hash;
+		bool touched;
+		bool pinned;
+		// its leaf in the top level, -1 while it has no geometry
+		int leaf;
+		EDBvh blas;
+		// row vectors, as in Maya: world = object * to_world
+		double to_world[4][4];
+		double to_object[4][4];
+		float lo[3], hi[3];
+	};
+
+	struct Node
+	{
+		float lo[3];
+		float hi[3];
+		int parent;
+		int left, right;
+		int instance;  // -1 for inner nodes
+	};
+
+	int find(const std::string & key) const;
+	int add_instance(const std::string & key);
+	void drop_instance(int instance);
+	void world_bounds(Instance & instance);
+
+	int allocate_node();
+	void insert_leaf(int instance);
+	void remove_leaf(int instance);
+	void refit(int node);
+
+	// empty slots are null and reused
+	std::vector<std::unique_ptr<Instance>> instances;
+	std::vector<int> free_instances;
+	size_t live = 0;
+
+	std::vector<Node> nodes;
+	std::vector<int> free_nodes;
+	int root = -1;
+};
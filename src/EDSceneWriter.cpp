@@ -0,0 +1,236 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+// Created: Oct 19, 2026
+
+#include "EDSceneWriter.h"
+#include "EDCurveFit.h"
+
+#include <maya/MGlobal.h>
+
+namespace
+{
+	///
+	//  The flags of a curve command for the cubic EDCurveFit puts through
+	//  the points: its control points and its knots, without the outer two
+	//  Maya leaves out. Too few points for a fit give a polyline.
+	///
+	void append_fitted_curve(std::string & body, const std::vector<MPoint> & points)
+	{
+		std::vector<double> samples, control_points, knots;
+		samples.reserve(points.size() * 3);
+		for (auto & p : points)
+		{
+			samples.push_back(p.x);
+			samples.push_back(p.y);
+			samples.push_back(p.z);
+		}
+		bool fitted = EDCurveFit::fit(samples, 8, control_points);
+		auto & cvs = fitted ? control_points : samples;
+		body.append(fitted ? " -d 3" : " -d 1");
+		for (size_t i = 0; i + 2 < cvs.size(); i += 3)
+		{
+			body.append(" -p ");
+			body.append(std::to_string(cvs[i]));
+			body.append(" ");
+			body.append(std::to_string(cvs[i + 1]));
+			body.append(" ");
+			body.append(std::to_string(cvs[i + 2]));
+		}
+		if (!fitted) return;
+
+		EDCurveFit::knots(control_points.size() / 3, knots);
+		for (size_t k = 1; k + 1 < knots.size(); k++)
+		{
+			body.append(" -k ");
+			body.append(std::to_string(knots[k]));
+		}
+	}
+}
+
+void EDSceneWriter::begin()
+{
+	ops.clear();
+}
+
+std::string EDSceneWriter::ref(Op op)
+{
+	return "$__ed_nodes[" + std::to_string(op) + "]";
+}
+
+std::string EDSceneWriter::quote(const MString & name)
+{
+	return std::string("\"") + name.asChar() + "\"";
+}
+
+EDSceneWriter::Op EDSceneWriter::add_op(const std::string & body)
+{
+	ops.push_back(body);
+	return static_cast<Op>(ops.size() - 1);
+}
+
+EDSceneWriter::Op EDSceneWriter::add_curve(const std::vector<MPoint> & points)
+{
+	std::string body;
+	body.reserve(1000);
+	body.append("string $cv = `curve");
+	append_fitted_curve(body, points);
+	body.append("`;\n");
+	body.append("$node = $cv;\n");
+	return add_op(body);
+}
+
+void EDSceneWriter::add_replace_curve(const std::string & curve, const std::vector<MPoint> & points)
+{
+	std::string body;
+	body.reserve(1000);
+	body.append("curve -r");
+	append_fitted_curve(body, points);
+	body.append(" " + curve + ";\n");
+	add_op(body);
+}
+
+EDSceneWriter::Op EDSceneWriter::add_surface(const std::vector<std::string> & curves)
+{
+	std::string body;
+	body.reserve(500);
+	body.append("select -r");
+	for (auto & c : curves)
+	{
+		body.append(" ");
+		body.append(c);
+	}
+	body.append(";\n");
+	body.append("string $nurbssurf[] = `boundary -ch 1 -or 0 -ep 0 -rn 0 -po 0 -ept 0.01");
+	for (auto & c : curves)
+	{
+		body.append(" ");
+		body.append(c);
+	}
+	body.append("`;\n");
+	body.append("$node = $nurbssurf[0];\n");
+	return add_op(body);
+}
+
+EDSceneWriter::Op EDSceneWriter::add_attached_curve(const std::vector<std::string> & curves)
+{
+	if (curves.empty())
+	{
+		return kInvalidOp;
+	}
+
+	// attach one by one into a new curve, keeping the inputs
+	std::string body;
+	body.reserve(200 * curves.size());
+	body.append("string $att = " + curves[0] + ";\n");
+	body.append("string $att_res[];\n");
+	for (size_t i = 1; i < curves.size(); i++)
+	{
+		body.append("$att_res = `attachCurve -ch 1 -rpo 0 -kmk 1 -m 0 -bb 0.5 -bki 0 -p 0.1 $att " + curves[i] + "`;\n");
+		body.append("$att = $att_res[0];\n");
+	}
+	body.append("$node = $att;\n");
+	return add_op(body);
+}
+
+EDSceneWriter::Op EDSceneWriter::add_reversed_curve(const std::string & curve)
+{
+	std::string body;
+	body.append("string $rev[] = `reverseCurve -ch 1 -rpo 0 " + curve + "`;\n");
+	body.append("$node = $rev[0];\n");
+	return add_op(body);
+}
+
+EDSceneWriter::Op EDSceneWriter::add_extrusion(const std::string & surface, double distance)
+{
+	std::string body;
+	body.reserve(500);
+	body.append("string $mesh_surf[]= `nurbsToPoly -mnd 1  -ch 1 -f 1 -pt 1 -pc 200 -chr 0.9 -ft 0.01 -mel 0.001 -d 0.1 -ut 1 -un 3 -vt 1 -vn 3 -uch 0 -ucr 0 -cht 0.01 -es 0 -ntr 0 -mrt 0 -uss 1 ");
+	body.append(surface);
+	body.append("`;\n");
+	body.append("polyExtrudeFacet -ltz " + std::to_string(distance) + " -constructionHistory 1 -keepFacesTogether 1 -divisions 4 -twist 0 -taper 1 -off 0 -thickness 0 -smoothingAngle 30 $mesh_surf[0];\n");
+	body.append("$node = $mesh_surf[0];\n");
+	return add_op(body);
+}
+
+MStatus EDSceneWriter::commit(MStringArray & created)
+{
+	created.clear();
+	if (ops.empty())
+	{
+		return MS::kSuccess;
+	}
+
+	std::string script;
+	script.reserve(1000);
+	script.append("global proc string[] __ed_batch_nodes() { global string $__ed_nodes[]; return $__ed_nodes; }\n");
+	script.append("global proc __ed_batch() { \n");
+	script.append("global string $__ed_nodes[];\n");
+	script.append("clear $__ed_nodes;\n");
+	script.append("string $slct[]=`ls- sl`;\n");
+	for (size_t i = 0; i < ops.size(); i++)
+	{
+		script.append("{\nstring $node = \"\";\n");
+		script.append(ops[i]);
+		script.append(ref(static_cast<Op>(i)) + " = $node;\n}\n");
+	}
+	script.append("select $slct; \n } \n");
+	script.append("__ed_batch();");
+	ops.clear();
+
+	history.emplace_back();
+	auto & batch = history.back();
+	batch.modifier.reset(new MDGModifier);
+	batch.modifier->commandToExecute(MString(script.c_str()));
+
+	auto stat = batch.modifier->doIt();
+	if (!stat)
+	{
+		history.pop_back();
+		return stat;
+	}
+
+	MGlobal::executeCommand("__ed_batch_nodes()", batch.created);
+	created = batch.created;
+	return stat;
+}
+
+bool EDSceneWriter::undo_last(MStringArray & removed)
+{
+	removed.clear();
+	if (history.empty())
+	{
+		return false;
+	}
+
+	auto & batch = history.back();
+	batch.modifier->undoIt();
+	removed = batch.created;
+	history.pop_back();
+	return true;
+}
+
+void EDSceneWriter::drop_oldest(size_t count)
+{
+	while (count-- > 0 && !history.empty())
+	{
+		history.pop_front();
+	}
+}
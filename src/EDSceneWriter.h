@@ -0,0 +1,87 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+// Batches every scene edit of one stroke into a single MDGModifier.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include <maya/MDGModifier.h>
+#include <maya/MPoint.h>
+#include <maya/MString.h>
+#include <maya/MStringArray.h>
+
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+///
+//  Collects the curves, surfaces and extrusions of one stroke and
+//  runs them as one MEL batch through an MDGModifier: one DG evaluation,
+//  one undo unit.
+//
+//  Every add_* returns an op index. Later ops of the same batch refer to
+//  that node with ref(op), nodes from earlier batches with quote(name).
+///
+class EDSceneWriter
+{
+public:
+	typedef int Op;
+	static const Op kInvalidOp = -1;
+
+	void begin();
+	bool empty() const { return ops.empty(); }
+
+	Op add_curve(const std::vector<MPoint> & points);
+	// reshapes an existing curve in place; nodes built from it update through history
+	void add_replace_curve(const std::string & curve, const std::vector<MPoint> & points);
+	Op add_surface(const std::vector<std::string> & curves);
+	Op add_attached_curve(const std::vector<std::string> & curves);
+	// a reversed copy, keeping the input
+	Op add_reversed_curve(const std::string & curve);
+	Op add_extrusion(const std::string & surface, double distance);
+
+	static std::string ref(Op op);
+	static std::string quote(const MString & name);
+
+	// runs the batch; created[op] is the name of the node made by op
+	MStatus commit(MStringArray & created);
+
+	// undoes the last committed batch and returns the names it created
+	bool undo_last(MStringArray & removed);
+	bool can_undo() const { return !history.empty(); }
+
+	// forgets the oldest batches; they can no longer be undone
+	void drop_oldest(size_t count);
+
+private:
+	struct Batch
+	{
+		std::unique_ptr<MDGModifier> modifier;
+		MStringArray created;
+	};
+
+	Op add_op(const std::string & body);
+
+	std::vector<std::string> ops;
+	std::list<Batch> history;
+};
@@ -0,0 +1,204 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// Created: Oct 19, 2026
+
+#include "EDShellCache.h"
+
+#include "EDMeshSnapshot.h"
+#include "EDParallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace
+{
+	const float kLevelRatio = 1.02f;
+}
+
+int EDShellCache::level_of(float height)
+{
+	return static_cast<int>(std::floor(std::log(height) / std::log(kLevelRatio) + 0.5f));
+}
+
+float EDShellCache::level_height(int level)
+{
+	return std::pow(kLevelRatio, static_cast<float>(level));
+}
+
+void EDShellCache::clear()
+{
+	mesh_revision = 0;
+	vertex_ring.clear();
+	patch_rings = 0;
+	px.clear();
+	py.clear();
+	pz.clear();
+	nx.clear();
+	ny.clear();
+	nz.clear();
+	local_triangles.clear();
+	shells.clear();
+}
+
+bool EDShellCache::covers(const EDMeshSnapshot & mesh, const std::vector<int> & seeds, int rings) const
+{
+	if (empty() || mesh_revision != mesh.revision() || vertex_ring.size() != mesh.vertex_count()) return false;
+
+	for (auto s : seeds)
+	{
+		if (vertex_ring[s] < 0 || vertex_ring[s] + rings > patch_rings) return false;
+	}
+	return true;
+}
+
+void EDShellCache::set_patch(const EDMeshSnapshot & mesh, const EDMeshAdjacency & adjacency, const std::vector<int> & seeds, int rings)
+{
+	if (covers(mesh, seeds, rings)) return;
+
+	clear();
+	mesh_revision = mesh.revision();
+	if (mesh.vertex_normals.size() != mesh.vertex_count() * 3 || seeds.empty()) return;
+
+	// twice the rings needed, so strokes nearby still fit
+	patch_rings = std::max(rings, 1) * 2;
+	std::vector<int> vertices, ring_of;
+	adjacency.expand_rings(seeds, patch_rings, vertices, &ring_of);
+	vertex_ring.assign(mesh.vertex_count(), -1);
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		vertex_ring[vertices[i]] = ring_of[i];
+	}
+
+	// every triangle touching the patch
+	std::vector<int> region;
+	std::vector<bool> taken(mesh.triangle_count());
+	for (auto v : vertices)
+	{
+		for (auto f = adjacency.faces_begin(v); f != adjacency.faces_end(v); ++f)
+		{
+			if (taken[*f]) continue;
+			taken[*f] = true;
+			region.push_back(*f);
+		}
+	}
+
+	// compact the patch's vertices so a shell only touches what it needs
+	std::unordered_map<int, int> local;
+	local_triangles.reserve(region.size() * 3);
+	for (auto t : region)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			auto v = mesh.triangles[t * 3 + k];
+			auto it = local.find(v);
+			if (it == local.end())
+			{
+				it = local.insert(std::make_pair(v, static_cast<int>(px.size()))).first;
+				px.push_back(mesh.x[v]);
+				py.push_back(mesh.y[v]);
+				pz.push_back(mesh.z[v]);
+				nx.push_back(mesh.vertex_normals[v * 3]);
+				ny.push_back(mesh.vertex_normals[v * 3 + 1]);
+				nz.push_back(mesh.vertex_normals[v * 3 + 2]);
+			}
+			local_triangles.push_back(it->second);
+		}
+	}
+}
+
+void EDShellCache::build_shell(int level, EDBvh & bvh) const
+{
+	auto h = level_height(level);
+	auto count = px.size();
+	std::vector<float> x(count), y(count), z(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		x[i] = px[i] + nx[i] * h;
+		y[i] = py[i] + ny[i] * h;
+		z[i] = pz[i] + nz[i] * h;
+	}
+	bvh.build(x.data(), y.data(), z.data(), local_triangles.data(), local_triangles.size() / 3);
+}
+
+void EDShellCache::prepare(const std::vector<float> & heights, bool parallel)
+{
+	if (local_triangles.empty()) return;
+
+	std::vector<int> needed;
+	for (auto h : heights)
+	{
+		if (!(h > 0)) continue;
+		auto level = level_of(h);
+		if (std::find(needed.begin(), needed.end(), level) == needed.end())
+		{
+			needed.push_back(level);
+		}
+	}
+
+	std::vector<int> missing;
+	for (auto level : needed)
+	{
+		if (!shells.count(level)) missing.push_back(level);
+	}
+	if (missing.empty()) return;
+
+	// starting over drops the levels these heights already had as well
+	if (shells.size() + missing.size() > kMaxShells)
+	{
+		shells.clear();
+		missing = needed;
+	}
+
+	// make the slots first so the builds never touch the map
+	std::vector<EDBvh *> slots;
+	for (auto level : missing)
+	{
+		slots.push_back(&shells[level]);
+	}
+	EDParallel::for_each_index(missing.size(), [&](size_t i)
+	{
+		build_shell(missing[i], *slots[i]);
+	}, parallel);
+}
+
+bool EDShellCache::intersect(float height, const float origin[3], const float direction[3], float & t)
+{
+	if (height > 0 && !local_triangles.empty() && !shells.count(level_of(height)))
+	{
+		prepare(std::vector<float>(1, height), false);
+	}
+	return static_cast<const EDShellCache &>(*this).intersect(height, origin, direction, t);
+}
+
+bool EDShellCache::intersect(float height, const float origin[3], const float direction[3], float & t) const
+{
+	if (!(height > 0)) return false;
+
+	auto it = shells.find(level_of(height));
+	if (it == shells.end()) return false;
+
+	EDBvh::Hit hit;
+	if (!it->second.intersect(origin, direction, hit)) return false;
+	t = hit.t;
+	return true;
+}
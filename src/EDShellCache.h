@@ -0,0 +1,82 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// Offset surfaces around the stroke, for shell projection.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include "EDBvh.h"
+#include "EDMeshAdjacency.h"
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+///
+//  The triangles of one patch of the mesh pushed out along their vertex
+//  normals. Heights snap to geometric levels 2% apart; each level's
+//  BVH is built the first time a height needs it.
+//
+//  The patch is the vertices within some rings of a stroke's seed vertices,
+//  grown with as many rings again to spare. Later strokes whose own rings
+//  fit inside it keep the patch and every shell built on it.
+///
+class EDShellCache
+{
+public:
+	// past this many levels the cache starts over
+	static const int kMaxShells = 32;
+
+	// whether the patch holds every vertex within rings of the seeds
+	bool covers(const EDMeshSnapshot & mesh, const std::vector<int> & seeds, int rings) const;
+	// keeps the patch and its shells if it covers the seeds, else starts a new one around them
+	void set_patch(const EDMeshSnapshot & mesh, const EDMeshAdjacency & adjacency, const std::vector<int> & seeds, int rings);
+	void clear();
+
+	bool empty() const { return local_triangles.empty(); }
+	size_t shell_count() const { return shells.size(); }
+
+	// builds every level the heights snap to, in parallel; heights <= 0 are skipped
+	void prepare(const std::vector<float> & heights, bool parallel = true);
+
+	// nearest hit of the ray with the shell at height, built on demand.
+	// Only the const overload is safe across threads, after prepare().
+	bool intersect(float height, const float origin[3], const float direction[3], float & t);
+	bool intersect(float height, const float origin[3], const float direction[3], float & t) const;
+
+	static int level_of(float height);
+	static float level_height(int level);
+
+private:
+	void build_shell(int level, EDBvh & bvh) const;
+
+	unsigned mesh_revision = 0;
+	// ring of each mesh vertex in the patch, -1 outside it
+	std::vector<int> vertex_ring;
+	int patch_rings = 0;
+	// the patch vertices: positions and normals, per axis
+	std::vector<float> px, py, pz, nx, ny, nz;
+	// triangles touching the patch, re-indexed into the arrays above
+	std::vector<int> local_triangles;
+	std::map<int, EDBvh> shells;
+};
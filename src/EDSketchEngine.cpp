@@ -0,0 +1,911 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// Created: Oct 19, 2026
+
+#include "EDSketchEngine.h"
+#include "EDParallel.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+	typedef EDSketchEngine::Vec Vec;
+	typedef EDMath::VectorOps<Vec> Ops;
+
+	inline double length(const Vec & v)
+	{
+		return std::sqrt(Ops::dot(v, v));
+	}
+
+	inline Vec origin_at(const EDRayBatch & rays, size_t i)
+	{
+		return Vec(rays.ox[i], rays.oy[i], rays.oz[i]);
+	}
+
+	inline Vec direction_at(const EDRayBatch & rays, size_t i)
+	{
+		return Vec(rays.dx[i], rays.dy[i], rays.dz[i]);
+	}
+
+	inline void to_floats(const Vec & p, float out[3])
+	{
+		out[0] = static_cast<float>(p.x);
+		out[1] = static_cast<float>(p.y);
+		out[2] = static_cast<float>(p.z);
+	}
+
+	// points[j] = where ray j meets the plane, for j in [begin, end)
+	void project_rays(const EDRayBatch & rays, size_t begin, size_t end, const Vec & point, const Vec & normal,
+		std::vector<Vec> & points)
+	{
+		EDPlane plane = { { point.x, point.y, point.z }, { normal.x, normal.y, normal.z } };
+		auto n = rays.size();
+		std::vector<float> x(n), y(n), z(n);
+		EDRays::project_on_plane(rays, begin, end, plane, x.data(), y.data(), z.data());
+		for (size_t j = begin; j < end; j++)
+		{
+			points[j] = Vec(x[j], y[j], z[j]);
+		}
+	}
+
+	// EDRays::project_misses over doubles; the hits keep theirs
+	void project_misses(const EDRayBatch & rays, const std::vector<bool> & hits, std::vector<Vec> & points)
+	{
+		auto length = points.size();
+		std::vector<float> x(length), y(length), z(length);
+		for (size_t i = 0; i < length; i++)
+		{
+			x[i] = static_cast<float>(points[i].x);
+			y[i] = static_cast<float>(points[i].y);
+			z[i] = static_cast<float>(points[i].z);
+		}
+		EDRays::project_misses(rays, hits, x.data(), y.data(), z.data());
+		for (size_t i = 1; i + 1 < length; i++)
+		{
+			if (!hits[i]) points[i] = Vec(x[i], y[i], z[i]);
+		}
+	}
+}
+
+bool EDCamera::to_port(const EDVec3<double> & p, float & x, float & y, float & z) const
+{
+	return EDMath::to_port(view_projection, p.x, p.y, p.z, width, height, x, y, z);
+}
+
+void EDCamera::ray(float px, float py, EDVec3<double> & origin, EDVec3<double> & direction) const
+{
+	EDRayBatch rays;
+	rays.generate(inverse, width, height, &px, &py, 1);
+	origin = origin_at(rays, 0);
+	direction = direction_at(rays, 0);
+}
+
+bool EDCamera::same_view(const EDCamera & other) const
+{
+	return width == other.width && height == other.height
+		&& std::memcmp(view_projection, other.view_projection, sizeof(view_projection)) == 0;
+}
+
+void EDSketchEngine::set_raster_hit_test(bool enabled)
+{
+	raster_enabled = enabled;
+	raster_cache.valid = false;
+}
+
+///
+//  Re-rasterizes the mesh only when the view or the mesh points changed.
+//  With several meshes selected, strokes are cast against all of them.
+///
+void EDSketchEngine::update_raster()
+{
+	auto & cache = raster_cache;
+	if (!raster_enabled || surface_set.size() != 1 || surface_set[0].mesh().empty())
+	{
+		cache.valid = false;
+		return;
+	}
+
+	auto & mesh = surface_set[0].mesh();
+	bool same_mesh = cache.valid && cache.mesh_revision == surface_set.revision();
+	if (same_mesh && cache.camera.same_view(view))
+	{
+		return;
+	}
+
+	// to clip space; the rasterizer clips triangles reaching behind the camera
+	auto length = mesh.vertex_count();
+	auto & vp = view.view_projection;
+	std::vector<EDRasterizer::ClipVertex> clip(length);
+	EDParallel::for_each_index((length + 4095) / 4096, [&](size_t chunk)
+	{
+		auto end = std::min(length, (chunk + 1) * 4096);
+		for (auto i = chunk * 4096; i < end; i++)
+		{
+			double x = mesh.x[i], y = mesh.y[i], z = mesh.z[i];
+			auto column = [&](int c) { return static_cast<float>(x * vp[0][c] + y * vp[1][c] + z * vp[2][c] + vp[3][c]); };
+			clip[i].x = column(0);
+			clip[i].y = column(1);
+			clip[i].z = column(2);
+			clip[i].w = column(3);
+		}
+	});
+
+	cache.camera = view;
+	cache.mesh_revision = surface_set.revision();
+	cache.raster.resize(view.width, view.height);
+	cache.raster.rasterize(clip, mesh.triangles);
+	cache.distance.build(cache.raster);
+	cache.valid = true;
+}
+
+void EDSketchEngine::make_rays(const Stroke & stroke, EDRayBatch & rays) const
+{
+	rays.generate(view.inverse, view.width, view.height, stroke.px.data(), stroke.py.data(), stroke.size());
+}
+
+bool EDSketchEngine::project(const Stroke & stroke, Result & result)
+{
+	result.strategy = kUnprojected;
+	result.points.clear();
+	result.hits.clear();
+	result.projection.clear();
+	auto num_points = stroke.size();
+	if (surface_set.empty() || num_points < 3)
+	{
+		return false;
+	}
+
+	// the vertex index is only built if this stroke needs it, around the stroke
+	kd_stale = true;
+	roi[0] = roi[2] = stroke.px[0];
+	roi[1] = roi[3] = stroke.py[0];
+	for (size_t i = 1; i < num_points; i++)
+	{
+		roi[0] = std::min(roi[0], stroke.px[i]);
+		roi[1] = std::min(roi[1], stroke.py[i]);
+		roi[2] = std::max(roi[2], stroke.px[i]);
+		roi[3] = std::max(roi[3], stroke.py[i]);
+	}
+
+	auto & points = result.points;
+	auto & hits = result.hits;
+	points.resize(num_points, Vec(0, 0, 0));
+	hits.resize(num_points);
+	// which surface each sample is measured on, -1 for misses
+	std::vector<int> hit_surface(num_points, -1);
+	EDRayBatch rays;
+	make_rays(stroke, rays);
+
+	unsigned hit_count = 0;
+	for (size_t i = 0; i < num_points; i++)
+	{
+		int surface = -1;
+		bool hit = hit_test(stroke.px[i], stroke.py[i], origin_at(rays, i), direction_at(rays, i), points[i], surface);
+		if (hit)
+		{
+			hit_count++;
+			hit_surface[i] = surface;
+		}
+		hits[i] = hit;
+	}
+	if (stroke.start_known)
+	{
+		points[0] = stroke.start_point;
+	}
+	if (stroke.end_known)
+	{
+		points[num_points - 1] = stroke.end_point;
+	}
+
+	if (hit_count == 0)
+	{
+		// TODO: SHAPE MATCHING!
+		result.strategy = kContour;
+		project_contour(stroke, rays, result);
+	}
+	else if ((is_normal(stroke, points, hits, hit_surface) || stroke.normal_mode) && (hits[0] || hits[num_points - 1]))
+	{
+		result.strategy = kNormalPlane;
+		project_normal(stroke, rays, hit_surface, result);
+	}
+	else if (stroke.tangent_mode)
+	{
+		// TODO: actually use is_tangent the same time as force tangent
+		result.strategy = kTangentPlane;
+		project_tangent(stroke, rays, hit_surface, result);
+	}
+	else
+	{
+		result.strategy = kShell;
+		project_shell(stroke, rays, hit_surface, result);
+	}
+	return true;
+}
+
+bool EDSketchEngine::project_span(const Stroke & stroke, const EDProjectionData & old, float h0, float h1, Result & result)
+{
+	result.strategy = old.has_plane ? kUnprojected : kShell;
+	result.projection = old;
+	result.projection.heights.clear();
+	auto length = stroke.size();
+	if (surface_set.empty() || length < 2)
+	{
+		return false;
+	}
+
+	auto & span = result.points;
+	span.assign(length, Vec(0, 0, 0));
+	result.hits.assign(length, true);
+	EDRayBatch rays;
+	make_rays(stroke, rays);
+
+	if (old.has_plane)
+	{
+		project_rays(rays, 0, length, old.plane_point, old.plane_normal, span);
+	}
+	for (size_t i = 0; i < length && !old.has_plane; i++)
+	{
+		auto origin = origin_at(rays, i);
+		auto direction = direction_at(rays, i);
+
+		float t = static_cast<float>(i) / static_cast<float>(length - 1);
+		float h = (1 - t) * h0 + t * h1;
+		result.projection.heights.push_back(h);
+		Vec hit_point;
+		int surface;
+		if (hit_test(stroke.px[i], stroke.py[i], origin, direction, hit_point, surface))
+		{
+			span[i] = EDMath::lift(hit_point, direction, static_cast<double>(h));
+		}
+		else
+		{
+			result.hits[i] = false;
+		}
+	}
+
+	// stitch the span onto the old curve
+	span.front() = stroke.start_point;
+	span.back() = stroke.end_point;
+	result.hits.front() = true;
+	result.hits.back() = true;
+
+	// misses go on the plane through the samples around them, as in project_shell
+	project_misses(rays, result.hits, span);
+	return true;
+}
+
+bool EDSketchEngine::is_normal(const Stroke & stroke, const std::vector<Vec> & points, const std::vector<bool> & hits,
+	const std::vector<int> & hit_surface)
+{
+	if (hits[0])
+	{
+		// if starting point is normal
+		auto num_points = stroke.size();
+		double tx = 0, ty = 0;
+		for (size_t i = 1; i < static_cast<size_t>(tang_samples) && i < num_points; i++)
+		{
+			tx += stroke.px[i] - stroke.px[0];
+			ty += stroke.py[i] - stroke.py[0];
+		}
+		double tangent_length = std::sqrt(tx * tx + ty * ty);
+
+		Vec surface_normal;
+		if (tangent_length == 0 || !surface_normal_at(stroke.px[0], stroke.py[0], points[0], hit_surface[0], surface_normal))
+		{
+			return false;
+		}
+		surface_normal = Ops::normalized(surface_normal);
+
+		float x0, y0, x1, y1, z;
+		if (!view.to_port(points[0], x0, y0, z) || !view.to_port(points[0] + surface_normal, x1, y1, z))
+		{
+			return false;
+		}
+		double nx = x1 - x0, ny = y1 - y0;
+		double normal_length = std::sqrt(nx * nx + ny * ny);
+		if (normal_length == 0)
+		{
+			return false;
+		}
+
+		auto v = 1.0 - (tx * nx + ty * ny) / (tangent_length * normal_length);
+		return v < normal_threshold;
+	}
+
+	// todo: last_hit
+	return false;
+}
+
+///
+//  Nearest hit along a camera ray, or the one on stroke_layer.
+///
+bool EDSketchEngine::cast_ray(const Vec & origin, const Vec & direction, Vec & hit_point, int & surface)
+{
+	if (scene_bvh.empty() || surface_set.empty())
+	{
+		return false;
+	}
+
+	float o[3], d[3];
+	to_floats(origin, o);
+	to_floats(direction, d);
+	EDSceneBvh::Hit hit;
+	if (stroke_layer == 0)
+	{
+		if (!scene_bvh.intersect(o, d, hit, 10000)) return false;
+	}
+	else if (!layer_hit(o, d, hit))
+	{
+		return false;
+	}
+	hit_point = origin + direction * static_cast<double>(hit.t);
+
+	surface = surface_set.find(scene_bvh.instance_key(hit.instance));
+	if (surface < 0)
+	{
+		float p[3];
+		to_floats(hit_point, p);
+		surface = surface_set.nearest(p);
+	}
+	return surface >= 0;
+}
+
+///
+//  A layer is one object along the ray: its nearest hit counts, the rest of
+//  it (the far side of a closed body) does not. Rays crossing fewer layers
+//  than asked for land on the deepest one.
+///
+bool EDSketchEngine::layer_hit(const float origin[3], const float direction[3], EDSceneBvh::Hit & hit) const
+{
+	std::vector<EDSceneBvh::Hit> hits;
+	scene_bvh.intersect_all(origin, direction, hits, 10000);
+
+	std::vector<int> seen;
+	for (auto & h : hits)
+	{
+		if (std::find(seen.begin(), seen.end(), h.instance) != seen.end()) continue;
+		seen.push_back(h.instance);
+		hit = h;
+		if (static_cast<int>(seen.size()) > stroke_layer) break;
+	}
+	return !seen.empty();
+}
+
+bool EDSketchEngine::hit_test(float px, float py, const Vec & origin, const Vec & direction, Vec & hit_point, int & surface)
+{
+	// the raster only holds the one selected mesh, front layer
+	if (raster_cache.valid && scene_bvh.instance_count() <= 1 && stroke_layer == 0)
+	{
+		surface = 0;
+		return raster_hit(px, py, origin, direction, hit_point);
+	}
+	return cast_ray(origin, direction, hit_point, surface);
+}
+
+///
+//  One buffer read for the triangle under the pixel, then one exact
+//  intersection with that triangle.
+///
+bool EDSketchEngine::raster_hit(float px, float py, const Vec & origin, const Vec & direction, Vec & hit_point) const
+{
+	auto t = raster_cache.raster.triangle_at(static_cast<int>(px), static_cast<int>(py));
+	if (t == EDRasterizer::kNoTriangle)
+	{
+		return false;
+	}
+
+	auto & mesh = surface_set[0].mesh();
+	auto tri = &mesh.triangles[t * 3];
+	auto corner = [&](int i) { return Vec(mesh.x[i], mesh.y[i], mesh.z[i]); };
+	double dist, u, v;
+	// the pixel center may fall just outside the triangle, so its plane is hit instead
+	if (!EDMath::intersect_triangle(corner(tri[0]), corner(tri[1]), corner(tri[2]), origin, direction, dist, u, v) || dist < 0)
+	{
+		return false;
+	}
+
+	hit_point = origin + direction * dist;
+	return true;
+}
+
+bool EDSketchEngine::raster_normal(float px, float py, Vec & normal) const
+{
+	if (!raster_cache.valid) return false;
+
+	auto t = raster_cache.raster.triangle_at(static_cast<int>(px), static_cast<int>(py));
+	if (t == EDRasterizer::kNoTriangle) return false;
+
+	auto & n = surface_set[0].mesh().face_normals;
+	normal = Vec(n[t * 3], n[t * 3 + 1], n[t * 3 + 2]);
+	return true;
+}
+
+// face normal under the pixel if the raster is on, else the nearest vertex normal of the surface hit
+bool EDSketchEngine::surface_normal_at(float px, float py, const Vec & p, int surface, Vec & normal)
+{
+	if (surface < 0 || surface >= static_cast<int>(surface_set.size())) return false;
+	if (raster_normal(px, py, normal)) return true;
+
+	float q[3], n[3];
+	to_floats(p, q);
+	if (!surface_set[surface].tangents().nearest_normal(q, n)) return false;
+
+	normal = Vec(n[0], n[1], n[2]);
+	return true;
+}
+
+///
+//  Surface point under the nearest covered pixel, from the distance transform.
+///
+bool EDSketchEngine::raster_nearest(float px, float py, Vec & p_on_mesh) const
+{
+	if (!raster_cache.valid || raster_cache.distance.empty()) return false;
+
+	auto & nearest = raster_cache.distance.nearest_at(static_cast<int>(px), static_cast<int>(py));
+	if (nearest.triangle == EDRasterizer::kNoTriangle) return false;
+
+	auto x = static_cast<float>(nearest.x), y = static_cast<float>(nearest.y);
+	Vec origin, direction;
+	view.ray(x, y, origin, direction);
+	return raster_hit(x, y, origin, direction, p_on_mesh);
+}
+
+EDSketchEngine::Vec EDSketchEngine::find_point_nearest_to_mesh(const Vec & origin, const Vec & direction, float px, float py, float & height)
+{
+	if (surface_set.empty())
+	{
+		return origin;
+	}
+
+	Vec p_on_mesh;
+	if (!raster_nearest(px, py, p_on_mesh))
+	{
+		if (!ensure_kd() || kd_vertices.empty())
+		{
+			return origin;
+		}
+
+		float pt[] = { px, py, 0 };
+		size_t out_index = 0;
+		float out_dist_squared = 0;
+		kd_2d->knnSearch(pt, 1, &out_index, &out_dist_squared);
+
+		// nearest point (I am just using vertex for now) on the mesh
+		auto & vertex = kd_vertices[out_index];
+		auto & mesh = surface_set[vertex.first].mesh();
+		p_on_mesh = Vec(mesh.x[vertex.second], mesh.y[vertex.second], mesh.z[vertex.second]);
+	}
+
+	auto dist = Ops::dot(direction, p_on_mesh - origin);
+	if (dist < 0)
+	{
+		return origin;
+	}
+
+	auto p_on_ray = origin + direction * dist;
+	height = static_cast<float>(length(p_on_ray - p_on_mesh));
+	return p_on_ray;
+}
+
+///
+//  Height of p above the selected mesh nearest it, along the normal of the
+//  nearest vertex; 0 with no mesh.
+///
+float EDSketchEngine::height_above(const Vec & p)
+{
+	float q[3], height, foot[3];
+	to_floats(p, q);
+	auto s = surface_set.nearest(q);
+	if (s < 0 || !surface_set[s].height_above(q, height, foot)) return 0;
+	return height;
+}
+
+void EDSketchEngine::project_normal(const Stroke & stroke, const EDRayBatch & rays, const std::vector<int> & hit_surface, Result & result)
+{
+	auto & points = result.points;
+	if (result.hits[0])
+	{
+		Vec surface_normal;
+		if (!surface_normal_at(stroke.px[0], stroke.py[0], points[0], hit_surface[0], surface_normal))
+		{
+			return;
+		}
+		surface_normal = Ops::normalized(surface_normal);
+
+		auto plane = EDMath::normal_plane(points[0], surface_normal, direction_at(rays, 0));
+		result.projection.set_plane(plane.point, plane.normal);
+		project_rays(rays, 0, rays.size(), plane.point, plane.normal, points);
+	}
+	// todo: last hit
+}
+
+void EDSketchEngine::project_contour(const Stroke & stroke, const EDRayBatch & rays, Result & result)
+{
+	// TODO: with shape matching
+	// TODO: find nearest point on mesh, not vertex
+	auto & points = result.points;
+	auto length = rays.size();
+	float dummy;
+	auto s0 = stroke.start_known ? points[0]
+		: find_point_nearest_to_mesh(origin_at(rays, 0), direction_at(rays, 0), stroke.px[0], stroke.py[0], dummy);
+	auto sn = stroke.end_known ? points[length - 1]
+		: find_point_nearest_to_mesh(origin_at(rays, length - 1), direction_at(rays, length - 1), stroke.px[length - 1], stroke.py[length - 1], dummy);
+
+	EDMath::Plane<Vec, Vec> plane;
+	if (!EDMath::contour_plane(s0, sn, direction_at(rays, 0), plane)) return;
+
+	points[0] = s0;
+	points[length - 1] = sn;
+	result.projection.set_plane(plane.point, plane.normal);
+	project_rays(rays, 1, length - 1, plane.point, plane.normal, points);
+}
+
+///
+//  Shell projection. The height fields of the surfaces must hold the known
+//  heights (anchors, other curves) before this runs.
+///
+void EDSketchEngine::project_shell(const Stroke & stroke, const EDRayBatch & rays, const std::vector<int> & hit_surface, Result & result)
+{
+	auto & points = result.points;
+	auto & hits = result.hits;
+	auto length = rays.size();
+	float start_height = 0, end_height = 0;
+
+	if (!hits[0] && !stroke.start_known)
+	{
+		points[0] = find_point_nearest_to_mesh(origin_at(rays, 0), direction_at(rays, 0), stroke.px[0], stroke.py[0], start_height);
+	}
+	start_height = height_above(points[0]);
+
+	if (!hits[length - 1] && !stroke.end_known)
+	{
+		points[length - 1] = find_point_nearest_to_mesh(origin_at(rays, length - 1), direction_at(rays, length - 1),
+			stroke.px[length - 1], stroke.py[length - 1], end_height);
+	}
+	end_height = height_above(points[length - 1]);
+
+	// heights are kept for oversketching; misses get theirs filled in below
+	auto & heights = result.projection.heights;
+	heights.assign(length, -1.0f);
+	heights[0] = start_height;
+	heights[length - 1] = end_height;
+
+	// every hit takes its height from all known ones around it on the mesh
+	// it hit. The stroke's own ends are weighed by distance along the body
+	// when both lie on that mesh and it can be had, so heights do not leak
+	// across an armpit or between the legs.
+	float end_heights[] = { start_height, end_height };
+	float p0[3], pn[3];
+	to_floats(points[0], p0);
+	to_floats(points[length - 1], pn);
+	int v0 = -1, vn = -1;
+	auto end_surface = surface_set.nearest(p0, &v0);
+	auto geo = end_surface >= 0 && surface_set.nearest(pn, &vn) == end_surface ? surface_set[end_surface].geodesics() : nullptr;
+	std::vector<float> from_start, from_end;
+	bool along_surface = geo && geo->distances(v0, from_start) && geo->distances(vn, from_end);
+	for (size_t i = 1; i + 1 < length; i++)
+	{
+		if (!hits[i]) continue;
+
+		auto & surface = surface_set[hit_surface[i]];
+		float p[3];
+		to_floats(points[i], p);
+		float end_distances[2];
+		auto v = along_surface && hit_surface[i] == end_surface ? surface.nearest_vertex(p) : -1;
+		if (v >= 0)
+		{
+			end_distances[0] = from_start[v];
+			end_distances[1] = from_end[v];
+		}
+		else
+		{
+			end_distances[0] = static_cast<float>(::length(points[i] - points[0]));
+			end_distances[1] = static_cast<float>(::length(points[i] - points[length - 1]));
+		}
+		surface.heights().evaluate(p, heights[i], end_heights, end_distances, 2);
+	}
+	cast_shell(rays, hit_surface, heights, points);
+
+	// the hits and ends are final now, so every miss run can go in one batch
+	project_misses(rays, hits, points);
+
+	for (size_t i = 1; i + 1 < length; i++)
+	{
+		if (heights[i] >= 0) continue;
+
+		size_t next = i;
+		while (heights[next] < 0) next++;
+		for (size_t j = i; j < next; j++)
+		{
+			float t = static_cast<float>(j - i + 1) / static_cast<float>(next - i + 1);
+			heights[j] = (1 - t) * heights[i - 1] + t * heights[next];
+		}
+		i = next;
+	}
+}
+
+///
+//  Moves every hit sample onto the surface pushed out by its height, on
+//  the mesh it hit. The shells of each mesh cover only its rings within
+//  reach of the stroke (the vertices under its hits there, grown by twice
+//  the largest height) and are cached per height level, so the whole stroke
+//  costs one batch of BVH ray casts. Rays that miss the shell step back
+//  from the surface along the ray instead.
+///
+void EDSketchEngine::cast_shell(const EDRayBatch & rays, const std::vector<int> & hit_surface, const std::vector<float> & heights, std::vector<Vec> & points)
+{
+	std::vector<std::vector<size_t>> groups(surface_set.size());
+	for (size_t i = 1; i + 1 < points.size(); i++)
+	{
+		if (hit_surface[i] >= 0) groups[hit_surface[i]].push_back(i);
+	}
+
+	std::vector<size_t> samples;
+	for (size_t s = 0; s < groups.size(); s++)
+	{
+		auto & group = groups[s];
+		if (group.empty()) continue;
+
+		auto & surface = surface_set[s];
+		std::vector<int> seeds;
+		std::vector<float> group_heights;
+		float reach = 0;
+		for (auto i : group)
+		{
+			float p[3];
+			to_floats(points[i], p);
+			auto v = surface.nearest_vertex(p);
+			if (v >= 0) seeds.push_back(v);
+			group_heights.push_back(heights[i]);
+			reach = std::max(reach, 2 * heights[i]);
+		}
+		std::sort(seeds.begin(), seeds.end());
+		seeds.erase(std::unique(seeds.begin(), seeds.end()), seeds.end());
+		auto & adj = surface.adjacency();
+		if (!adj.empty() && adj.mean_edge_length() > 0)
+		{
+			int rings = static_cast<int>(std::ceil(reach / adj.mean_edge_length())) + 1;
+			surface.shells().set_patch(surface.mesh(), adj, seeds, rings);
+			surface.shells().prepare(group_heights);
+		}
+		samples.insert(samples.end(), group.begin(), group.end());
+	}
+	if (samples.empty()) return;
+
+	const EDSurfaceSet & set = surface_set;
+	EDParallel::for_each_index(samples.size(), [&](size_t k)
+	{
+		auto i = samples[k];
+		float origin[] = { rays.ox[i], rays.oy[i], rays.oz[i] };
+		float direction[] = { rays.dx[i], rays.dy[i], rays.dz[i] };
+		float t;
+		if (set[hit_surface[i]].shells().intersect(heights[i], origin, direction, t))
+			points[i] = origin_at(rays, i) + direction_at(rays, i) * static_cast<double>(t);
+		else
+			points[i] = EDMath::lift(points[i], direction_at(rays, i), static_cast<double>(heights[i]));
+	});
+}
+
+///
+//  Mean vertex normal under the stroke's hits, each hit looking only at a
+//  small ball around itself (the spacing between hits) on the mesh it hit
+//  and weighing normals by how squarely they face its ray. Meshes count by
+//  how many hits landed on them.
+///
+bool EDSketchEngine::estimate_tangent_normal(const std::vector<Vec> & points, const std::vector<int> & hit_surface, const EDRayBatch & rays, Vec & normal)
+{
+	std::vector<std::vector<float>> hits(surface_set.size() * 6);
+	double spacing = 0;
+	size_t count = 0;
+	const Vec * previous = nullptr;
+	for (size_t i = 0; i < points.size(); i++)
+	{
+		auto s = hit_surface[i];
+		if (s < 0) continue;
+
+		auto & p = points[i];
+		float values[] = { static_cast<float>(p.x), static_cast<float>(p.y), static_cast<float>(p.z), rays.dx[i], rays.dy[i], rays.dz[i] };
+		for (int k = 0; k < 6; k++) hits[s * 6 + k].push_back(values[k]);
+		if (previous) spacing += length(p - *previous);
+		previous = &p;
+		count++;
+	}
+	if (count == 0) return false;
+
+	auto radius = count > 1 ? static_cast<float>(spacing / (count - 1)) : 0.0f;
+	Vec sum(0, 0, 0);
+	for (size_t s = 0; s < surface_set.size(); s++)
+	{
+		auto h = &hits[s * 6];
+		float n[3];
+		if (h[0].empty() || !surface_set[s].tangents().stroke_normal(h[0].data(), h[1].data(), h[2].data(), h[3].data(), h[4].data(), h[5].data(),
+			h[0].size(), radius, n))
+		{
+			continue;
+		}
+		sum = sum + Vec(n[0], n[1], n[2]) * static_cast<double>(h[0].size());
+	}
+	if (length(sum) == 0) return false;
+
+	normal = Ops::normalized(sum);
+	return true;
+}
+
+void EDSketchEngine::project_tangent(const Stroke & stroke, const EDRayBatch & rays, const std::vector<int> & hit_surface, Result & result)
+{
+	auto & points = result.points;
+	auto length = rays.size();
+
+	//determine the height of the tangent plane and the middle point on that plane
+	//assume the average height is the height of the middle point
+	float h = 0.0;
+	auto mid_index = length / 2;
+	find_point_nearest_to_mesh(origin_at(rays, mid_index), direction_at(rays, mid_index), stroke.px[mid_index], stroke.py[mid_index], h);
+
+	//average the surface normals under the stroke: one radius query around the hits
+	Vec plane_normal;
+	if (!estimate_tangent_normal(points, hit_surface, rays, plane_normal))
+	{
+		// normal of the nearest vertex on the nearest selected mesh
+		Vec sum_normal(0, 0, 0);
+		for (size_t i = 0; i < length; i++)
+		{
+			float p[3], n[3];
+			to_floats(points[i], p);
+			auto s = surface_set.nearest(p);
+			if (s >= 0 && surface_set[s].tangents().nearest_normal(p, n))
+			{
+				sum_normal = sum_normal + Vec(n[0], n[1], n[2]);
+			}
+		}
+		// facing the camera when the normals cancel out
+		plane_normal = ::length(sum_normal) > 0 ? Ops::normalized(sum_normal) : -direction_at(rays, mid_index);
+	}
+	auto plane = EDMath::tangent_plane(points[mid_index], direction_at(rays, mid_index), static_cast<double>(h), plane_normal);
+	result.projection.set_plane(plane.point, plane.normal);
+	//project all the point on to the tangent plane
+	project_rays(rays, 0, length, plane.point, plane.normal, points);
+}
+
+///
+//  Indexes only the vertices that can matter for this stroke: inside its
+//  screen bounds grown by kd_roi_margin, facing the camera and, when the
+//  raster is on, not hidden behind other parts of the mesh. Vertices of
+//  every selected mesh go in. Falls back to every vertex in the port when
+//  nothing is close to the stroke.
+///
+void EDSketchEngine::rebuild_kd()
+{
+	kd_vertices.clear();
+	mesh_pts_2d.clear();
+	size_t total = 0;
+	for (size_t s = 0; s < surface_set.size(); s++)
+	{
+		total += surface_set[s].mesh().vertex_count();
+	}
+	if (total == 0)
+	{
+		kd_2d = nullptr;
+		return;
+	}
+
+	auto count = surface_set.size();
+	std::vector<std::vector<float>> screen_x(count), screen_y(count), screen_z(count);
+	for (size_t s = 0; s < count; s++)
+	{
+		auto & mesh = surface_set[s].mesh();
+		auto length = mesh.vertex_count();
+		screen_x[s].resize(length);
+		screen_y[s].resize(length);
+		screen_z[s].resize(length);
+		EDRays::to_port(view.view_projection, view.width, view.height, mesh.x.data(), mesh.y.data(), mesh.z.data(), length,
+			screen_x[s].data(), screen_y[s].data(), screen_z[s].data());
+	}
+
+	// the camera centre is what clip space (0, 0, 1, 0) comes back to: a point
+	// for perspective views, the viewing direction itself (w = 0) for orthographic ones
+	auto & center = view.inverse[2];
+	bool perspective = std::abs(center[3]) > 1e-12;
+	Vec eye_offset(center[0], center[1], center[2]);
+	if (perspective) eye_offset = eye_offset / center[3];
+	auto eye_direction = [&](const EDMeshSnapshot & mesh, size_t i)
+	{
+		return perspective ? Vec(mesh.x[i], mesh.y[i], mesh.z[i]) - eye_offset : eye_offset;
+	};
+
+	auto collect = [&](float x0, float y0, float x1, float y1, bool cull)
+	{
+		for (size_t s = 0; s < count; s++)
+		{
+			auto & mesh = surface_set[s].mesh();
+			for (size_t i = 0; i < mesh.vertex_count(); i++)
+			{
+				// behind the camera
+				auto x = screen_x[s][i], y = screen_y[s][i];
+				if (std::isnan(x)) continue;
+				if (x < x0 || x > x1 || y < y0 || y > y1) continue;
+				if (cull && !vertex_visible(&mesh.vertex_normals[i * 3], eye_direction(mesh, i), x, y, screen_z[s][i])) continue;
+
+				kd_vertices.push_back(std::make_pair(static_cast<int>(s), static_cast<unsigned>(i)));
+				mesh_pts_2d.pts.push_back(EDMath::PointCloud<float>::Point(x, y, 0));
+			}
+		}
+	};
+
+	collect(roi[0] - kd_roi_margin, roi[1] - kd_roi_margin, roi[2] + kd_roi_margin, roi[3] + kd_roi_margin, true);
+	if (kd_vertices.empty())
+	{
+		collect(0, 0, static_cast<float>(view.width), static_cast<float>(view.height), true);
+	}
+	if (kd_vertices.empty())
+	{
+		collect(-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(),
+			std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), false);
+	}
+
+	kd_2d.reset(new EDMath::KDTree2D(2 /*dim*/, mesh_pts_2d, nanoflann::KDTreeSingleIndexAdaptorParams(10)));
+	kd_2d->buildIndex();
+}
+
+///
+//  Only contour strokes, shell strokes with off-mesh ends and tangent
+//  strokes look up the nearest vertex; everything else never pays for the
+//  index. Built once per stroke and shared by all lookups in it.
+///
+bool EDSketchEngine::ensure_kd()
+{
+	if (kd_stale)
+	{
+		rebuild_kd();
+		kd_stale = false;
+	}
+	return kd_2d != nullptr;
+}
+
+bool EDSketchEngine::vertex_visible(const float * normal, const Vec & eye_direction, float x, float y, float z) const
+{
+	if (eye_direction.x * normal[0] + eye_direction.y * normal[1] + eye_direction.z * normal[2] > 0)
+	{
+		return false;
+	}
+
+	if (!raster_cache.valid)
+	{
+		return true;
+	}
+
+	// occluded if it is behind everything drawn around its pixel
+	const float depth_tolerance = 1e-3f;
+	float farthest = -std::numeric_limits<float>::max();
+	int px = static_cast<int>(x), py = static_cast<int>(y);
+	for (int dy = -1; dy <= 1; dy++)
+	{
+		for (int dx = -1; dx <= 1; dx++)
+		{
+			if (raster_cache.raster.triangle_at(px + dx, py + dy) == EDRasterizer::kNoTriangle) continue;
+			farthest = std::max(farthest, raster_cache.raster.depth_at(px + dx, py + dy));
+		}
+	}
+	return farthest == -std::numeric_limits<float>::max() || z <= farthest + depth_tolerance;
+}
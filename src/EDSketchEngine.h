@@ -0,0 +1,207 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+// Stroke classification and projection, shared by the plugin and the driver.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include "EDDistanceTransform.h"
+#include "EDMath.h"
+#include "EDMathCore.h"
+#include "EDProjection.h"
+#include "EDRasterizer.h"
+#include "EDRays.h"
+#include "EDSceneBvh.h"
+#include "EDSurface.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+///
+//  The view a stroke is drawn in: the view-projection with row vectors as
+//  in Maya, its inverse, and the port size in pixels.
+///
+struct EDCamera
+{
+	double view_projection[4][4];
+	double inverse[4][4];
+	int width = 0;
+	int height = 0;
+
+	// port pixels, origin at the bottom left, and NDC depth; false behind the camera
+	bool to_port(const EDVec3<double> & p, float & x, float & y, float & z) const;
+	// the ray through a port pixel, as EDRayBatch::generate casts it
+	void ray(float px, float py, EDVec3<double> & origin, EDVec3<double> & direction) const;
+	bool same_view(const EDCamera & other) const;
+};
+
+///
+//  The selected mesh rasterized for one view, plus what is needed to turn a
+//  covered pixel back into an exact hit on its triangle. Only built while
+//  a single mesh is selected.
+///
+struct EDRasterCache
+{
+	EDRasterizer raster;
+	// nearest covered pixel for off-mesh samples
+	EDDistanceTransform distance;
+	EDCamera camera;
+	// surfaces revision it was built from
+	unsigned mesh_revision = 0;
+	bool valid = false;
+};
+
+///
+//  Everything between a screen stroke and its world points: hit tests
+//  against the selected meshes and the generated layers, the choice of
+//  strategy (contour, normal plane, tangent plane or shell) and the
+//  projection itself. The caller keeps the surfaces and the scene BVH up
+//  to date, and the height fields when shells are drawn; the plugin does
+//  it from Maya, the driver from a mesh file.
+///
+class EDSketchEngine
+{
+public:
+	typedef EDVec3<double> Vec;
+
+	enum Strategy
+	{
+		kUnprojected,
+		kContour,
+		kNormalPlane,
+		kTangentPlane,
+		kShell,
+	};
+
+	struct Stroke
+	{
+		// port pixels of the samples, origin at the bottom left
+		std::vector<float> px, py;
+		// ends that must land on known points, such as anchors
+		bool start_known = false;
+		bool end_known = false;
+		Vec start_point;
+		Vec end_point;
+		// forced with the modifier keys
+		bool tangent_mode = false;
+		bool normal_mode = false;
+
+		size_t size() const { return px.size(); }
+	};
+
+	struct Result
+	{
+		Strategy strategy = kUnprojected;
+		std::vector<Vec> points;
+		// which samples hit a surface
+		std::vector<bool> hits;
+		EDProjectionData projection;
+	};
+
+	EDSurfaceSet & surfaces() { return surface_set; }
+	const EDSurfaceSet & surfaces() const { return surface_set; }
+	// the selected meshes plus the surfaces and volumes generated on them
+	EDSceneBvh & scene() { return scene_bvh; }
+	const EDSceneBvh & scene() const { return scene_bvh; }
+
+	void set_camera(const EDCamera & camera) { view = camera; }
+	const EDCamera & camera() const { return view; }
+	// which surface along the ray strokes land on, 0 being the front one
+	void set_layer(int layer) { stroke_layer = std::max(layer, 0); }
+	int layer() const { return stroke_layer; }
+	// hit tests against a per-view raster of the mesh instead of ray casts
+	void set_raster_hit_test(bool enabled);
+	bool raster_hit_test() const { return raster_enabled; }
+	// call once the surfaces and the camera are set for a stroke
+	void update_raster();
+
+	///
+	//  Classifies the stroke and projects it. False with no surface or
+	//  fewer than three samples.
+	///
+	bool project(const Stroke & stroke, Result & result);
+
+	///
+	//  Projects a stroke redrawing part of a curve, with both ends known.
+	//  A curve projected on a plane keeps it; one projected on the body
+	//  keeps its heights, blended from h0 at the start to h1 at the end.
+	//  The heights of the span go in result.projection; the strategy is
+	//  kShell on the body and left kUnprojected on a plane.
+	///
+	bool project_span(const Stroke & stroke, const EDProjectionData & old, float h0, float h1, Result & result);
+
+	// camera rays for every sample, from one inverse view-projection
+	void make_rays(const Stroke & stroke, EDRayBatch & rays) const;
+	///
+	//  The surface under a sample on the stroke layer. surface is the
+	//  selected mesh the hit is measured on: the one hit, or for a hit on a
+	//  generated layer the one nearest the hit point.
+	///
+	bool hit_test(float px, float py, const Vec & origin, const Vec & direction, Vec & hit_point, int & surface);
+
+private:
+	bool is_normal(const Stroke & stroke, const std::vector<Vec> & points, const std::vector<bool> & hits, const std::vector<int> & hit_surface);
+	bool cast_ray(const Vec & origin, const Vec & direction, Vec & hit_point, int & surface);
+	bool layer_hit(const float origin[3], const float direction[3], EDSceneBvh::Hit & hit) const;
+	bool raster_hit(float px, float py, const Vec & origin, const Vec & direction, Vec & hit_point) const;
+	bool raster_normal(float px, float py, Vec & normal) const;
+	bool surface_normal_at(float px, float py, const Vec & p, int surface, Vec & normal);
+	bool raster_nearest(float px, float py, Vec & p_on_mesh) const;
+	Vec find_point_nearest_to_mesh(const Vec & origin, const Vec & direction, float px, float py, float & height);
+	float height_above(const Vec & p);
+
+	void project_normal(const Stroke & stroke, const EDRayBatch & rays, const std::vector<int> & hit_surface, Result & result);
+	void project_tangent(const Stroke & stroke, const EDRayBatch & rays, const std::vector<int> & hit_surface, Result & result);
+	void project_contour(const Stroke & stroke, const EDRayBatch & rays, Result & result);
+	void project_shell(const Stroke & stroke, const EDRayBatch & rays, const std::vector<int> & hit_surface, Result & result);
+	void cast_shell(const EDRayBatch & rays, const std::vector<int> & hit_surface, const std::vector<float> & heights, std::vector<Vec> & points);
+	bool estimate_tangent_normal(const std::vector<Vec> & points, const std::vector<int> & hit_surface, const EDRayBatch & rays, Vec & normal);
+
+	void rebuild_kd();
+	bool ensure_kd();
+	// eye_direction runs from the camera towards the vertex, any length
+	bool vertex_visible(const float * normal, const Vec & eye_direction, float x, float y, float z) const;
+
+	EDSurfaceSet surface_set;
+	EDSceneBvh scene_bvh;
+	EDCamera view;
+	int stroke_layer = 0;
+
+	bool raster_enabled = false;
+	EDRasterCache raster_cache;
+
+	double normal_threshold = 0.15;
+	int tang_samples = 3;
+
+	// visible vertices around the stroke: surface and snapshot indices, and screen positions
+	std::vector<std::pair<int, unsigned>> kd_vertices;
+	EDMath::PointCloud<float> mesh_pts_2d;
+	// screen bounds of the stroke being projected, grown by kd_roi_margin
+	float roi[4];
+	float kd_roi_margin = 64;
+
+	// kd tree for finding the nearest point on the meshes, built on first use for each stroke
+	std::unique_ptr<EDMath::KDTree2D> kd_2d = nullptr;
+	bool kd_stale = true;
+};
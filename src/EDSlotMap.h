@@ -0,0 +1,162 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+// Slot map: dense storage with stable handles.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+///
+//  Generation-checked handle. A handle to a removed element stays invalid
+//  even after its slot is reused.
+///
+struct EDHandle
+{
+	uint32_t index = 0;
+	uint32_t generation = 0; // 0 is never issued
+
+	EDHandle() = default;
+	EDHandle(uint32_t index, uint32_t generation) : index(index), generation(generation) {}
+
+	bool valid() const { return generation != 0; }
+	bool operator==(const EDHandle & o) const { return index == o.index && generation == o.generation; }
+	bool operator!=(const EDHandle & o) const { return !(*this == o); }
+
+	// for storing in plain integer ids (e.g. graph edges)
+	uint64_t pack() const { return (static_cast<uint64_t>(generation) << 32) | index; }
+	static EDHandle unpack(uint64_t v) { return EDHandle(static_cast<uint32_t>(v), static_cast<uint32_t>(v >> 32)); }
+};
+
+///
+//  Values are kept packed in one vector for iteration; removal swaps the
+//  last value into the hole. Lookup by handle goes through a slot table,
+//  so insert, remove and get are all O(1).
+///
+template <typename T>
+class EDSlotMap
+{
+public:
+	typedef typename std::vector<T>::iterator iterator;
+	typedef typename std::vector<T>::const_iterator const_iterator;
+
+	EDHandle insert(const T & value)
+	{
+		uint32_t slot;
+		if (!free_slots.empty())
+		{
+			slot = free_slots.back();
+			free_slots.pop_back();
+		}
+		else
+		{
+			slot = static_cast<uint32_t>(slots.size());
+			slots.push_back(Slot());
+		}
+
+		slots[slot].dense = static_cast<uint32_t>(values.size());
+		values.push_back(value);
+		dense_to_slot.push_back(slot);
+		return EDHandle(slot, slots[slot].generation);
+	}
+
+	bool remove(EDHandle h)
+	{
+		if (!contains(h)) return false;
+
+		auto hole = slots[h.index].dense;
+		auto last = static_cast<uint32_t>(values.size() - 1);
+		if (hole != last)
+		{
+			values[hole] = values[last];
+			dense_to_slot[hole] = dense_to_slot[last];
+			slots[dense_to_slot[hole]].dense = hole;
+		}
+		values.pop_back();
+		dense_to_slot.pop_back();
+
+		// bump the generation so old handles fail, skipping 0
+		if (++slots[h.index].generation == 0) slots[h.index].generation = 1;
+		slots[h.index].dense = kFree;
+		free_slots.push_back(h.index);
+		return true;
+	}
+
+	bool contains(EDHandle h) const
+	{
+		return h.valid() && h.index < slots.size()
+			&& slots[h.index].generation == h.generation && slots[h.index].dense != kFree;
+	}
+
+	T * get(EDHandle h) { return contains(h) ? &values[slots[h.index].dense] : nullptr; }
+	const T * get(EDHandle h) const { return contains(h) ? &values[slots[h.index].dense] : nullptr; }
+
+	// handle of the i-th value in iteration order
+	EDHandle handle_at(size_t i) const
+	{
+		auto slot = dense_to_slot[i];
+		return EDHandle(slot, slots[slot].generation);
+	}
+
+	void clear()
+	{
+		for (auto slot : dense_to_slot)
+		{
+			if (++slots[slot].generation == 0) slots[slot].generation = 1;
+			slots[slot].dense = kFree;
+			free_slots.push_back(slot);
+		}
+		values.clear();
+		dense_to_slot.clear();
+	}
+
+	void reserve(size_t n)
+	{
+		values.reserve(n);
+		dense_to_slot.reserve(n);
+		slots.reserve(n);
+	}
+
+	size_t size() const { return values.size(); }
+	bool empty() const { return values.empty(); }
+
+	iterator begin() { return values.begin(); }
+	iterator end() { return values.end(); }
+	const_iterator begin() const { return values.begin(); }
+	const_iterator end() const { return values.end(); }
+
+private:
+	static const uint32_t kFree = 0xffffffffu;
+
+	struct Slot
+	{
+		uint32_t dense = kFree;
+		uint32_t generation = 1;
+	};
+
+	std::vector<T> values;
+	std::vector<uint32_t> dense_to_slot;
+	std::vector<Slot> slots;
+	std::vector<uint32_t> free_slots;
+};
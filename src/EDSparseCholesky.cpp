@@ -0,0 +1,368 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+// Created: Oct 19, 2026
+
+#include "EDSparseCholesky.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// parts this small are numbered as they come
+	const size_t kLeafSize = 64;
+
+	///
+	//  George's automatic nested dissection. Every part is split into its
+	//  connected components; a connected part is split by the middle level
+	//  of a breadth-first search from a pseudo-peripheral node, keeping in
+	//  the separator only the middle-level vertices that touch the level
+	//  above. Both halves are numbered before the separator.
+	///
+	class Dissection
+	{
+	public:
+		Dissection(const std::vector<std::vector<int>> & adjacency, std::vector<int> & order)
+			: adjacency(adjacency), order(order), part(adjacency.size(), -1), level(adjacency.size(), -1)
+		{
+		}
+
+		void run()
+		{
+			order.clear();
+			order.reserve(adjacency.size());
+			std::vector<int> all(adjacency.size());
+			for (size_t i = 0; i < all.size(); i++) all[i] = static_cast<int>(i);
+			dissect(all);
+		}
+
+	private:
+		const std::vector<std::vector<int>> & adjacency;
+		std::vector<int> & order;
+		// which part a vertex was last handed to, and its level in that part
+		std::vector<int> part;
+		std::vector<int> level;
+		int next_part = 0;
+
+		// levels of the vertices of the part reachable from start; returns the last one reached
+		int search(int label, int start, std::vector<int> & reached)
+		{
+			reached.clear();
+			reached.push_back(start);
+			level[start] = 0;
+			for (size_t i = 0; i < reached.size(); i++)
+			{
+				auto v = reached[i];
+				for (auto w : adjacency[v])
+				{
+					if (part[w] != label || level[w] >= 0) continue;
+					level[w] = level[v] + 1;
+					reached.push_back(w);
+				}
+			}
+			return reached.back();
+		}
+
+		void dissect(std::vector<int> & vertices)
+		{
+			if (vertices.size() <= kLeafSize)
+			{
+				order.insert(order.end(), vertices.begin(), vertices.end());
+				return;
+			}
+
+			int label = next_part++;
+			for (auto v : vertices)
+			{
+				part[v] = label;
+				level[v] = -1;
+			}
+
+			std::vector<int> reached;
+			auto far_node = search(label, vertices[0], reached);
+			if (reached.size() < vertices.size())
+			{
+				// one part per component
+				std::vector<std::vector<int>> components(1, reached);
+				for (auto v : vertices)
+				{
+					if (level[v] >= 0) continue;
+					search(label, v, reached);
+					components.push_back(reached);
+				}
+				for (auto & component : components) dissect(component);
+				return;
+			}
+
+			// a node at the far end of the search starts one with more, narrower levels
+			for (auto v : vertices) level[v] = -1;
+			search(label, far_node, reached);
+
+			int levels = level[reached.back()] + 1;
+			if (levels < 3)
+			{
+				order.insert(order.end(), vertices.begin(), vertices.end());
+				return;
+			}
+
+			int middle = levels / 2;
+			std::vector<int> below, above, separator;
+			for (auto v : vertices)
+			{
+				if (level[v] < middle)
+				{
+					below.push_back(v);
+				}
+				else if (level[v] > middle)
+				{
+					above.push_back(v);
+				}
+				else
+				{
+					bool touches_above = false;
+					for (auto w : adjacency[v])
+					{
+						if (part[w] == label && level[w] > middle)
+						{
+							touches_above = true;
+							break;
+						}
+					}
+					(touches_above ? separator : below).push_back(v);
+				}
+			}
+			vertices.clear();
+			vertices.shrink_to_fit();
+
+			dissect(below);
+			dissect(above);
+			order.insert(order.end(), separator.begin(), separator.end());
+		}
+	};
+
+	///
+	//  Non-zero pattern of row k of L, from the upper column k of the
+	//  permuted matrix: every entry's path up the elimination tree, stopping
+	//  at nodes already on the pattern. Returned in pattern[top..n) in an
+	//  order where each node follows its descendants.
+	///
+	size_t row_pattern(int k, const std::vector<size_t> & column_start, const std::vector<int> & column_rows,
+		const std::vector<int> & parent, std::vector<int> & flag, std::vector<int> & path, std::vector<int> & pattern)
+	{
+		auto top = pattern.size();
+		flag[k] = k;
+		for (auto p = column_start[k]; p < column_start[k + 1]; p++)
+		{
+			int i = column_rows[p];
+			size_t length = 0;
+			for (; flag[i] != k; i = parent[i])
+			{
+				path[length++] = i;
+				flag[i] = k;
+			}
+			while (length > 0) pattern[--top] = path[--length];
+		}
+		return top;
+	}
+}
+
+void EDSparseCholesky::clear()
+{
+	column_start.clear();
+	rows.clear();
+	values.clear();
+	order.clear();
+	position.clear();
+}
+
+bool EDSparseCholesky::factor(size_t n, const std::vector<Entry> & entries, size_t max_entries)
+{
+	clear();
+	if (n == 0) return false;
+
+	std::vector<std::vector<int>> adjacency(n);
+	for (auto & e : entries)
+	{
+		if (e.row == e.col) continue;
+		adjacency[e.row].push_back(e.col);
+		adjacency[e.col].push_back(e.row);
+	}
+	for (auto & list : adjacency)
+	{
+		std::sort(list.begin(), list.end());
+		list.erase(std::unique(list.begin(), list.end()), list.end());
+	}
+
+	Dissection(adjacency, order).run();
+	adjacency.clear();
+	adjacency.shrink_to_fit();
+	position.resize(n);
+	for (size_t i = 0; i < n; i++) position[order[i]] = static_cast<int>(i);
+
+	// upper triangle of the permuted matrix by column, duplicates summed
+	std::vector<Entry> upper;
+	upper.reserve(entries.size());
+	for (auto & e : entries)
+	{
+		int r = position[e.row], c = position[e.col];
+		if (r > c) std::swap(r, c);
+		Entry u = { r, c, e.value };
+		upper.push_back(u);
+	}
+	std::sort(upper.begin(), upper.end(), [](const Entry & a, const Entry & b)
+	{
+		return a.col != b.col ? a.col < b.col : a.row < b.row;
+	});
+
+	std::vector<size_t> a_start(n + 1, 0);
+	std::vector<int> a_rows;
+	std::vector<double> a_values;
+	a_rows.reserve(upper.size());
+	a_values.reserve(upper.size());
+	for (size_t p = 0; p < upper.size(); p++)
+	{
+		if (p > 0 && upper[p].row == upper[p - 1].row && upper[p].col == upper[p - 1].col)
+		{
+			a_values.back() += upper[p].value;
+			continue;
+		}
+		a_rows.push_back(upper[p].row);
+		a_values.push_back(upper[p].value);
+		a_start[upper[p].col + 1]++;
+	}
+	upper.clear();
+	upper.shrink_to_fit();
+	for (size_t j = 0; j < n; j++) a_start[j + 1] += a_start[j];
+
+	// elimination tree, with path compression through ancestor
+	std::vector<int> parent(n, -1), ancestor(n, -1);
+	for (size_t uk = 0; uk < n; uk++)
+	{
+		int k = static_cast<int>(uk);
+		for (auto p = a_start[k]; p < a_start[k + 1]; p++)
+		{
+			for (int i = a_rows[p]; i != -1 && i < k;)
+			{
+				int next = ancestor[i];
+				ancestor[i] = k;
+				if (next == -1) parent[i] = k;
+				i = next;
+			}
+		}
+	}
+	ancestor.clear();
+	ancestor.shrink_to_fit();
+
+	// column counts from the row patterns
+	std::vector<int> flag(n, -1), path(n), pattern(n);
+	std::vector<size_t> count(n, 1);
+	size_t total = n;
+	for (size_t uk = 0; uk < n; uk++)
+	{
+		int k = static_cast<int>(uk);
+		auto top = row_pattern(k, a_start, a_rows, parent, flag, path, pattern);
+		for (auto t = top; t < n; t++) count[pattern[t]]++;
+		total += n - top;
+		if (total > max_entries)
+		{
+			clear();
+			return false;
+		}
+	}
+
+	column_start.resize(n + 1);
+	column_start[0] = 0;
+	for (size_t j = 0; j < n; j++) column_start[j + 1] = column_start[j] + count[j];
+	rows.resize(total);
+	values.resize(total);
+
+	// row k of L by a sparse triangular solve against the columns before it;
+	// every column fills in order, so its diagonal comes first
+	auto & next_free = count;
+	std::copy(column_start.begin(), column_start.end() - 1, next_free.begin());
+	std::fill(flag.begin(), flag.end(), -1);
+	std::vector<double> x(n, 0.0);
+	for (size_t uk = 0; uk < n; uk++)
+	{
+		int k = static_cast<int>(uk);
+		auto top = row_pattern(k, a_start, a_rows, parent, flag, path, pattern);
+		for (auto p = a_start[k]; p < a_start[k + 1]; p++) x[a_rows[p]] = a_values[p];
+
+		double d = x[k];
+		x[k] = 0;
+		for (auto t = top; t < n; t++)
+		{
+			int i = pattern[t];
+			double l = x[i] / values[column_start[i]];
+			x[i] = 0;
+			for (auto p = column_start[i] + 1; p < next_free[i]; p++)
+			{
+				x[rows[p]] -= values[p] * l;
+			}
+			d -= l * l;
+			auto p = next_free[i]++;
+			rows[p] = k;
+			values[p] = l;
+		}
+		if (!(d > 0))
+		{
+			clear();
+			return false;
+		}
+		auto p = next_free[k]++;
+		rows[p] = k;
+		values[p] = std::sqrt(d);
+	}
+	return true;
+}
+
+void EDSparseCholesky::solve(std::vector<double> & b) const
+{
+	auto n = order.size();
+	if (empty() || b.size() != n) return;
+
+	std::vector<double> y(n);
+	for (size_t i = 0; i < n; i++) y[i] = b[order[i]];
+
+	// L y' = y, a column at a time
+	for (size_t j = 0; j < n; j++)
+	{
+		y[j] /= values[column_start[j]];
+		for (auto p = column_start[j] + 1; p < column_start[j + 1]; p++)
+		{
+			y[rows[p]] -= values[p] * y[j];
+		}
+	}
+
+	// L^T x = y', walking the columns backwards
+	for (size_t j = n; j-- > 0;)
+	{
+		for (auto p = column_start[j] + 1; p < column_start[j + 1]; p++)
+		{
+			y[j] -= values[p] * y[rows[p]];
+		}
+		y[j] /= values[column_start[j]];
+	}
+
+	for (size_t i = 0; i < n; i++) b[order[i]] = y[i];
+}
@@ -0,0 +1,73 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+// Sparse Cholesky factorization with a nested dissection ordering.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+///
+//  Factors a sparse symmetric positive definite matrix once and solves for
+//  any number of right-hand sides by back-substitution. Rows are reordered
+//  by nested dissection: each connected part is split by the middle level of
+//  a breadth-first search from a far node, and the separator is numbered
+//  after both halves, so fill on a surface mesh stays near n log n. The
+//  factor is computed row by row up the elimination tree and kept by column.
+//
+//  EDEnvelopeCholesky remains the better fit for banded systems.
+///
+class EDSparseCholesky
+{
+public:
+	struct Entry
+	{
+		int row;
+		int col;
+		double value;
+	};
+
+	// entries may repeat (they are summed) and need only one triangle;
+	// false if the matrix is not positive definite or the factor would hold
+	// more than max_entries non-zeros
+	bool factor(size_t n, const std::vector<Entry> & entries, size_t max_entries);
+	void clear();
+
+	bool empty() const { return column_start.empty(); }
+	size_t size() const { return order.size(); }
+	size_t factor_size() const { return values.size(); }
+
+	// solves A x = b in place
+	void solve(std::vector<double> & b) const;
+
+private:
+	// column j of L holds rows[column_start[j] .. column_start[j + 1]), diagonal first
+	std::vector<size_t> column_start;
+	std::vector<int> rows;
+	std::vector<double> values;
+	// permuted index -> original index, and back
+	std::vector<int> order;
+	std::vector<int> position;
+};
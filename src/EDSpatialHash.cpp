@@ -0,0 +1,97 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+// Created: Oct 19, 2026
+
+#include "EDSpatialHash.h"
+
+#include <algorithm>
+#include <cmath>
+
+void EDSpatialHash::reset(double new_cell_size)
+{
+	cell_size = new_cell_size > 0 ? new_cell_size : 1.0;
+	cells.clear();
+}
+
+int64_t EDSpatialHash::cell_of(double v) const
+{
+	return static_cast<int64_t>(std::floor(v / cell_size));
+}
+
+uint64_t EDSpatialHash::key_of(int64_t ix, int64_t iy, int64_t iz)
+{
+	// 21 bits per axis is plenty for a sketch
+	const uint64_t mask = (1ull << 21) - 1;
+	return (static_cast<uint64_t>(ix) & mask)
+		| ((static_cast<uint64_t>(iy) & mask) << 21)
+		| ((static_cast<uint64_t>(iz) & mask) << 42);
+}
+
+void EDSpatialHash::insert(size_t id, double x, double y, double z)
+{
+	Entry entry = { id, x, y, z };
+	cells[key_of(cell_of(x), cell_of(y), cell_of(z))].push_back(entry);
+}
+
+void EDSpatialHash::remove(size_t id, double x, double y, double z)
+{
+	auto it = cells.find(key_of(cell_of(x), cell_of(y), cell_of(z)));
+	if (it == cells.end()) return;
+
+	auto & list = it->second;
+	list.erase(std::remove_if(list.begin(), list.end(), [id](const Entry & e) { return e.id == id; }), list.end());
+	if (list.empty())
+	{
+		cells.erase(it);
+	}
+}
+
+bool EDSpatialHash::find_nearest(double x, double y, double z, double radius, size_t & out_id) const
+{
+	auto cx = cell_of(x);
+	auto cy = cell_of(y);
+	auto cz = cell_of(z);
+
+	double best = radius * radius;
+	bool found = false;
+	for (int64_t dz = -1; dz <= 1; dz++)
+	for (int64_t dy = -1; dy <= 1; dy++)
+	for (int64_t dx = -1; dx <= 1; dx++)
+	{
+		auto it = cells.find(key_of(cx + dx, cy + dy, cz + dz));
+		if (it == cells.end()) continue;
+
+		for (auto & e : it->second)
+		{
+			auto d0 = e.x - x;
+			auto d1 = e.y - y;
+			auto d2 = e.z - z;
+			auto d = d0 * d0 + d1 * d1 + d2 * d2;
+			if (d <= best)
+			{
+				best = d;
+				out_id = e.id;
+				found = true;
+			}
+		}
+	}
+	return found;
+}
@@ -0,0 +1,66 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+// 3D hash grid for welding nearby points.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+///
+//  Uniform grid hashed by cell. With the cell size at least the query
+//  radius, a query only visits the 27 cells around the point: O(1)
+//  expected for insert, remove and nearest lookups.
+///
+class EDSpatialHash
+{
+public:
+	explicit EDSpatialHash(double cell_size = 1.0) : cell_size(cell_size) {}
+
+	void reset(double new_cell_size);
+	void clear() { cells.clear(); }
+
+	void insert(size_t id, double x, double y, double z);
+	void remove(size_t id, double x, double y, double z);
+
+	///
+	//  Nearest stored id within radius of (x, y, z).
+	//  radius should not exceed the cell size.
+	///
+	bool find_nearest(double x, double y, double z, double radius, size_t & out_id) const;
+
+private:
+	struct Entry
+	{
+		size_t id;
+		double x, y, z;
+	};
+
+	int64_t cell_of(double v) const;
+	static uint64_t key_of(int64_t ix, int64_t iy, int64_t iz);
+
+	double cell_size;
+	std::unordered_map<uint64_t, std::vector<Entry>> cells;
+};
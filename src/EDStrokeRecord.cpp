@@ -0,0 +1,41 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// Created: Oct 19, 2026
+
+#include "EDStrokeRecord.h"
+
+size_t EDStrokeRecord::memory_size() const
+{
+	size_t size = sizeof(EDStrokeRecord);
+	size += screen_xy.capacity() * sizeof(short);
+	size += world_points.capacity() * sizeof(MPoint);
+	size += projection.heights.capacity() * sizeof(float);
+	size += replaced_samples.capacity() * sizeof(MPoint);
+	size += replaced_projection.heights.capacity() * sizeof(float);
+	size += shapes.capacity() * sizeof(EDHandle);
+	size += quad_before.capacity() * sizeof(EDHandle);
+	for (unsigned i = 0; i < nodes.length(); i++)
+	{
+		size += nodes[i].length() + 1;
+	}
+	return size;
+}
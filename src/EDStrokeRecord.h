@@ -0,0 +1,69 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+// What the journal keeps about one stroke.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include "EDSlotMap.h"
+#include "EDProjection.h"
+
+#include <maya/MPoint.h>
+#include <maya/MStringArray.h>
+
+#include <vector>
+
+///
+//  Everything needed to redo a stroke without projecting it again:
+//  its inputs, the projected world points and what it produced.
+///
+struct EDStrokeRecord
+{
+	// inputs
+	std::vector<short> screen_xy; // h0, v0, h1, v1, ...
+	int draw_mode = 0;
+	bool start_known = false;
+	bool end_known = false;
+
+	// cached projection
+	std::vector<MPoint> world_points;
+	bool projecting_normal = false;
+	EDProjectionData projection;
+
+	// produced nodes
+	std::vector<EDHandle> shapes;
+	// the curve this stroke re-sketched, if any, and what it held before
+	EDHandle replaced;
+	std::vector<MPoint> replaced_samples;
+	EDProjectionData replaced_projection;
+	MStringArray nodes;
+
+	// the quad being drawn before the stroke, put back when it is undone
+	std::vector<EDHandle> quad_before;
+	EDHandle prev_surf_before;
+
+	size_t memory_size() const;
+	// what the journal last counted for this record
+	size_t counted = 0;
+};
@@ -0,0 +1,217 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// Created: Oct 19, 2026
+
+#include "EDSurface.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+bool EDSurface::update(const float * raw_points, size_t vertex_count, const double world_matrix[4][4], uint64_t topology_key)
+{
+	return snapshot.update(raw_points, vertex_count, world_matrix, topology_key);
+}
+
+void EDSurface::refresh()
+{
+	snapshot.build_normals();
+	mesh_geodesics.request(snapshot);
+}
+
+void EDSurface::clear()
+{
+	snapshot.clear();
+	mesh_geodesics.request(snapshot);
+}
+
+const EDTangentEstimator & EDSurface::tangents()
+{
+	if (tangent_estimator.empty() || tangent_estimator.mesh_revision() != snapshot.revision())
+	{
+		tangent_estimator.build(snapshot);
+	}
+	return tangent_estimator;
+}
+
+const EDMeshAdjacency & EDSurface::adjacency()
+{
+	if (mesh_adjacency.empty() || mesh_adjacency.mesh_revision() != snapshot.revision())
+	{
+		mesh_adjacency.build(snapshot);
+	}
+	return mesh_adjacency;
+}
+
+///
+//  Until the factors are ready, or if the mesh is too large to factor,
+//  this is null and callers fall back to straight-line distances.
+///
+const EDGeodesics * EDSurface::geodesics()
+{
+	if (!mesh_geodesics.ready() || mesh_geodesics.mesh_revision() != snapshot.revision()) return nullptr;
+	return &mesh_geodesics;
+}
+
+int EDSurface::nearest_vertex(const float p[3])
+{
+	return tangents().nearest_vertex(p);
+}
+
+bool EDSurface::height_above(const float p[3], float & height, float foot[3])
+{
+	auto v = nearest_vertex(p);
+	if (v < 0) return false;
+
+	auto n = &snapshot.vertex_normals[v * 3];
+	float d[] = { p[0] - snapshot.x[v], p[1] - snapshot.y[v], p[2] - snapshot.z[v] };
+	height = std::max(0.0f, d[0] * n[0] + d[1] * n[1] + d[2] * n[2]);
+	for (int a = 0; a < 3; a++) foot[a] = p[a] - n[a] * height;
+	return true;
+}
+
+void EDSurfaceSet::begin_update()
+{
+	touched.assign(surfaces.size(), false);
+}
+
+EDSurface & EDSurfaceSet::touch(const std::string & key)
+{
+	auto index = find(key);
+	if (index < 0)
+	{
+		index = static_cast<int>(surfaces.size());
+		surfaces.emplace_back(new EDSurface(key));
+		touched.push_back(false);
+		seen.push_back(0);
+		added = true;
+	}
+	touched[index] = true;
+	return *surfaces[index];
+}
+
+void EDSurfaceSet::end_update()
+{
+	bool changed = added;
+	added = false;
+	for (size_t i = surfaces.size(); i-- > 0;)
+	{
+		if (touched[i]) continue;
+		surfaces.erase(surfaces.begin() + i);
+		touched.erase(touched.begin() + i);
+		seen.erase(seen.begin() + i);
+		changed = true;
+	}
+	for (size_t i = 0; i < surfaces.size(); i++)
+	{
+		auto revision = surfaces[i]->mesh().revision();
+		if (seen[i] == revision) continue;
+		seen[i] = revision;
+		changed = true;
+	}
+	if (changed) rev++;
+}
+
+void EDSurfaceSet::clear()
+{
+	if (!surfaces.empty()) rev++;
+	surfaces.clear();
+	touched.clear();
+	seen.clear();
+	added = false;
+}
+
+int EDSurfaceSet::find(const std::string & key) const
+{
+	for (size_t i = 0; i < surfaces.size(); i++)
+	{
+		if (surfaces[i]->key() == key) return static_cast<int>(i);
+	}
+	return -1;
+}
+
+int EDSurfaceSet::nearest(const float p[3], int * vertex)
+{
+	int best = -1, best_vertex = -1;
+	float best_distance = std::numeric_limits<float>::max();
+	for (size_t i = 0; i < surfaces.size(); i++)
+	{
+		auto v = surfaces[i]->nearest_vertex(p);
+		if (v < 0) continue;
+
+		auto & mesh = surfaces[i]->mesh();
+		float dx = mesh.x[v] - p[0], dy = mesh.y[v] - p[1], dz = mesh.z[v] - p[2];
+		auto distance = dx * dx + dy * dy + dz * dz;
+		if (distance >= best_distance) continue;
+		best_distance = distance;
+		best = static_cast<int>(i);
+		best_vertex = v;
+	}
+	if (vertex) *vertex = best_vertex;
+	return best;
+}
+
+double EDSurfaceSet::diagonal() const
+{
+	float lo[] = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+	float hi[] = { -lo[0], -lo[1], -lo[2] };
+	bool any = false;
+	for (auto & surface : surfaces)
+	{
+		auto & mesh = surface->mesh();
+		if (mesh.empty()) continue;
+		any = true;
+		const std::vector<float> * axes[] = { &mesh.x, &mesh.y, &mesh.z };
+		for (int a = 0; a < 3; a++)
+		{
+			auto range = std::minmax_element(axes[a]->begin(), axes[a]->end());
+			lo[a] = std::min(lo[a], *range.first);
+			hi[a] = std::max(hi[a], *range.second);
+		}
+	}
+	if (!any) return 0;
+
+	double sum = 0;
+	for (int a = 0; a < 3; a++) sum += double(hi[a] - lo[a]) * (hi[a] - lo[a]);
+	return std::sqrt(sum);
+}
+
+void EDSurfaceSet::clear_heights()
+{
+	for (auto & surface : surfaces) surface->heights().clear();
+}
+
+void EDSurfaceSet::add_height_site(const float p[3], float known_height)
+{
+	auto s = nearest(p);
+	if (s < 0) return;
+
+	float height, foot[3];
+	if (!surfaces[s]->height_above(p, height, foot)) return;
+	if (known_height >= 0) height = known_height;
+	surfaces[s]->heights().add(foot[0], foot[1], foot[2], height);
+}
+
+void EDSurfaceSet::build_heights()
+{
+	for (auto & surface : surfaces) surface->heights().build();
+}
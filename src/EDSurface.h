@@ -0,0 +1,142 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+
+// The selected meshes strokes land on, each with what is measured on it.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include "EDGeodesics.h"
+#include "EDHeightField.h"
+#include "EDMeshAdjacency.h"
+#include "EDMeshSnapshot.h"
+#include "EDShellCache.h"
+#include "EDTangentEstimator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+///
+//  One selected mesh: its snapshot and everything built on it. The vertex
+//  kd-tree and the adjacency are built on first use per snapshot revision;
+//  geodesics start factoring on a worker thread whenever it changes.
+//  The kd-tree and adjacency point into the snapshot, so a surface stays
+//  where it was made; EDSurfaceSet holds them by pointer.
+///
+class EDSurface
+{
+public:
+	explicit EDSurface(const std::string & key) : scene_key(key) {}
+
+	// the mesh's DAG path, as its instance in the scene BVH is keyed
+	const std::string & key() const { return scene_key; }
+	const EDMeshSnapshot & mesh() const { return snapshot; }
+
+	///
+	//  Returns true if the points, matrix or topology changed. Then set the
+	//  triangles again if topology_changed(), and call refresh().
+	///
+	bool update(const float * raw_points, size_t vertex_count, const double world_matrix[4][4], uint64_t topology_key);
+	bool topology_changed() const { return snapshot.topology_changed(); }
+	void set_triangles(std::vector<int> && triangles) { snapshot.set_triangles(std::move(triangles)); }
+	// normals, and a new factorization requested
+	void refresh();
+	void clear();
+
+	const EDTangentEstimator & tangents();
+	const EDMeshAdjacency & adjacency();
+	// null until the factors for this snapshot are ready
+	const EDGeodesics * geodesics();
+	// blocks until they are, or until factoring gave up on the mesh
+	const EDGeodesics * wait_for_geodesics() { mesh_geodesics.wait(); return geodesics(); }
+	EDShellCache & shells() { return shell_cache; }
+	const EDShellCache & shells() const { return shell_cache; }
+	EDHeightField & heights() { return height_field; }
+	const EDHeightField & heights() const { return height_field; }
+
+	// -1 if the mesh is empty
+	int nearest_vertex(const float p[3]);
+	// height of p along the normal of its nearest vertex, and the point under it
+	bool height_above(const float p[3], float & height, float foot[3]);
+
+private:
+	std::string scene_key;
+	EDMeshSnapshot snapshot;
+	EDTangentEstimator tangent_estimator;
+	EDMeshAdjacency mesh_adjacency;
+	EDGeodesics mesh_geodesics;
+	// offset surfaces around the last shell stroke on this mesh
+	EDShellCache shell_cache;
+	// known heights above this mesh
+	EDHeightField height_field;
+};
+
+///
+//  Every selected mesh, in selection order. A sample whose ray hit one of
+//  them is measured on that one; points known only by position (anchors,
+//  curve samples, hits on generated layers) go to the surface with the
+//  nearest vertex. Heights are kept per surface, so a stroke on one mesh
+//  never blends in heights measured on another.
+///
+class EDSurfaceSet
+{
+public:
+	// surfaces not touched between begin_update() and end_update() are dropped
+	void begin_update();
+	// the surface under key, added if new
+	EDSurface & touch(const std::string & key);
+	void end_update();
+	void clear();
+
+	bool empty() const { return surfaces.empty(); }
+	size_t size() const { return surfaces.size(); }
+	EDSurface & operator[](size_t i) { return *surfaces[i]; }
+	const EDSurface & operator[](size_t i) const { return *surfaces[i]; }
+	// -1 if no surface has the key
+	int find(const std::string & key) const;
+	// changes whenever a surface is added, dropped or changed, 0 before any
+	unsigned revision() const { return rev; }
+
+	// the surface with the vertex nearest p, and that vertex; -1 if there is none
+	int nearest(const float p[3], int * vertex = nullptr);
+	// diagonal of the box around every surface, 0 if they are empty
+	double diagonal() const;
+
+	void clear_heights();
+	// measured above the nearest surface unless known_height >= 0, and added to that surface
+	void add_height_site(const float p[3], float known_height);
+	// call after adding sites, before evaluating
+	void build_heights();
+
+private:
+	std::vector<std::unique_ptr<EDSurface>> surfaces;
+	std::vector<bool> touched;
+	// snapshot revision of each surface as of the last end_update()
+	std::vector<unsigned> seen;
+	bool added = false;
+	unsigned rev = 0;
+};
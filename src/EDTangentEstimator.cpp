@@ -0,0 +1,135 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// Created: Oct 19, 2026
+
+#include "EDTangentEstimator.h"
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+void EDTangentEstimator::build(const EDMeshSnapshot & mesh)
+{
+	revision = mesh.revision();
+	cloud.mesh = &mesh;
+	if (mesh.empty() || mesh.vertex_normals.size() != mesh.vertex_count() * 3)
+	{
+		tree.reset();
+		return;
+	}
+
+	tree.reset(new Tree(3 /*dim*/, cloud, nanoflann::KDTreeSingleIndexAdaptorParams(10)));
+	tree->buildIndex();
+}
+
+void EDTangentEstimator::clear()
+{
+	tree.reset();
+	cloud.mesh = nullptr;
+	revision = 0;
+}
+
+bool EDTangentEstimator::average_normal(const float p[3], float radius, float normal[3]) const
+{
+	if (!tree) return false;
+
+	std::vector<std::pair<size_t, float>> found;
+	tree->radiusSearch(p, radius * radius, found, nanoflann::SearchParams(32, 0, false));
+	if (found.empty()) return false;
+
+	auto & normals = cloud.mesh->vertex_normals;
+	float sum[] = { 0, 0, 0 };
+	for (auto & f : found)
+	{
+		sum[0] += normals[f.first * 3];
+		sum[1] += normals[f.first * 3 + 1];
+		sum[2] += normals[f.first * 3 + 2];
+	}
+
+	auto length = std::sqrt(sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2]);
+	if (!(length > 0)) return false;
+
+	normal[0] = sum[0] / length;
+	normal[1] = sum[1] / length;
+	normal[2] = sum[2] / length;
+	return true;
+}
+
+int EDTangentEstimator::nearest_vertex(const float p[3]) const
+{
+	if (!tree) return -1;
+
+	size_t index = 0;
+	float dist_squared = 0;
+	tree->knnSearch(p, 1, &index, &dist_squared);
+	return static_cast<int>(index);
+}
+
+bool EDTangentEstimator::stroke_normal(const float * x, const float * y, const float * z,
+	const float * dx, const float * dy, const float * dz, size_t count, float radius, float normal[3]) const
+{
+	if (!tree) return false;
+
+	auto & normals = cloud.mesh->vertex_normals;
+	float sum[] = { 0, 0, 0 };
+	std::vector<std::pair<size_t, float>> found;
+	for (size_t i = 0; i < count; i++)
+	{
+		float p[] = { x[i], y[i], z[i] };
+		found.clear();
+		tree->radiusSearch(p, radius * radius, found, nanoflann::SearchParams(32, 0, false));
+		if (found.empty())
+		{
+			found.push_back(std::make_pair(static_cast<size_t>(nearest_vertex(p)), 0.0f));
+		}
+
+		for (auto & f : found)
+		{
+			auto n = &normals[f.first * 3];
+			auto facing = -(n[0] * dx[i] + n[1] * dy[i] + n[2] * dz[i]);
+			if (facing <= 0) continue;
+			sum[0] += n[0] * facing;
+			sum[1] += n[1] * facing;
+			sum[2] += n[2] * facing;
+		}
+	}
+
+	auto length = std::sqrt(sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2]);
+	if (!(length > 0)) return false;
+
+	normal[0] = sum[0] / length;
+	normal[1] = sum[1] / length;
+	normal[2] = sum[2] / length;
+	return true;
+}
+
+bool EDTangentEstimator::nearest_normal(const float p[3], float normal[3]) const
+{
+	auto index = nearest_vertex(p);
+	if (index < 0) return false;
+
+	auto & normals = cloud.mesh->vertex_normals;
+	normal[0] = normals[index * 3];
+	normal[1] = normals[index * 3 + 1];
+	normal[2] = normals[index * 3 + 2];
+	return true;
+}
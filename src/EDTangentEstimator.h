@@ -0,0 +1,98 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+// Surface normals around a point, from the mesh snapshot.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include "EDMeshSnapshot.h"
+
+#include <nanoflann.hpp>
+
+#include <memory>
+
+///
+//  3D kd-tree over the snapshot's vertices, read in place from its axis
+//  arrays. Answers "which way does the surface face around here" with one
+//  spatial query instead of a closest-point call per sample.
+///
+class EDTangentEstimator
+{
+public:
+	void build(const EDMeshSnapshot & mesh);
+	void clear();
+
+	bool empty() const { return !tree; }
+	// the snapshot revision it was built from
+	unsigned mesh_revision() const { return revision; }
+
+	// mean of the vertex normals within radius of p; false if there are none
+	bool average_normal(const float p[3], float radius, float normal[3]) const;
+	// normal of the vertex nearest to p
+	bool nearest_normal(const float p[3], float normal[3]) const;
+
+	///
+	//  Mean surface normal under a stroke: the vertex normals within radius
+	//  of each hit (or the nearest one), weighted by how squarely they face
+	//  that hit's ray. Back-facing vertices are left out, so hits spread
+	//  over a curved body do not cancel or pull in its far side.
+	///
+	bool stroke_normal(const float * x, const float * y, const float * z,
+		const float * dx, const float * dy, const float * dz, size_t count, float radius, float normal[3]) const;
+	// -1 if there is no vertex
+	int nearest_vertex(const float p[3]) const;
+
+private:
+	struct Cloud
+	{
+		const EDMeshSnapshot * mesh = nullptr;
+
+		size_t kdtree_get_point_count() const { return mesh->vertex_count(); }
+
+		float kdtree_distance(const float * p, const size_t i, size_t /*size*/) const
+		{
+			const float d0 = p[0] - mesh->x[i];
+			const float d1 = p[1] - mesh->y[i];
+			const float d2 = p[2] - mesh->z[i];
+			return d0 * d0 + d1 * d1 + d2 * d2;
+		}
+
+		float kdtree_get_pt(const size_t i, int dim) const
+		{
+			return dim == 0 ? mesh->x[i] : dim == 1 ? mesh->y[i] : mesh->z[i];
+		}
+
+		template <class BBOX>
+		bool kdtree_get_bbox(BBOX & /*bb*/) const { return false; }
+	};
+
+	typedef nanoflann::KDTreeSingleIndexAdaptor<
+		nanoflann::L2_Simple_Adaptor<float, Cloud>,
+		Cloud,
+		3 /* dim */
+	> Tree;
+
+	Cloud cloud;
+	std::unique_ptr<Tree> tree;
+	unsigned revision = 0;
+};
@@ -32,19 +32,129 @@
 #include <maya/MUIDrawManager.h>
 #include <maya/MFnDagNode.h>
 #include <maya/MFnMesh.h>
+#include <maya/MFnNurbsSurface.h>
 #include <maya/MPointArray.h>
 
 #include <nanoflann.hpp>
 #include "EDMath.h"
+#include "EDMathMaya.h"
+#include "EDParallel.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <string>
 #include <list>
 #include <vector>
 
+namespace
+{
+	inline EDSketchEngine::Vec to_vec(const MPoint & p)
+	{
+		return EDSketchEngine::Vec(p.x, p.y, p.z);
+	}
+
+	inline MPoint to_point(const EDSketchEngine::Vec & v)
+	{
+		return MPoint(v.x, v.y, v.z);
+	}
+
+	// the active view as the engine sees it
+	EDCamera camera_of(M3dView & view)
+	{
+		MMatrix model_view, projection_matrix;
+		view.modelViewMatrix(model_view);
+		view.projectionMatrix(projection_matrix);
+		auto view_projection = model_view * projection_matrix;
+		EDCamera camera;
+		view_projection.get(camera.view_projection);
+		view_projection.inverse().get(camera.inverse);
+		camera.width = view.portWidth();
+		camera.height = view.portHeight();
+		return camera;
+	}
+
+	EDSketchEngine::Stroke stroke_of(const std::vector<coord> & screen_points)
+	{
+		EDSketchEngine::Stroke stroke;
+		stroke.px.reserve(screen_points.size());
+		stroke.py.reserve(screen_points.size());
+		for (auto & c : screen_points)
+		{
+			stroke.px.push_back(c.h);
+			stroke.py.push_back(c.v);
+		}
+		return stroke;
+	}
+
+	///
+	//  Maya has no topology version; the vertex count and a hash of the
+	//  face-vertex lists stand in for one, so merged or reordered vertices
+	//  are caught even when the counts stay the same.
+	///
+	uint64_t topology_key(const MFnMesh & mesh)
+	{
+		MIntArray counts, connects;
+		mesh.getVertices(counts, connects);
+		std::vector<int> words(counts.length() + connects.length());
+		if (!words.empty())
+		{
+			counts.get(words.data());
+			connects.get(words.data() + counts.length());
+		}
+		uint64_t key = words.empty() ? 0 : EDMeshSnapshot::hash_words(reinterpret_cast<const uint32_t *>(words.data()), words.size());
+		return key ^ (static_cast<uint64_t>(mesh.numVertices()) * 0x9E3779B97F4A7C15ull);
+	}
+
+	std::vector<int> triangles_of(const MFnMesh & mesh)
+	{
+		MIntArray counts, vertices;
+		mesh.getTriangles(counts, vertices);
+		std::vector<int> triangles(vertices.length());
+		if (!triangles.empty()) vertices.get(triangles.data());
+		return triangles;
+	}
+
+	inline void to_floats(const MPoint & p, float out[3])
+	{
+		out[0] = static_cast<float>(p.x);
+		out[1] = static_cast<float>(p.y);
+		out[2] = static_cast<float>(p.z);
+	}
+}
+
 DrawnCurve::DrawnCurve(const MPoint & start, const MPoint & end, const MString & name)
 	: start(start), end(end), name(name)
 {}
 
+EDHandle EDShapeStore::add(const DrawnCurve & shape)
+{
+	auto h = shapes.insert(shape);
+	by_name[shape.name.asChar()] = h;
+	return h;
+}
+
+bool EDShapeStore::remove(EDHandle h)
+{
+	auto shape = shapes.get(h);
+	if (!shape) return false;
+
+	by_name.erase(shape->name.asChar());
+	return shapes.remove(h);
+}
+
+void EDShapeStore::clear()
+{
+	shapes.clear();
+	by_name.clear();
+}
+
+EDHandle EDShapeStore::find(const MString & name) const
+{
+	auto it = by_name.find(name.asChar());
+	return it == by_name.end() ? EDHandle() : it->second;
+}
+
 
 const int initialSize = 1024;
 const int increment = 256;
@@ -67,6 +177,7 @@ int xycompare(coord *p1, coord *p2)
 EasyDressTool::EasyDressTool()
 {
 	setTitleString("EasyDress Sketch");
+	anchor_hash.reset(weld_radius);
 }
 
 EasyDressTool::~EasyDressTool() {}
@@ -78,9 +189,8 @@ void* EasyDressTool::creator()
 
 void EasyDressTool::clear_quad_cache()
 {
-	prev_curves.clear();
-	prev_curve_start_end.clear();
-	prev_surf = "";
+	quad_curves.clear();
+	prev_surf = EDHandle();
 }
 
 void EasyDressTool::toolOnSetup(MEvent &)
@@ -91,6 +201,7 @@ void EasyDressTool::toolOnSetup(MEvent &)
 
 MStatus EasyDressTool::doPress(MEvent & event, MHWRender::MUIDrawManager& drawMgr, const MHWRender::MFrameContext& context)
 {
+	engine.set_layer(projection_layer);
 	if (event.isModifierControl())
 	{
 		drawMode = EDDrawMode::kNormal;
@@ -108,6 +219,7 @@ MStatus EasyDressTool::doPress(MEvent & event, MHWRender::MUIDrawManager& drawMg
 	//
 	view = M3dView::active3dView();
 	update_anchors();
+	if (oversketch_enabled) update_curve_samples();
 
 	//// Create an array to hold the lasso points. Assume no mem failures
 	//maxSize = initialSize;
@@ -116,12 +228,12 @@ MStatus EasyDressTool::doPress(MEvent & event, MHWRender::MUIDrawManager& drawMg
 
 	coord start;
 	event.getPosition(start.h, start.v);
-	auto snap_anchor_index = do_snap(start.toMPoint());
-	if (snap_anchor_index > 0 && snap_anchor_index < anchors.size())
+	auto snap_anchor = do_snap(start.toMPoint());
+	if (snap_anchor != kNoAnchor)
 	{
-		first_anchor = anchors[snap_anchor_index];
-		start.h = static_cast<short>(first_anchor->point_2D.x);
-		start.v = static_cast<short>(first_anchor->point_2D.y);
+		first_anchor = snap_anchor;
+		start.h = static_cast<short>(anchor_pool[first_anchor].point_2D.x);
+		start.v = static_cast<short>(anchor_pool[first_anchor].point_2D.y);
 		first_anchored = true;
 	}
 	
@@ -174,6 +286,44 @@ MStatus EasyDressTool::doRelease(MEvent & event, MHWRender::MUIDrawManager& draw
 	}
 	//view.viewToObjectSpace
 
+	std::vector<MDagPath> selected_meshes;
+	get_selected_meshes(selected_meshes);
+	update_surfaces(selected_meshes);
+	update_weld_radius();
+	update_scene_bvh(selected_meshes);
+	engine.set_camera(camera_of(view));
+	engine.update_raster();
+
+	// a stroke that starts and ends on the same drawn curve redraws that part of it
+	EDHandle over_curve;
+	size_t span_start, span_end;
+	bool oversketched = false;
+	if (oversketch_enabled && !first_anchored && stroke.size() > 2 && do_snap(stroke.back().toMPoint()) == kNoAnchor
+		&& find_oversketch(stroke.front(), stroke.back(), over_curve, span_start, span_end))
+	{
+		// it may reverse the samples; a stroke it cannot use is sketched as drawn
+		auto screen_points = stroke;
+		oversketched = oversketch_curve(over_curve, span_start, span_end, screen_points);
+	}
+	if (!oversketched)
+	{
+		sketch_stroke(event);
+	}
+
+	stroke.clear();
+	first_anchored = false;
+	first_anchor = kNoAnchor;
+	last_anchor = kNoAnchor;
+
+	return MS::kSuccess;
+}
+
+///
+//  Projects a new stroke and builds its curve, plus the surface or volume
+//  it completes.
+///
+void EasyDressTool::sketch_stroke(MEvent & event)
+{
 	bool first_point_known = false;
 	bool last_point_known = false;
 	MPoint first_world_point;
@@ -181,16 +331,20 @@ MStatus EasyDressTool::doRelease(MEvent & event, MHWRender::MUIDrawManager& draw
 
 	if (drawing_quad)
 	{
-		if (prev_curves.size() >= 1)
+		auto prev = quad_curves.empty() ? nullptr : drawn_shapes.get(quad_curves.back());
+		if (prev)
 		{
 			first_point_known = true;
-			first_world_point = prev_curve_start_end.back().second;
+			first_world_point = prev->end;
+			first_anchor = prev->end_anchor;
 		}
 
-		if (prev_curves.size() >= 3)
+		auto first = quad_curves.size() >= 3 ? drawn_shapes.get(quad_curves.front()) : nullptr;
+		if (first)
 		{
 			last_point_known = true;
-			last_world_point = prev_curve_start_end.front().first;
+			last_world_point = first->start;
+			last_anchor = first->start_anchor;
 		}
 	}
 
@@ -198,14 +352,14 @@ MStatus EasyDressTool::doRelease(MEvent & event, MHWRender::MUIDrawManager& draw
 	{
 		coord currentPos;
 		event.getPosition(currentPos.h, currentPos.v);
-		auto snap_anchor_index = do_snap(currentPos.toMPoint());
-		if (snap_anchor_index > 0 && snap_anchor_index < anchors.size())
+		auto snap_anchor = do_snap(currentPos.toMPoint());
+		if (snap_anchor != kNoAnchor)
 		{
-			auto& acr = anchors[snap_anchor_index];
-			append_stroke(static_cast<short>(acr->point_2D.x), static_cast<short>(acr->point_2D.y));
+			auto& acr = anchor_pool[snap_anchor];
+			append_stroke(static_cast<short>(acr.point_2D.x), static_cast<short>(acr.point_2D.y));
 			last_point_known = true;
-			last_world_point = acr->point_3D;
-            last_anchor = acr;
+			last_world_point = acr.point_3D;
+			last_anchor = snap_anchor;
 		}
 	}
 	if (!first_point_known)
@@ -213,706 +367,1038 @@ MStatus EasyDressTool::doRelease(MEvent & event, MHWRender::MUIDrawManager& draw
 		if (first_anchored)
 		{
 			first_point_known = true;
-			first_world_point = first_anchor->point_3D;
+			first_world_point = anchor_pool[first_anchor].point_3D;
+		}
+	}
+
+	// generate curve
+	auto tan_mode = drawMode == EDDrawMode::kTangent;
+	auto norm_mode = drawMode == EDDrawMode::kNormal;
+	std::vector<MPoint> world_points;
+	bool projecting_normal = false;
+	bool projected = project_stroke(stroke, first_point_known, last_point_known, first_world_point, last_world_point, world_points, projecting_normal, tan_mode, norm_mode);
+
+	if (projected)
+	{
+		auto & record = journal.push();
+		record.screen_xy.reserve(stroke.size() * 2);
+		for (auto & c : stroke)
+		{
+			record.screen_xy.push_back(c.h);
+			record.screen_xy.push_back(c.v);
+		}
+		record.draw_mode = drawMode;
+		record.start_known = first_point_known;
+		record.end_known = last_point_known;
+		record.world_points = world_points;
+		record.projecting_normal = projecting_normal;
+		record.projection = projection;
+
+		if (commit_stroke(record))
+		{
+			journal.confirm();
+			trim_journal();
+		}
+		else
+		{
+			journal.discard_last();
 		}
 	}
+}
 
+// every selected mesh shape, each once, in selection order
+void EasyDressTool::get_selected_meshes(std::vector<MDagPath> & meshes) const
+{
+	meshes.clear();
+	MSelectionList incomingList;
 	// get selection location
 	MGlobal::getActiveSelectionList(incomingList);
 	MItSelectionList iter(incomingList);
-	//MPoint selectionPoint(0, 0, 0);
-
-	MFnMesh * selected_mesh = nullptr;
 
+	std::unordered_set<std::string> seen;
 	for (; !iter.isDone(); iter.next())
 	{
 		MDagPath dagPath;
-		auto stat = iter.getDagPath(dagPath);
+		if (!iter.getDagPath(dagPath)) continue;
 
-		if (stat)
+		if (dagPath.hasFn(MFn::kTransform))
 		{
+			dagPath.extendToShape();
+		}
 
-			if (dagPath.hasFn(MFn::kTransform))
-			{
-				MFnTransform fn(dagPath);
-				//selectionPoint = fn.getTranslation(MSpace::kWorld);
-				dagPath.extendToShape();
-			}
-
-			if (dagPath.hasFn(MFn::kMesh))
-			{
-				MStatus stat_mesh;
-				selected_mesh = new MFnMesh(dagPath, &stat_mesh);
-
-				if (stat_mesh)
-				{
-					break;
-				}
-				else
-				{
-					selected_mesh = nullptr;
-					continue;
-				}
-			}
+		if (dagPath.hasFn(MFn::kMesh) && seen.insert(dagPath.fullPathName().asChar()).second)
+		{
+			meshes.push_back(dagPath);
 		}
 	}
+}
 
-	// TODO: rebuild kd-tree only when view is changed
-	rebuild_kd(selected_mesh);
+///
+//  Reads every selected mesh into its surface, straight from its raw
+//  points. An unchanged mesh hashes the same and is not copied again;
+//  deselected ones are dropped.
+///
+void EasyDressTool::update_surfaces(const std::vector<MDagPath> & meshes)
+{
+	engine.surfaces().begin_update();
+	for (auto & dag_path : meshes)
+	{
+		MStatus stat;
+		MFnMesh mesh(dag_path, &stat);
+		auto raw_points = stat ? mesh.getRawPoints(&stat) : nullptr;
+		if (!raw_points || !stat) continue;
 
-	// generate curve
-	auto tan_mode = drawMode == EDDrawMode::kTangent;
-	auto norm_mode = drawMode == EDDrawMode::kNormal;
-	MString new_curve = create_curve(stroke, selected_mesh, first_point_known, last_point_known, first_world_point, last_world_point, tan_mode, norm_mode);
-	
-	
-	// generate surface or volume
-	if (new_curve != "")
-	{
-		if (prev_curves.size() == 4) {
-			std::string surface_command;
-			surface_command.reserve(500);
-			surface_command.append("proc string __ed_draw_surf() { \n");
-			surface_command.append("string $slct[]=`ls- sl`;\n");
-			surface_command.append("select -r ");
-			std::list<std::string> curve_names;
-			while (!prev_curves.empty())
-			{
-				curve_names.push_back(prev_curves.front().asChar());
-				surface_command.append(prev_curves.front().asChar());
-				prev_curves.pop_front();
-				prev_curve_start_end.pop_front();
-				surface_command.append(" ");
-			}
-			surface_command.append(";\n");
-			surface_command.append("string $nurbssurf[] = `boundary -ch 1 -or 0 -ep 0 -rn 0 -po 0 -ept 0.01 ");
-			while (!curve_names.empty())
-			{
-				surface_command.append(" ");
-				surface_command.append("\"" + curve_names.front() + "\"");
-				curve_names.pop_front();
-			}
-			surface_command.append("`;\n");
-			surface_command.append("select $slct; \n");
-			surface_command.append("return $nurbssurf[0]; \n } \n");
-			surface_command.append("__ed_draw_surf();");
-			MGlobal::executeCommand(MString(surface_command.c_str()), prev_surf);
-			drawn_shapes.push_back(prev_surf);
-		}
+		auto & surface = engine.surfaces().touch(dag_path.fullPathName().asChar());
+		double world_matrix[4][4];
+		dag_path.inclusiveMatrix().get(world_matrix);
+		if (!surface.update(raw_points, mesh.numVertices(), world_matrix, topology_key(mesh))) continue;
 
-		if (norm_mode && prev_surf != "")
+		if (surface.topology_changed())
 		{
-			// extrude previous surface;
-			float distance = (drawn_curves.back().start - drawn_curves.back().end).length();
-			std::string extrude_command;
-			extrude_command.reserve(500);
-
-			extrude_command.append("string $mesh_surf[]= `nurbsToPoly -mnd 1  -ch 1 -f 1 -pt 1 -pc 200 -chr 0.9 -ft 0.01 -mel 0.001 -d 0.1 -ut 1 -un 3 -vt 1 -vn 3 -uch 0 -ucr 0 -cht 0.01 -es 0 -ntr 0 -mrt 0 -uss 1 \"");
-			extrude_command.append(prev_surf.asChar());
-			extrude_command.append("\"`;\n");
-			extrude_command.append("polyExtrudeFacet -ltz " + std::to_string(distance) + " -constructionHistory 1 -keepFacesTogether 1 -divisions 4 -twist 0 -taper 1 -off 0 -thickness 0 -smoothingAngle 30 $mesh_surf[0];");
-			MGlobal::executeCommand(MString(extrude_command.c_str()));
-			//TODO: Move this out
-
-			prev_curves.clear();
-			prev_curve_start_end.clear();
+			surface.set_triangles(triangles_of(mesh));
 		}
+		surface.refresh();
 	}
-	
-
-	stroke.clear();
-	first_anchored = false;
-    first_anchor = nullptr;
-    last_anchor = nullptr;
-
-	if (selected_mesh)
-		delete selected_mesh;
-	selected_mesh = nullptr;
-
-	return MS::kSuccess;
-}
-
-MStatus EasyDressTool::drawFeedback(MHWRender::MUIDrawManager & drawMgr, const MHWRender::MFrameContext & context)
-{
-	//draw_stroke(drawMgr);
-	return MStatus::kSuccess;
+	engine.surfaces().end_update();
 }
 
-size_t EasyDressTool::do_snap(const MPoint & input_end_point)
+///
+//  Brings the scene BVH up to date with the selected meshes. A hit on one of
+//  them is measured on its own surface. The layers the tool generated stay
+//  pinned; a hit on one is measured on the selected mesh nearest it, the
+//  one it was sketched over. A mesh whose points and topology hash the
+//  same keeps its bottom level, so moving it costs only its new matrix.
+///
+void EasyDressTool::update_scene_bvh(const std::vector<MDagPath> & meshes)
 {
-	const float radius = 5;
-
-	float pt[] = { input_end_point.x , input_end_point.y, 0 };
-	
-	size_t out_index = 0;
-	float out_dist_squared = 0;
-	anchors_kd_2d->knnSearch(pt, 1, &out_index, &out_dist_squared);
-
-	if (out_dist_squared < radius * radius && out_index > 0)
+	engine.scene().begin_update();
+	for (auto & dag_path : meshes)
 	{
-		return out_index;
+		MStatus stat;
+		MFnMesh mesh(dag_path, &stat);
+		auto raw_points = stat ? mesh.getRawPoints(&stat) : nullptr;
+		if (!raw_points || !stat) continue;
+
+		size_t vertex_count = mesh.numVertices();
+		auto hash = EDMeshSnapshot::hash_words(reinterpret_cast<const uint32_t *>(raw_points), vertex_count * 3) ^ topology_key(mesh);
+		double world_matrix[4][4];
+		dag_path.inclusiveMatrix().get(world_matrix);
+		std::string key = dag_path.fullPathName().asChar();
+		if (engine.scene().update_instance(key, hash, world_matrix))
+		{
+			engine.scene().set_geometry(key, raw_points, vertex_count, triangles_of(mesh));
+		}
 	}
-
-	return -1;
+	engine.scene().end_update();
 }
 
-void EasyDressTool::completeAction()
+///
+//  Puts a surface or volume the tool just made straight into the scene BVH, so
+//  the next layer can be sketched on it without selecting it.
+///
+void EasyDressTool::insert_generated(EDHandle h)
 {
+	EDGeneratedGeometry geometry;
+	if (!read_generated(h, geometry)) return;
+
+	EDSceneBvh::build_geometry(geometry.blas, geometry.points.data(), geometry.vertex_count, geometry.triangles);
+	engine.scene().insert_instance(geometry.key, std::move(geometry.blas), geometry.world_matrix);
 }
 
-void EasyDressTool::deleteAction()
+///
+//  Meshes keep their own triangles; NURBS patches are sampled on a grid in
+//  world space. Keyed by the full DAG path, as update_scene_bvh keys
+//  selected meshes. Uses the Maya API, so only from the main thread.
+///
+bool EasyDressTool::read_generated(EDHandle h, EDGeneratedGeometry & geometry)
 {
-	if (drawn_shapes.size() == 0) return;
-	MString delete_command;
-	delete_command += "delete ";
-	auto last = drawn_shapes.back();
-	delete_command += last;
-	drawn_shapes.pop_back();
-	delete_command += ";";
-
-	if (prev_curves.size() > 0 && prev_curves.back() == last)
+	auto shape = drawn_shapes.get(h);
+	if (!shape) return false;
+
+	MSelectionList list;
+	MDagPath dag_path;
+	if (!list.add(shape->name) || !list.getDagPath(0, dag_path)) return false;
+	if (dag_path.hasFn(MFn::kTransform)) dag_path.extendToShape();
+
+	std::string key = dag_path.fullPathName().asChar();
+	if (!shape->scene_key.empty() && shape->scene_key != key) engine.scene().remove_instance(shape->scene_key);
+	shape->scene_key = key;
+	geometry.key = key;
+	MStatus stat;
+	if (dag_path.hasFn(MFn::kMesh))
 	{
-		// step back quad cache
-		prev_curves.pop_back();
-		prev_curve_start_end.pop_back();
+		MFnMesh mesh(dag_path, &stat);
+		auto raw_points = stat ? mesh.getRawPoints(&stat) : nullptr;
+		if (!raw_points || !stat) return false;
+
+		geometry.vertex_count = mesh.numVertices();
+		geometry.points.assign(raw_points, raw_points + geometry.vertex_count * 3);
+		geometry.triangles = triangles_of(mesh);
+		dag_path.inclusiveMatrix().get(geometry.world_matrix);
+		return true;
 	}
 
-	if (drawn_curves.size() > 0 && drawn_curves.back().name == last)
+	if (!dag_path.hasFn(MFn::kNurbsSurface)) return false;
+	MFnNurbsSurface surface(dag_path, &stat);
+	double u0, u1, v0, v1;
+	if (!stat || !surface.getKnotDomain(u0, u1, v0, v1)) return false;
+
+	auto n = std::max(generated_grid, 1);
+	auto & points = geometry.points;
+	points.clear();
+	points.reserve((n + 1) * (n + 1) * 3);
+	for (int j = 0; j <= n; j++)
 	{
-		drawn_curves.pop_back();
+		for (int i = 0; i <= n; i++)
+		{
+			MPoint p;
+			surface.getPointAtParam(u0 + (u1 - u0) * i / n, v0 + (v1 - v0) * j / n, p, MSpace::kWorld);
+			points.push_back(static_cast<float>(p.x));
+			points.push_back(static_cast<float>(p.y));
+			points.push_back(static_cast<float>(p.z));
+		}
 	}
-	 
-	MGlobal::executeCommand(delete_command);
+	geometry.vertex_count = (n + 1) * (n + 1);
+	auto & triangles = geometry.triangles;
+	triangles.clear();
+	triangles.reserve(n * n * 6);
+	for (int j = 0; j < n; j++)
+	{
+		for (int i = 0; i < n; i++)
+		{
+			int a = j * (n + 1) + i;
+			int quad[] = { a, a + 1, a + n + 2, a, a + n + 2, a + n + 1 };
+			triangles.insert(triangles.end(), quad, quad + 6);
+		}
+	}
+	const double identity[4][4] = { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 }, { 0, 0, 0, 1 } };
+	std::copy(&identity[0][0], &identity[0][0] + 16, &geometry.world_matrix[0][0]);
+	return true;
 }
 
-MString EasyDressTool::create_curve(std::vector<coord>& screen_points, MFnMesh* selected_mesh, bool start_known, bool end_known, const MPoint & start_point, MPoint & end_point, bool tangent_mode, bool normal_mode)
+///
+//  Builds the curve of a projected stroke, and the surface or volume it
+//  completes, as one batch. Also used to redo a stroke from the journal.
+///
+bool EasyDressTool::commit_stroke(EDStrokeRecord & record)
 {
-	if (!selected_mesh)
+	auto & world_points = record.world_points;
+	auto norm_mode = record.draw_mode == EDDrawMode::kNormal;
+	record.shapes.clear();
+	record.nodes.clear();
+	record.quad_before = quad_curves;
+	record.prev_surf_before = prev_surf;
+
+	weld_ends(world_points);
+
+	// a redone re-sketch goes back onto the curve it replaced
+	if (record.replaced.valid())
 	{
-		return MString();
+		return replace_curve(record, record.replaced);
 	}
 
-	auto num_points = screen_points.size();
+	// in re-sketch mode, a stroke between the two anchors of one curve replaces that curve
+	EDAnchorGraph::EdgeId existing;
+	if (resketch_enabled && !record.projecting_normal && first_anchor != kNoAnchor && last_anchor != kNoAnchor
+		&& anchor_graph.find_edge(first_anchor, last_anchor, existing))
+	{
+		return replace_curve(record, EDHandle::unpack(existing));
+	}
 
-	std::vector<MPoint> world_points;
-	world_points.reserve(num_points);
-	std::vector<bool> hit_list;
-	hit_list.reserve(num_points);
-	std::vector<std::pair<MPoint, MVector>> rays;
-	rays.reserve(num_points);
-
-	unsigned hit_count = 0;
-	// calculate points in world space
-	for (unsigned i = 0; i < num_points; i++)
-	{
-		MPoint ray_origin;
-		MVector ray_direction;
-
-		view.viewToWorld(screen_points[i].h, screen_points[i].v, ray_origin, ray_direction);
-		rays.push_back(std::pair<MPoint, MVector>(ray_origin, ray_direction));
-		MPoint world_point;
-		bool hit = false;
-
-			//MIntArray faceids;
-			MFloatPoint hit_point;
-			float hit_param;
-			int hit_face;
-			int hit_tri;
-			float hit_bary1;
-			float hit_bary2;
-
-			bool intersected = selected_mesh->closestIntersection(ray_origin,
-				ray_direction,
-				nullptr,
-				nullptr,
-				true,
-				MSpace::kWorld,
-				10000, // maxParam
-				false, // testBothDirections
-				nullptr,
-				hit_point,
-				&hit_param,
-				&hit_face,
-				&hit_tri,
-				&hit_bary1,
-				&hit_bary2
-				);
-
-			if (intersected)
-			{
-				world_point = hit_point;
-				hit = true;
-				hit_count++;
-			}
-		
+	// generate surface or volume, all in one batch
+	scene_writer.begin();
+	auto curve_op = scene_writer.add_curve(world_points);
+	auto surf_op = EDSceneWriter::kInvalidOp;
 
-		world_points.push_back(world_point);
-		hit_list.push_back(hit);
+	// a curve joining two anchors that are already connected closes a loop
+	std::vector<EDHandle> loop_curves;
+	std::vector<bool> reversed;
+	if (!record.projecting_normal && find_loop(first_anchor, last_anchor, loop_curves, reversed))
+	{
+		// the new curve runs from first_anchor to last_anchor, the chain back from there
+		std::vector<std::string> loop;
+		loop.push_back(EDSceneWriter::ref(curve_op));
+		reversed.insert(reversed.begin(), false);
+		for (auto h : loop_curves)
+		{
+			loop.push_back(EDSceneWriter::quote(drawn_shapes.get(h)->name));
+		}
+		surf_op = queue_surface(loop, reversed);
 	}
-	if (start_known)
+
+	auto surf_handle = prev_surf;
+	auto surf = drawn_shapes.get(surf_handle);
+	bool extruding = norm_mode && surf;
+	auto extrude_op = EDSceneWriter::kInvalidOp;
+	if (extruding)
 	{
-		world_points[0] = start_point;
+		// extrude previous surface;
+		float distance = (world_points.front() - world_points.back()).length();
+		extrude_op = scene_writer.add_extrusion(EDSceneWriter::quote(surf->name), distance);
 	}
-	if (end_known)
+
+	MStringArray created;
+	if (!scene_writer.commit(created))
 	{
-		world_points[num_points - 1] = end_point;
+		return false;
 	}
+	record.nodes = created;
 
-	if (world_points.size() > 2)
+	if (created.length() > static_cast<unsigned>(curve_op) && created[curve_op] != "")
 	{
-		bool projecting_normal = false;
-		if (hit_count == 0)
-		{
-			project_contour(screen_points, world_points, hit_list, selected_mesh, rays, start_known, end_known);
-			// classify this curve as shell contour
-			setHelpString("Classified: Shell Contour!");
+		auto curve = record_curve(created[curve_op], record);
+		record.shapes.push_back(curve);
 
-			// TODO: SHAPE MATCHING!
-		}
-		else if ((is_normal(screen_points, world_points, hit_list, selected_mesh) || normal_mode) && (hit_list[0] || hit_list[num_points - 1]))
-		{
-			projecting_normal = true;
-			project_normal(screen_points, world_points, hit_list, selected_mesh, rays, start_known, end_known);
-			setHelpString("Classified: Normal!");
-		}
-		else if (tangent_mode)
+		if (surf_op != EDSceneWriter::kInvalidOp)
 		{
-			// TODO: actually use is_tangent the same time as force tangent
-			project_tangent(screen_points, world_points, hit_list, selected_mesh, rays, start_known, end_known);
-			setHelpString("Classified: Tangent Plane!");
-		}
-		else
-		{
-			project_shell(screen_points, world_points, hit_list, selected_mesh, rays, start_known, end_known);
-			setHelpString("Classified: Shell Projection!");
-		}
+			clear_quad_cache();
+			prev_surf = record_shape(kSurfaceShape, created[surf_op]);
+			record.shapes.push_back(prev_surf);
+			insert_generated(prev_surf);
 
-		// create the curve
-		std::string curve_command;
-		curve_command.reserve(world_points.size() * 40 + 200);
-		curve_command.append("proc string __ed_draw_curve() { \n");
-		curve_command.append("string $slct[]=`ls- sl`;\n");
-		curve_command.append("string $cv = `curve");
-		for (auto & p : world_points)
-		{
-			curve_command.append(" -p ");
-			curve_command.append(std::to_string(p.x));
-			curve_command.append(" ");
-			curve_command.append(std::to_string(p.y));
-			curve_command.append(" ");
-			curve_command.append(std::to_string(p.z));
+			shape_deps.add_edge(curve.pack(), prev_surf.pack());
+			for (auto h : loop_curves)
+			{
+				shape_deps.add_edge(h.pack(), prev_surf.pack());
+			}
 		}
-		curve_command.append("`;\n");
-		// smooth the curve
-		curve_command.append("rebuildCurve -ch 1 -rpo 1 -rt 0 -end 1 -kr 0 -kcp 0 -kep 1 -kt 0 -s 8 -d 3 -tol 0.01 $cv; \n");
-		curve_command.append("select $slct; \n");
-		curve_command.append("return $cv; \n } \n");
-		curve_command.append("__ed_draw_curve();");
-
-		MString curve_name;
-		MGlobal::executeCommand(MString(curve_command.c_str()), curve_name);
-		if (!projecting_normal)
+
+		if (extruding)
 		{
-			prev_curves.push_back(curve_name);
-			prev_curve_start_end.push_back(std::pair<MPoint, MPoint>(world_points[0], world_points[world_points.size() - 1]));
+			auto volume = record_shape(kVolumeShape, created[extrude_op]);
+			record.shapes.push_back(volume);
+			insert_generated(volume);
+			shape_deps.add_edge(surf_handle.pack(), volume.pack());
+			quad_curves.clear();
 		}
+	}
+	return true;
+}
 
-        auto cv = DrawnCurve(world_points[0], world_points[world_points.size() - 1], curve_name);
-        cv.start_anchor = first_anchor;
-        cv.end_anchor = last_anchor;
-        MPoint dummypoint2D;
-        if (!cv.start_anchor)
-        {
-            cv.start_anchor.reset(new EDAnchor(dummypoint2D, cv.start));
-        }
-        if (!cv.end_anchor)
-        {
-            cv.end_anchor.reset(new EDAnchor(dummypoint2D, cv.end));
-        }
-		drawn_curves.push_back(cv);
-        
-		drawn_shapes.push_back(curve_name);
-		return curve_name;
+///
+//  Reshapes an existing curve with the stroke instead of adding a new one.
+//  Only the patches and volumes built on it are touched.
+///
+bool EasyDressTool::replace_curve(EDStrokeRecord & record, EDHandle curve)
+{
+	auto cv = drawn_shapes.get(curve);
+	if (!cv) return false;
 
+	auto & world_points = record.world_points;
+	// keep the direction of the old curve
+	if (first_anchor == cv->end_anchor && last_anchor == cv->start_anchor && first_anchor != last_anchor)
+	{
+		std::reverse(world_points.begin(), world_points.end());
+		std::reverse(record.projection.heights.begin(), record.projection.heights.end());
 	}
-	else
+
+	scene_writer.begin();
+	scene_writer.add_replace_curve(EDSceneWriter::quote(cv->name), world_points);
+	MStringArray created;
+	if (!scene_writer.commit(created))
 	{
-		return MString();
+		return false;
 	}
+
+	record.nodes = created;
+	record.replaced = curve;
+	// kept so undo can put them back
+	record.replaced_samples.swap(cv->samples);
+	record.replaced_projection = cv->projection;
+	cv->start = world_points.front();
+	cv->end = world_points.back();
+	cv->samples = world_points;
+	cv->projection = record.projection;
+	curve_samples_stale = true;
+	height_field_stale = true;
+
+	shape_deps.mark_dirty(curve.pack());
+	regenerate_dependents();
+	return true;
 }
 
-MString EasyDressTool::create_surface_from_loop(DrawnCurve& cv)
+///
+//  Brings dirty shapes up to date. The scene nodes follow their input
+//  curves through construction history, which Maya evaluates lazily when
+//  they are read back; what the plugin keeps is each shape's bottom level
+//  in the scene BVH. Reading goes through the Maya API and stays on this
+//  thread, in dependency order. The BVH builds, the expensive part, then
+//  run level by level on worker threads, and the results go back into the
+//  scene BVH here.
+///
+void EasyDressTool::regenerate_dependents()
 {
-    std::list<MString> loop;
-    search_loop_from(cv, 0, loop);
-	return MString();
+	std::vector<std::vector<EDDependencyGraph::NodeId>> levels;
+	shape_deps.dirty_levels(levels);
+
+	std::vector<EDGeneratedGeometry> generated;
+	std::unordered_map<EDDependencyGraph::NodeId, size_t> slots;
+	for (auto & level : levels)
+	{
+		for (auto n : level)
+		{
+			auto h = EDHandle::unpack(n);
+			auto shape = drawn_shapes.get(h);
+			if (!shape || shape->kind == kCurveShape) continue;
+
+			generated.emplace_back();
+			if (read_generated(h, generated.back()))
+				slots[n] = generated.size() - 1;
+			else
+				generated.pop_back();
+		}
+	}
+
+	shape_deps.evaluate([&](EDDependencyGraph::NodeId n)
+	{
+		auto slot = slots.find(n);
+		if (slot == slots.end()) return;
+		auto & geometry = generated[slot->second];
+		EDSceneBvh::build_geometry(geometry.blas, geometry.points.data(), geometry.vertex_count, geometry.triangles);
+	}, true);
+
+	for (auto & geometry : generated)
+	{
+		engine.scene().insert_instance(geometry.key, std::move(geometry.blas), geometry.world_matrix);
+	}
 }
 
-void EasyDressTool::search_loop_from(DrawnCurve &cv, int current_depth, std::list<MString>& loop_list)
+// screen-space samples of all drawn curves, for picking the curve a stroke redraws
+// only redone when a curve or the view changed since the last press
+void EasyDressTool::update_curve_samples()
 {
-    for (auto& cv2 : drawn_curves)
-    {
-        if (cv.name == cv2.name) continue;
-        
-        if (cv.end_anchor == cv2.start_anchor)
-        {
-            current_depth++;
-            search_loop_from(cv2, current_depth, loop_list);
-        }
-    }
+	MMatrix model_view, projection_matrix;
+	view.modelViewMatrix(model_view);
+	view.projectionMatrix(projection_matrix);
+	auto view_projection = model_view * projection_matrix;
+	int width = view.portWidth();
+	int height = view.portHeight();
+	if (!curve_samples_stale && curve_samples_view == view_projection
+		&& curve_samples_width == width && curve_samples_height == height)
+	{
+		return;
+	}
+	curve_samples_stale = false;
+	curve_samples_view = view_projection;
+	curve_samples_width = width;
+	curve_samples_height = height;
+
+	curve_sample_ids.clear();
+	curve_samples_2d.clear();
+	double vp[4][4];
+	view_projection.get(vp);
+	std::vector<float> x, y, z, px, py, pz;
+	for (size_t k = 0; k < drawn_shapes.size(); k++)
+	{
+		auto & cv = drawn_shapes.at(k);
+		if (cv.kind != kCurveShape) continue;
+
+		auto h = drawn_shapes.handle_at(k);
+		auto n = cv.samples.size();
+		x.resize(n);
+		y.resize(n);
+		z.resize(n);
+		px.resize(n);
+		py.resize(n);
+		pz.resize(n);
+		for (size_t i = 0; i < n; i++)
+		{
+			x[i] = static_cast<float>(cv.samples[i].x);
+			y[i] = static_cast<float>(cv.samples[i].y);
+			z[i] = static_cast<float>(cv.samples[i].z);
+		}
+		EDRays::to_port(vp, width, height, x.data(), y.data(), z.data(), n, px.data(), py.data(), pz.data());
+		for (size_t i = 0; i < n; i++)
+		{
+			// behind the camera
+			if (px[i] != px[i]) continue;
+			curve_sample_ids.push_back(std::make_pair(h, i));
+			curve_samples_2d.pts.push_back(EDMath::PointCloud<float>::Point(px[i], py[i], 0));
+		}
+	}
+	curve_samples_kd_2d.reset(new EDMath::KDTree2D(2 /*dim*/, curve_samples_2d, nanoflann::KDTreeSingleIndexAdaptorParams(10)));
+	curve_samples_kd_2d->buildIndex();
 }
 
-bool EasyDressTool::is_normal(const std::vector<coord> & screen_points, const std::vector<MPoint> & world_points, const std::vector<bool> & hit_list,
-	    const MFnMesh * selected_mesh) const
+///
+//  Both ends of the stroke must lie on the same drawn curve; i0 and i1 are
+//  the curve samples under them.
+///
+bool EasyDressTool::find_oversketch(const coord & a, const coord & b, EDHandle & curve, size_t & i0, size_t & i1) const
 {
-	if (!selected_mesh)
+	if (!curve_samples_kd_2d || curve_sample_ids.empty())
 	{
 		return false;
 	}
 
-	if (hit_list[0])
-	{
-		// if starting point is normal
-		//unsigned sample_num = 0;
-		auto num_points = screen_points.size();
+	float pa[] = { static_cast<float>(a.h), static_cast<float>(a.v), 0 };
+	float pb[] = { static_cast<float>(b.h), static_cast<float>(b.v), 0 };
+	size_t index_a = 0, index_b = 0;
+	float dist_a = 0, dist_b = 0;
+	curve_samples_kd_2d->knnSearch(pa, 1, &index_a, &dist_a);
+	curve_samples_kd_2d->knnSearch(pb, 1, &index_b, &dist_b);
 
-		MPoint p0 = screen_points[0].toMPoint();
-		MVector current_tang;
-		for (int i = 1; i < tang_samples; i++)
-		{
-			if (i >= num_points) break;
-			current_tang += screen_points[i].toMPoint() - p0;
-			//sample_num++;
-		}
-		current_tang.normalize();
+	auto radius_sq = oversketch_radius * oversketch_radius;
+	if (dist_a > radius_sq || dist_b > radius_sq) return false;
 
-		MPoint closest_point;
-		MVector surface_normal;
-		selected_mesh->getClosestPointAndNormal(world_points[0], closest_point, surface_normal, MSpace::kWorld);
-		surface_normal.normalize();
-		MPoint point_plus_normal = closest_point + surface_normal;
+	auto & sample_a = curve_sample_ids[index_a];
+	auto & sample_b = curve_sample_ids[index_b];
+	if (sample_a.first != sample_b.first || sample_a.second == sample_b.second) return false;
 
-		coord cp0, cp1;
-		view.worldToView(closest_point, cp0.h, cp0.v);
-		view.worldToView(point_plus_normal, cp1.h, cp1.v);
-		MVector norm_proj = cp1.toMPoint() - cp0.toMPoint();
-		norm_proj.normalize();
+	curve = sample_a.first;
+	i0 = sample_a.second;
+	i1 = sample_b.second;
+	return true;
+}
 
-		// * is dot... strange Maya...
-        auto v = 1.0 - (current_tang * norm_proj);
-		return v < normal_threshold;
-	}
+///
+//  Redraws samples i0..i1 of a curve with the stroke and keeps the rest.
+//  Rays are only cast for the new span, and only when the curve was
+//  projected on the body: heights are blended between the cached heights at
+//  i0 and i1. Plane-projected curves reuse their plane.
+///
+bool EasyDressTool::oversketch_curve(EDHandle curve, size_t i0, size_t i1, std::vector<coord> & screen_points)
+{
+	auto cv = drawn_shapes.get(curve);
+	if (!cv) return false;
 
-	// todo: last_hit
+	if (i0 > i1)
+	{
+		std::swap(i0, i1);
+		std::reverse(screen_points.begin(), screen_points.end());
+	}
 
-}
+	auto & old = cv->projection;
+	bool on_body = !old.has_plane && old.heights.size() == cv->samples.size();
+	if (!old.has_plane && !on_body) return false;
+
+	auto stroke = stroke_of(screen_points);
+	stroke.start_known = true;
+	stroke.end_known = true;
+	stroke.start_point = to_vec(cv->samples[i0]);
+	stroke.end_point = to_vec(cv->samples[i1]);
+	float h0 = on_body ? old.heights[i0] : 0;
+	float h1 = on_body ? old.heights[i1] : 0;
+	EDSketchEngine::Result span;
+	if (!engine.project_span(stroke, old, h0, h1, span))
+	{
+		return false;
+	}
 
-//bool EasyDressTool::is_tangent()const
-//{
-//	// FIXME: curvature has problems.
-//	// not very using this function since I am just using SHIFT to force tangent
-//	auto num_points = stroke.size();
-//	double menger_curvature = 0;
-//    unsigned valid_points = 0;
-//	for (int i = 0; i < num_points - 2; i++){
-//        MPoint x = stroke[i].toMPoint();
-//		MPoint y = stroke[i + 1].toMPoint();
-//		MPoint z = stroke[i + 2].toMPoint();
-//		MVector xy = x - y;
-//		MVector zy = z - y;
-//		MVector zx = z - x;
-//		double area = (xy^zy).length();
-//
-//        if (xy.length() == 0 && zy.length() == 0 && zx.length() == 0){
-//            continue;
-//        }
-//
-//		if (xy.length() != 0 && zy.length() != 0 && zx.length() != 0){
-//			menger_curvature += 4 * area / (xy.length()*zy.length()*zx.length());
-//		}
-//        valid_points += 1;
-//	}
-//
-//    if (valid_points == 0) return false;
-//
-//	menger_curvature /= valid_points;
-//	if (menger_curvature <= 0.2){
-//		return true;
-//	}
-//	return false;
-//}
+	auto length = screen_points.size();
+	auto & record = journal.push();
+	record.screen_xy.reserve(length * 2);
+	for (auto & c : screen_points)
+	{
+		record.screen_xy.push_back(c.h);
+		record.screen_xy.push_back(c.v);
+	}
+	record.draw_mode = drawMode;
+	record.start_known = true;
+	record.end_known = true;
+
+	auto & merged = record.world_points;
+	merged.reserve(i0 + length + cv->samples.size() - i1);
+	merged.assign(cv->samples.begin(), cv->samples.begin() + i0);
+	for (auto & p : span.points)
+	{
+		merged.push_back(to_point(p));
+	}
+	merged.insert(merged.end(), cv->samples.begin() + i1 + 1, cv->samples.end());
 
-void EasyDressTool::project_normal(std::vector<coord> & screen_points, std::vector<MPoint>& world_points, const std::vector<bool>& hit_list, const MFnMesh * selected_mesh, std::vector<std::pair<MPoint, MVector>> & rays, bool first_point_known, bool last_point_known)
-{
-	if (!selected_mesh)
+	record.projection = old;
+	if (on_body)
 	{
-		return;
+		auto & heights = record.projection.heights;
+		heights.assign(old.heights.begin(), old.heights.begin() + i0);
+		heights.insert(heights.end(), span.projection.heights.begin(), span.projection.heights.end());
+		heights.insert(heights.end(), old.heights.begin() + i1 + 1, old.heights.end());
 	}
 
-	if (hit_list[0])
+	first_anchor = cv->start_anchor;
+	last_anchor = cv->end_anchor;
+	if (!replace_curve(record, curve))
 	{
+		journal.discard_last();
+		return false;
+	}
+	journal.confirm();
+	trim_journal();
+	setHelpString("Oversketch!");
+	return true;
+}
 
-		MPoint closest_point;
-		MVector surface_normal;
-		selected_mesh->getClosestPointAndNormal(world_points[0], closest_point, surface_normal, MSpace::kWorld);
-		surface_normal.normalize();
+void EasyDressTool::trim_journal()
+{
+	journal.update_memory();
+	scene_writer.drop_oldest(journal.trim());
+}
 
-		auto normal = EDMath::minimumSkewViewplane(rays[0].second, surface_normal);
-		auto point = world_points[0];
-		auto point_num = rays.size();
+void EasyDressTool::undo_stroke()
+{
+	// undo everything the last stroke created as one unit
+	MStringArray removed;
+	if (!journal.can_undo() || !scene_writer.undo_last(removed)) return;
 
-		for (int i = 0; i < point_num; i++)
+	auto record = journal.undo();
+	for (unsigned i = 0; i < removed.length(); i++)
+	{
+		forget_shape(removed[i]);
+	}
+	if (record)
+	{
+		// a stroke that completed a surface cleared the quad; carry on drawing it
+		quad_curves.clear();
+		for (auto h : record->quad_before)
 		{
-			world_points[i] = EDMath::projectOnPlane(point, normal, rays[i].first, rays[i].second);
+			if (drawn_shapes.get(h)) quad_curves.push_back(h);
 		}
+		prev_surf = drawn_shapes.get(record->prev_surf_before) ? record->prev_surf_before : EDHandle();
+	}
+
+	auto cv = record && record->replaced.valid() ? drawn_shapes.get(record->replaced) : nullptr;
+	if (cv)
+	{
+		// the Maya curve came back through the modifier; bring back what we kept about it
+		cv->samples.swap(record->replaced_samples);
+		cv->projection = record->replaced_projection;
+		curve_samples_stale = true;
+		height_field_stale = true;
+		if (!cv->samples.empty())
+		{
+			cv->start = cv->samples.front();
+			cv->end = cv->samples.back();
+		}
+		shape_deps.mark_dirty(record->replaced.pack());
+		regenerate_dependents();
 	}
-	// todo: last hit
 }
+
 ///
-// Find a point on a camera ray that is nearest to the mesh
+//  Rebuilds an undone stroke from its cached world points; no rays are cast.
 ///
-MPoint EasyDressTool::find_point_nearest_to_mesh(const MFnMesh * selected_mesh, const MPoint & ray_origin, const MVector & ray_direction, const coord & screen_coord, float & ret_height) const
+void EasyDressTool::redo_stroke()
 {
-	if (!selected_mesh)
+	auto record = journal.redo();
+	if (!record) return;
+
+	first_anchor = kNoAnchor;
+	last_anchor = kNoAnchor;
+	if (!commit_stroke(*record))
+	{
+		journal.undo();
+	}
+	else
 	{
-		return ray_origin;
+		// it holds the names of the new nodes now
+		journal.update_memory();
 	}
+	first_anchor = kNoAnchor;
+	last_anchor = kNoAnchor;
+}
 
-	float pt[] = { screen_coord.h , screen_coord.v, 0 };
-	size_t out_index = 0;
-	float out_dist_squared = 0;
-	kd_2d->knnSearch(pt, 1, &out_index, &out_dist_squared);
+void EasyDressTool::set_journal_memory_cap(size_t bytes)
+{
+	journal.set_memory_cap(bytes);
+	trim_journal();
+}
+
+size_t EasyDressTool::journal_memory_cap() const
+{
+	return journal.get_memory_cap();
+}
 
-	// nearest point (I am just using vertex for now) on the mesh
-	auto temp = mesh_pts.pts[out_index];
-	MPoint p_on_mesh(temp.x, temp.y, temp.z);
+MStatus EasyDressTool::drawFeedback(MHWRender::MUIDrawManager & drawMgr, const MHWRender::MFrameContext & context)
+{
+	//draw_stroke(drawMgr);
+	return MStatus::kSuccess;
+}
+
+///
+//  Returns the anchor near a screen point, or kNoAnchor
+///
+size_t EasyDressTool::do_snap(const MPoint & input_end_point)
+{
+	const float radius = 5;
 
-	auto dist = (ray_direction * (p_on_mesh - ray_origin));
-	if (dist < 0)
+	if (!anchors_kd_2d || anchors.empty())
 	{
-		return ray_origin;
+		return kNoAnchor;
 	}
 
-	auto p_on_ray = ray_origin + dist * ray_direction;
+	float pt[] = { input_end_point.x , input_end_point.y, 0 };
+	
+	size_t out_index = 0;
+	float out_dist_squared = 0;
+	anchors_kd_2d->knnSearch(pt, 1, &out_index, &out_dist_squared);
 
-	ret_height = (p_on_ray - p_on_mesh).length();
+	if (out_dist_squared < radius * radius && out_index < anchors.size())
+	{
+		return anchors[out_index];
+	}
 
-	return p_on_ray;
+	return kNoAnchor;
 }
 
+void EasyDressTool::completeAction()
+{
+}
 
-
-void EasyDressTool::project_contour(std::vector<coord> & screen_points, std::vector<MPoint>& world_points, const std::vector<bool>& hit_list, const MFnMesh * selected_mesh, std::vector<std::pair<MPoint, MVector>>& rays,bool first_point_known, bool last_point_known)
+void EasyDressTool::deleteAction()
 {
-	if (!selected_mesh || !kd_2d || world_points.size() < 2)
-	{
-		return;
-	}
+	undo_stroke();
+}
 
-	// TODO: with shape matching
-	// TODO: find nearest point on mesh, not vertex
+void EasyDressTool::forget_shape(const MString & name)
+{
+	if (name == "") return;
 
-	auto length = rays.size();
-	float dummy;
-	auto s0 = find_point_nearest_to_mesh(selected_mesh, rays[0].first, rays[0].second, screen_points[0], dummy);
-	auto sn = find_point_nearest_to_mesh(selected_mesh, rays[length - 1].first, rays[length - 1].second, screen_points[length - 1], dummy);
+	auto h = drawn_shapes.find(name);
+	auto shape = drawn_shapes.get(h);
+	if (!shape) return;
 
-	if (first_point_known)
+	if (shape->kind == kCurveShape)
 	{
-		s0 = world_points[0];
+		curve_samples_stale = true;
+		height_field_stale = true;
+		anchor_graph.remove_edge(h.pack());
+		release_anchor(shape->start_anchor);
+		release_anchor(shape->end_anchor);
+
+		// step back quad cache
+		quad_curves.erase(std::remove(quad_curves.begin(), quad_curves.end(), h), quad_curves.end());
 	}
-	if (last_point_known)
+
+	if (prev_surf == h)
 	{
-		sn = world_points[length - 1];
+		prev_surf = EDHandle();
 	}
+	if (!shape->scene_key.empty()) engine.scene().remove_instance(shape->scene_key);
+	shape_deps.remove_node(h.pack());
+	drawn_shapes.remove(h);
+}
 
-	if (s0.isEquivalent(sn)) return;
-
-	auto d = (sn - s0).normal();
-	auto normal = EDMath::minimumSkewViewplane(rays[0].second, d);
-
-	world_points[0] = s0;
-	world_points[length - 1] = sn;
+///
+//  The engine classifies and projects the stroke; the tool only brings the
+//  height fields up to date first and reports what the stroke became.
+///
+bool EasyDressTool::project_stroke(const std::vector<coord> & screen_points, bool start_known, bool end_known, const MPoint & start_point, const MPoint & end_point, std::vector<MPoint> & world_points, bool & projecting_normal, bool tangent_mode, bool normal_mode)
+{
+	projecting_normal = false;
+	world_points.clear();
+	projection.clear();
+
+	auto stroke = stroke_of(screen_points);
+	stroke.start_known = start_known;
+	stroke.end_known = end_known;
+	stroke.start_point = to_vec(start_point);
+	stroke.end_point = to_vec(end_point);
+	stroke.tangent_mode = tangent_mode;
+	stroke.normal_mode = normal_mode;
+
+	update_height_field();
+	EDSketchEngine::Result result;
+	if (!engine.project(stroke, result))
+	{
+		return false;
+	}
 
-	for (int i = 1; i < length - 1; i++)
+	switch (result.strategy)
 	{
-		world_points[i] = EDMath::projectOnPlane(s0, normal, rays[i].first, rays[i].second);
+	case EDSketchEngine::kContour:
+		setHelpString("Classified: Shell Contour!");
+		break;
+	case EDSketchEngine::kNormalPlane:
+		projecting_normal = true;
+		setHelpString("Classified: Normal!");
+		break;
+	case EDSketchEngine::kTangentPlane:
+		setHelpString("Classified: Tangent Plane!");
+		break;
+	default:
+		setHelpString("Classified: Shell Projection!");
+		break;
 	}
 
+	world_points.reserve(result.points.size());
+	for (auto & p : result.points)
+	{
+		world_points.push_back(to_point(p));
+	}
+	projection = result.projection;
+	return true;
 }
 
-double interpolate_height(const MPoint& p, const MPoint& p_start, const MPoint& p_end, double h_start, double h_end)
+EDHandle EasyDressTool::record_curve(const MString & curve_name, const EDStrokeRecord & record)
 {
-	auto w1 = (p - p_start).length();
-	auto w2 = (p - p_end).length();
+	auto & world_points = record.world_points;
+	auto cv = DrawnCurve(world_points[0], world_points[world_points.size() - 1], curve_name);
+	cv.start_anchor = acquire_anchor(first_anchor, cv.start);
+	cv.end_anchor = acquire_anchor(last_anchor, cv.end);
+	cv.samples = world_points;
+	cv.projection = record.projection;
+	auto h = drawn_shapes.add(cv);
+	curve_samples_stale = true;
+	anchor_graph.add_edge(h.pack(), cv.start_anchor, cv.end_anchor);
+
+	if (!record.projecting_normal)
+	{
+		quad_curves.push_back(h);
+	}
+	return h;
+}
 
-	return (w2 * h_start + w1 * h_end) / (w1 + w2);
+EDHandle EasyDressTool::record_shape(EDShapeKind kind, const MString & name)
+{
+	if (name == "") return EDHandle();
 
+	auto shape = DrawnCurve(MPoint(), MPoint(), name);
+	shape.kind = kind;
+	return drawn_shapes.add(shape);
 }
 
-///                 
-// Shell Projection
 ///
-void EasyDressTool::project_shell(std::vector<coord> & screen_points, std::vector<MPoint> & world_points, const std::vector<bool> & hit_list, const MFnMesh * selected_mesh, std::vector<std::pair<MPoint, MVector>> & rays, bool first_point_known, bool last_point_known)
+//  Finds the shortest chain of drawn curves from end back to start.
+//  Together with a new curve from start to end it forms a closed loop.
+//  reversed[k] is set for the curves that run against the chain, from the
+//  anchor it leaves towards the one it came from.
+///
+bool EasyDressTool::find_loop(size_t start, size_t end, std::vector<EDHandle> & loop_curves, std::vector<bool> & reversed) const
 {
-	// TODO: for intersection: find all points in distance 2h
-	// TODO: get all triangles connected to the points by MFnMesh:getTriangles()
-	// TODO: extrude them by h, connect them.
-	// TODO: cast the ray again and find the intersection
+	loop_curves.clear();
+	reversed.clear();
+	if (start == kNoAnchor || end == kNoAnchor || start == end) return false;
 
-	if (!selected_mesh || !kd_2d || world_points.size() < 2)
+	std::vector<EDAnchorGraph::EdgeId> path;
+	if (!anchor_graph.find_path(end, start, path, max_loop_sides - 1)) return false;
+
+	auto at = end;
+	for (auto e : path)
 	{
-		return;
+		auto h = EDHandle::unpack(e);
+		auto cv = drawn_shapes.get(h);
+		if (!cv) return false;
+		bool backwards = cv->start_anchor != at;
+		loop_curves.push_back(h);
+		reversed.push_back(backwards);
+		at = backwards ? cv->start_anchor : cv->end_anchor;
 	}
+	return true;
+}
 
-	// TODO: snaping to a known height and do interpolation
-
-	auto length = rays.size();
-	float start_height = 0, end_height = 0;
-	//MPoint s0 = world_points[0];
-	//MPoint sn = world_points[length - 1];
-	//int iter_start = 0, iter_end = length;
-
-	if (!hit_list[0] && !first_point_known)
+///
+//  weld_tolerance if set, else a fraction of the snapshot's bounding box, so
+//  welding means the same on an earring as on a whole character. The hash
+//  cells follow the radius; the anchors are hashed again when it changes.
+///
+void EasyDressTool::update_weld_radius()
+{
+	auto radius = weld_tolerance;
+	if (radius <= 0)
 	{
-		world_points[0] = find_point_nearest_to_mesh(selected_mesh, rays[0].first, rays[0].second, screen_points[0], start_height);
+		// a scene without a mesh keeps the last radius
+		if (engine.surfaces().empty() || weld_revision == engine.surfaces().revision()) return;
+		weld_revision = engine.surfaces().revision();
+
+		radius = weld_fraction * engine.surfaces().diagonal();
+		if (radius <= 0) return;
 	}
-	start_height = static_cast<double>(EDMath::distance_to_mesh(selected_mesh, world_points[0]));
+	if (radius == weld_radius) return;
 
-	if (!hit_list[length - 1] && !last_point_known)
+	weld_radius = radius;
+	anchor_hash.reset(weld_radius);
+	for (size_t a = 0; a < anchor_pool.slot_count(); a++)
 	{
-		world_points[length - 1] = find_point_nearest_to_mesh(selected_mesh, rays[length - 1].first, rays[length - 1].second, screen_points[length - 1], end_height);
+		if (!anchor_pool.alive(a)) continue;
+		auto & p = anchor_pool[a].point_3D;
+		anchor_hash.insert(a, p.x, p.y, p.z);
 	}
+}
 
-	end_height = static_cast<double>(EDMath::distance_to_mesh(selected_mesh, world_points[length - 1]));
+///
+//  Snaps unanchored curve ends onto existing anchors within weld_radius,
+//  so near-coincident ends are shared and close loops.
+///
+void EasyDressTool::weld_ends(std::vector<MPoint> & world_points)
+{
+	if (world_points.empty()) return;
 
-	int first_miss = -1, last_miss = -1;
-	for (size_t i = 1; i <= length - 2; i++)
+	if (first_anchor == kNoAnchor)
 	{
-		if (!hit_list[i])
+		auto a = weld_anchor(world_points.front());
+		if (a != kNoAnchor && a != last_anchor)
 		{
-			if (first_miss == -1)
-				first_miss = i;
-			last_miss = i;
+			first_anchor = a;
+			world_points.front() = anchor_pool[a].point_3D;
 		}
-		else
+	}
+	if (last_anchor == kNoAnchor)
+	{
+		auto a = weld_anchor(world_points.back());
+		if (a != kNoAnchor && a != first_anchor)
 		{
-			// TODO: known heights other than h0 and hn.
-			auto h = interpolate_height(rays[i].first, rays[0].first, rays[length - 1].first, start_height, end_height);
-			world_points[i] = (-rays[i].second) * h + world_points[i];
-
-			if (first_miss != -1 && last_miss != -1)
-			{
-                auto plane_normal = EDMath::minimumSkewViewplane(rays[first_miss - 1].second
-                    , world_points[last_miss + 1] - world_points[first_miss - 1]);
-				for (size_t j = first_miss; j <= last_miss; j++)
-				{
-                    world_points[j] = EDMath::projectOnPlane(world_points[first_miss - 1], plane_normal, rays[j].first, rays[j].second);
-				}
-			}
-			first_miss = -1;
-			last_miss = -1;
+			last_anchor = a;
+			world_points.back() = anchor_pool[a].point_3D;
 		}
 	}
-	if (first_miss != -1 && last_miss != -1)
+}
+
+size_t EasyDressTool::weld_anchor(const MPoint & p) const
+{
+	size_t out = kNoAnchor;
+	if (anchor_hash.find_nearest(p.x, p.y, p.z, weld_radius, out))
 	{
-        auto plane_normal = EDMath::minimumSkewViewplane(rays[first_miss - 1].second
-            , world_points[last_miss + 1] - world_points[first_miss - 1]);
-        for (size_t j = first_miss; j <= last_miss; j++)
-        {
-            world_points[j] = EDMath::projectOnPlane(world_points[first_miss - 1], plane_normal, rays[j].first, rays[j].second);
-        }
+		return out;
 	}
+	return kNoAnchor;
 }
-// tangent projection
-void EasyDressTool::project_tangent(std::vector<coord> & screen_points, std::vector<MPoint> & world_points, const std::vector<bool> & hit_list, const MFnMesh * selected_mesh, std::vector<std::pair<MPoint, MVector>> & rays, bool first_point_known, bool last_point_known)
+
+///
+//  Takes a reference on anchor, creating one at p if there is none
+///
+size_t EasyDressTool::acquire_anchor(size_t anchor, const MPoint & p)
 {
-	if (!selected_mesh || !kd_2d || world_points.size() < 2) {
-		return;
-	}
-	auto length = rays.size();
-
-	//bool first_point_known = false, last_point_known = false;
-	//if (drawing_quad)
-	//{
-	//	if (prev_curves.size() >= 1)
-	//	{
-	//		world_points[0] = prev_curve_start_end.back().second;
-	//		//start_height = static_cast<double>(EDMath::distance_to_mesh(selected_mesh, world_points[0]));
-	//		// TODO: height
-	//		first_point_known = true;
-	//	}
-
-	//	if (prev_curves.size() >= 3)
-	//	{
-	//		world_points[length - 1] = prev_curve_start_end.front().first;
-	//		//end_height = static_cast<double>(EDMath::distance_to_mesh(selected_mesh, world_points[length - 1]));
-	//		last_point_known = true;
-	//	}
-	//}
-	
-	//determine the height of the tangent plane and the middle point on that plane
-	//assume the average height is the height of the middle point
-	float h = 0.0;
-	int mid_index = int(length / 2);
-	MPoint nearest_point = find_point_nearest_to_mesh(selected_mesh, rays[mid_index].first, rays[mid_index].second, screen_points[mid_index], h);
-	MPoint middle_point = (-rays[mid_index].second)*h + world_points[mid_index];
-
-	//project each stroke points on the base layer and get each normal
-	MVector normal;
-	MPoint closest_point;
-	MVector sum_normal = MVector(0.0, 0.0, 0.0);
-
-	for (int i = 0; i < length; i++) {
-		selected_mesh->getClosestPointAndNormal(world_points[i], closest_point, normal, MSpace::kWorld);
-		sum_normal += normal;
-	}
-	//calculate the average normal as the tangent plane normal
-	sum_normal = MVector(sum_normal.x / length, sum_normal.y / length, sum_normal.z / length);
-	MVector plane_normal = sum_normal.normal();
-	//project all the point on to the tangent plane
-	for (int i = 0; i < length; i++) {
-		world_points[i] = (-rays[i].second) * h + world_points[i];
-		world_points[i] = EDMath::projectOnPlane(middle_point, plane_normal, rays[i].first, rays[i].second);
+	if (anchor == kNoAnchor || !anchor_pool.alive(anchor))
+	{
+		anchor = anchor_pool.create(EDAnchor(MPoint(), p));
+		anchor_hash.insert(anchor, p.x, p.y, p.z);
 	}
-	
+	anchor_pool.retain(anchor);
+	return anchor;
 }
 
-void EasyDressTool::rebuild_kd(const MFnMesh * selected_mesh)
+void EasyDressTool::release_anchor(size_t anchor)
 {
-	mesh_pts.clear();
-	mesh_pts_2d.clear();
-	if (!selected_mesh)
+	if (anchor == kNoAnchor || !anchor_pool.alive(anchor)) return;
+
+	auto p = anchor_pool[anchor].point_3D;
+	if (anchor_pool.release(anchor))
 	{
-		kd_2d = nullptr;
-		return;
+		anchor_hash.remove(anchor, p.x, p.y, p.z);
+		// its slot may be reused by an anchor elsewhere
+		height_field_stale = true;
 	}
-	MPointArray pts_array;
-	selected_mesh->getPoints(pts_array, MSpace::kWorld);
+}
 
-	auto length = pts_array.length();
+///
+//  boundary only takes 3 or 4 curves, so longer loops are first attached
+//  into 4 sides. attachCurve joins the end of one curve to the start of the
+//  next, so curves running against the loop are reversed first.
+///
+EDSceneWriter::Op EasyDressTool::queue_surface(const std::vector<std::string> & loop, const std::vector<bool> & reversed)
+{
+	if (loop.size() < 3)
+	{
+		return EDSceneWriter::kInvalidOp;
+	}
+	if (loop.size() <= 4)
+	{
+		return scene_writer.add_surface(loop);
+	}
 
-	mesh_pts.pts.resize(length);
-	for (int i = 0; i < length; i++)
+	std::vector<std::string> sides;
+	auto n = loop.size();
+	for (size_t k = 0; k < 4; k++)
 	{
-		mesh_pts.pts[i].x = pts_array[i].x;
-		mesh_pts.pts[i].y = pts_array[i].y;
-		mesh_pts.pts[i].z = pts_array[i].z;
+		auto begin = k * n / 4, end = (k + 1) * n / 4;
+		if (end - begin == 1)
+		{
+			sides.push_back(loop[begin]);
+			continue;
+		}
+
+		std::vector<std::string> side;
+		for (auto i = begin; i < end; i++)
+		{
+			side.push_back(reversed[i] ? EDSceneWriter::ref(scene_writer.add_reversed_curve(loop[i])) : loop[i]);
+		}
+		sides.push_back(EDSceneWriter::ref(scene_writer.add_attached_curve(side)));
 	}
+	return scene_writer.add_surface(sides);
+}
+
+//bool EasyDressTool::is_tangent()const
+//{
+//	// FIXME: curvature has problems.
+//	// not very using this function since I am just using SHIFT to force tangent
+//	auto num_points = stroke.size();
+//	double menger_curvature = 0;
+//    unsigned valid_points = 0;
+//	for (int i = 0; i < num_points - 2; i++){
+//        MPoint x = stroke[i].toMPoint();
+//		MPoint y = stroke[i + 1].toMPoint();
+//		MPoint z = stroke[i + 2].toMPoint();
+//		MVector xy = x - y;
+//		MVector zy = z - y;
+//		MVector zx = z - x;
+//		double area = (xy^zy).length();
+//
+//        if (xy.length() == 0 && zy.length() == 0 && zx.length() == 0){
+//            continue;
+//        }
+//
+//		if (xy.length() != 0 && zy.length() != 0 && zx.length() != 0){
+//			menger_curvature += 4 * area / (xy.length()*zy.length()*zx.length());
+//		}
+//        valid_points += 1;
+//	}
+//
+//    if (valid_points == 0) return false;
+//
+//	menger_curvature /= valid_points;
+//	if (menger_curvature <= 0.2){
+//		return true;
+//	}
+//	return false;
+//}
 
-	mesh_pts_2d.pts.resize(length);
-	for (int i = 0; i < length; i++)
+///
+//  Sites are the feet of every anchor and every projected curve sample,
+//  each in the field of the selected mesh nearest it. Curves projected as
+//  shells keep the heights they were drawn at; the rest are measured from
+//  that mesh. Only anchors and curves not in the fields yet are measured;
+//  everything is measured again after a removal or when a selected mesh
+//  changes.
+///
+void EasyDressTool::update_height_field()
+{
+	if (height_field_stale || height_field_revision != engine.surfaces().revision() || engine.surfaces().empty())
 	{
-		short x, y;
-		view.worldToView(pts_array[i], x, y);
-		mesh_pts_2d.pts[i].x = x;
-		mesh_pts_2d.pts[i].y = y;
-		mesh_pts_2d.pts[i].z = 0;
+		engine.surfaces().clear_heights();
+		height_sites.clear();
+		height_field_stale = false;
+		height_field_revision = engine.surfaces().revision();
 	}
+	if (engine.surfaces().empty()) return;
 
-	kd_2d.reset(new EDMath::KDTree2D(2 /*dim*/, mesh_pts_2d, nanoflann::KDTreeSingleIndexAdaptorParams(10)));
-	kd_2d->buildIndex();
+	auto add_site = [&](const MPoint & p, float known_height)
+	{
+		float q[3];
+		to_floats(p, q);
+		engine.surfaces().add_height_site(q, known_height);
+	};
+
+	// anchors and curve handles share the key space, anchors with the top bit set
+	const uint64_t anchor_key = 1ull << 63;
+	for (size_t a = 0; a < anchor_pool.slot_count(); a++)
+	{
+		if (!anchor_pool.alive(a) || !height_sites.insert(anchor_key | a).second) continue;
+		add_site(anchor_pool[a].point_3D, -1);
+	}
+	for (size_t k = 0; k < drawn_shapes.size(); k++)
+	{
+		auto & cv = drawn_shapes.at(k);
+		if (cv.kind != kCurveShape) continue;
+		if (!height_sites.insert(drawn_shapes.handle_at(k).pack()).second) continue;
 
+		auto & known = cv.projection.heights;
+		bool has_heights = known.size() == cv.samples.size();
+		for (size_t i = 0; i < cv.samples.size(); i++)
+		{
+			add_site(cv.samples[i], has_heights ? known[i] : -1);
+		}
+	}
+	engine.surfaces().build_heights();
 }
 
 void EasyDressTool::append_stroke(short x, short y)
@@ -967,16 +1453,15 @@ void EasyDressTool::update_anchors()
 {
 	anchors.clear();
 	anchors_2d.clear();
-	for (auto & curve : drawn_curves)
+	for (size_t i = 0; i < anchor_pool.slot_count(); i++)
 	{
+		if (!anchor_pool.alive(i)) continue;
+
+		auto & anchor = anchor_pool[i];
 		short x, y;
-		view.worldToView(curve.start, x, y);
-        curve.start_anchor->point_2D = MPoint(x, y, 0);
-		anchors.push_back(curve.start_anchor);
-		anchors_2d.pts.push_back(EDMath::PointCloud<float>::Point(x, y, 0));
-		view.worldToView(curve.end, x, y);
-        curve.end_anchor->point_2D = MPoint(x, y, 0);
-        anchors.push_back(curve.end_anchor);
+		view.worldToView(anchor.point_3D, x, y);
+		anchor.point_2D = MPoint(x, y, 0);
+		anchors.push_back(i);
 		anchors_2d.pts.push_back(EDMath::PointCloud<float>::Point(x, y, 0));
 	}
 	anchors_kd_2d.reset(new EDMath::KDTree2D(2 /*dim*/, anchors_2d, nanoflann::KDTreeSingleIndexAdaptorParams(10)));
@@ -997,9 +1482,9 @@ void EasyDressTool::draw_stroke(MHWRender::MUIDrawManager& drawMgr)
 	}
 	drawMgr.setColor(anchor_color);
 	drawMgr.setLineWidth(1);
-	for (auto & anchor : anchors)
+	for (auto anchor : anchors)
 	{
-		drawMgr.circle2d(anchor->point_2D, 4, false);
+		drawMgr.circle2d(anchor_pool[anchor].point_2D, 4, false);
 	}
 	drawMgr.endDrawable();
 }
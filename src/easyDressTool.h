@@ -24,15 +24,30 @@
 #include <maya/MGlobal.h>
 #include <maya/M3dView.h>
 #include <maya/MPoint.h>
+#include <maya/MMatrix.h>
 
 #include "EDMath.h"
+#include "EDSceneWriter.h"
+#include "EDAnchorGraph.h"
+#include "EDPool.h"
+#include "EDSpatialHash.h"
+#include "EDSlotMap.h"
+#include "EDJournal.h"
+#include "EDStrokeRecord.h"
+#include "EDDependencyGraph.h"
+#include "EDProjection.h"
+#include "EDSketchEngine.h"
 
+#include <algorithm>
 #include <vector>
 #include <List>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 
-class MFnMesh;
-class EDAnchor;
+class MDagPath;
 
 class coord {
 public:
@@ -48,26 +63,87 @@ enum EDDrawMode
 	kTangent,
 };
 
+struct EDAnchor
+{
+	//TODO: snap to anywhere on current curves
+	MPoint point_2D;
+	MPoint point_3D;
+
+	EDAnchor() = default;
+	EDAnchor(const MPoint & point_2D, const MPoint & point_3D) : point_2D(point_2D), point_3D(point_3D) {}
+};
+
+typedef EDPool<EDAnchor> EDAnchorPool;
+const size_t kNoAnchor = EDAnchorPool::kNone;
+
+enum EDShapeKind
+{
+	kCurveShape,
+	kSurfaceShape,
+	kVolumeShape,
+};
+
 struct DrawnCurve
 {
+	EDShapeKind kind = kCurveShape;
 	MPoint start;
 	MPoint end;
 	MString name;
 	
-	std::shared_ptr<EDAnchor> start_anchor = nullptr;
-	std::shared_ptr<EDAnchor> end_anchor = nullptr;
+	// indices into the anchor pool
+	size_t start_anchor = kNoAnchor;
+	size_t end_anchor = kNoAnchor;
+
+	// projected stroke samples and how they were projected, for oversketching
+	std::vector<MPoint> samples;
+	EDProjectionData projection;
+
+	// full DAG path of a generated surface or volume, its key in the scene BVH
+	std::string scene_key;
 
 	DrawnCurve(const MPoint & start, const MPoint & end, const MString & name);
 };
 
-struct EDAnchor
+///
+//  Every shape the tool has created, in one slot map.
+//  O(1) lookup by handle or by scene name.
+///
+class EDShapeStore
 {
-	//TODO: snap to anywhere on current curves
-	MPoint point_2D;
-	MPoint point_3D;
+public:
+	EDHandle add(const DrawnCurve & shape);
+	bool remove(EDHandle h);
+	void clear();
 
-	EDAnchor() = default;
-	EDAnchor(const MPoint & point_2D, const MPoint & point_3D) : point_2D(point_2D), point_3D(point_3D) {}
+	EDHandle find(const MString & name) const;
+	DrawnCurve * get(EDHandle h) { return shapes.get(h); }
+	const DrawnCurve * get(EDHandle h) const { return shapes.get(h); }
+
+	size_t size() const { return shapes.size(); }
+	// the i-th shape in iteration order and its handle, for walking the store without name lookups
+	DrawnCurve & at(size_t i) { return shapes.begin()[i]; }
+	EDHandle handle_at(size_t i) const { return shapes.handle_at(i); }
+	EDSlotMap<DrawnCurve>::iterator begin() { return shapes.begin(); }
+	EDSlotMap<DrawnCurve>::iterator end() { return shapes.end(); }
+
+private:
+	EDSlotMap<DrawnCurve> shapes;
+	std::unordered_map<std::string, EDHandle> by_name;
+};
+
+///
+//  A generated surface or volume read back from the scene, in world space
+//  or with its matrix. Reading goes through the Maya API; building blas
+//  from it does not, so that part can run on worker threads.
+///
+struct EDGeneratedGeometry
+{
+	std::string key;
+	std::vector<float> points;
+	size_t vertex_count = 0;
+	std::vector<int> triangles;
+	double world_matrix[4][4];
+	EDBvh blas;
 };
 
 class EasyDressTool : public MPxContext
@@ -86,6 +162,26 @@ public:
 	virtual void completeAction() override;
 	virtual void deleteAction() override;
 
+	// stroke history, also driven by the context command
+	void undo_stroke();
+	void redo_stroke();
+	void set_journal_memory_cap(size_t bytes);
+	size_t journal_memory_cap() const;
+	// hit tests against a per-view raster of the mesh instead of ray casts
+	void set_raster_hit_test(bool enabled) { engine.set_raster_hit_test(enabled); }
+	bool raster_hit_test_enabled() const { return engine.raster_hit_test(); }
+	void set_projection_layer(int layer) { projection_layer = std::max(layer, 0); }
+	int get_projection_layer() const { return projection_layer; }
+	// strokes drawn between the two ends of a curve replace it instead of adding one
+	void set_resketch(bool enabled) { resketch_enabled = enabled; }
+	bool get_resketch() const { return resketch_enabled; }
+	// strokes starting and ending on one drawn curve redraw that span of it
+	void set_oversketch(bool enabled) { oversketch_enabled = enabled; }
+	bool get_oversketch() const { return oversketch_enabled; }
+	// curve ends closer than this weld onto one anchor; 0 scales it with the selected meshes
+	void set_weld_tolerance(double tolerance) { weld_tolerance = std::max(tolerance, 0.0); weld_revision = 0; }
+	double get_weld_tolerance() const { return weld_tolerance; }
+
 private:
 
 	void clear_quad_cache();
@@ -93,20 +189,33 @@ private:
 	void update_anchors();
 	void draw_stroke(MHWRender::MUIDrawManager& drawMgr);
 	//void draw_anchors(MHWRender::MUIDrawManager& drawMgr);
-	bool is_normal(const std::vector<coord> & screen_points, const std::vector<MPoint> & world_points, const std::vector<bool> & hit_list, const MFnMesh * selected_mesh) const;
 	//bool is_tangent() const;
 	size_t do_snap(const MPoint & input_end_point);
-	MString create_curve(std::vector<coord> & screen_points, MFnMesh* selected_mesh, bool start_known, bool end_known, const MPoint& start_point, MPoint& end_point, bool tangent_mode = false, bool normal_mode = false);
-    MString create_surface_from_loop(DrawnCurve& cv);
-    std::list<MString> search_loop_from(DrawnCurve &cv, int current_depth, std::list<MString>& loop_list);
-    void project_normal(std::vector<coord> & screen_points, std::vector<MPoint> & world_points, const std::vector<bool> & hit_list, const MFnMesh * selected_mesh, std::vector<std::pair<MPoint, MVector>> & rays, bool first_point_known, bool last_point_known);
-	void project_tangent(std::vector<coord> & screen_points, std::vector<MPoint> & world_points, const std::vector<bool> & hit_list, const MFnMesh * selected_mesh, std::vector<std::pair<MPoint, MVector>> & rays, bool first_point_known, bool last_point_known);
-	void project_contour(std::vector<coord> & screen_points, std::vector<MPoint> & world_points, const std::vector<bool> & hit_list, const MFnMesh * selected_mesh, std::vector<std::pair<MPoint, MVector>> & rays, bool first_point_known, bool last_point_known);
-	void project_shell(std::vector<coord> & screen_points, std::vector<MPoint> & world_points, const std::vector<bool> & hit_list, const MFnMesh * selected_mesh, std::vector<std::pair<MPoint, MVector>> & rays, bool first_point_known, bool last_point_known);
-	MPoint find_point_nearest_to_mesh(const MFnMesh * selected_mesh, const MPoint & ray_origin, const MVector & ray_direction, const coord & screen_coord, float & ret_height) const;
-	void rebuild_kd_2d();
-	//void rebuild_kd_3d();
-	void rebuild_kd(const MFnMesh * selected_mesh);
+	bool project_stroke(const std::vector<coord> & screen_points, bool start_known, bool end_known, const MPoint & start_point, const MPoint & end_point, std::vector<MPoint> & world_points, bool & projecting_normal, bool tangent_mode = false, bool normal_mode = false);
+	void sketch_stroke(MEvent & event);
+	bool commit_stroke(EDStrokeRecord & record);
+	void trim_journal();
+	EDHandle record_curve(const MString & curve_name, const EDStrokeRecord & record);
+	EDHandle record_shape(EDShapeKind kind, const MString & name);
+	void forget_shape(const MString & name);
+	bool find_loop(size_t start, size_t end, std::vector<EDHandle> & loop_curves, std::vector<bool> & reversed) const;
+	bool replace_curve(EDStrokeRecord & record, EDHandle curve);
+	void regenerate_dependents();
+	void update_curve_samples();
+	bool find_oversketch(const coord & a, const coord & b, EDHandle & curve, size_t & i0, size_t & i1) const;
+	bool oversketch_curve(EDHandle curve, size_t i0, size_t i1, std::vector<coord> & screen_points);
+	void get_selected_meshes(std::vector<MDagPath> & meshes) const;
+	void update_surfaces(const std::vector<MDagPath> & meshes);
+	void update_scene_bvh(const std::vector<MDagPath> & meshes);
+	void insert_generated(EDHandle shape);
+	bool read_generated(EDHandle shape, EDGeneratedGeometry & geometry);
+	void update_height_field();
+	void update_weld_radius();
+	void weld_ends(std::vector<MPoint> & world_points);
+	size_t weld_anchor(const MPoint & p) const;
+	size_t acquire_anchor(size_t anchor, const MPoint & p);
+	void release_anchor(size_t anchor);
+	EDSceneWriter::Op queue_surface(const std::vector<std::string> & loop, const std::vector<bool> & reversed);
     
 
 
@@ -121,29 +230,76 @@ private:
 	//MGlobal::ListAdjustment	listAdjustment;
 
 	M3dView view;
-	double normal_threshold = 0.15;
-	int tang_samples = 3;
 	EDDrawMode drawMode = EDDrawMode::kDefault;
 
-	EDMath::PointCloud<float> mesh_pts;
-	EDMath::PointCloud<float> mesh_pts_2d;
+	// classifies and projects strokes onto the selected meshes as of the
+	// last release (each with its snapshot, normals, shells, heights and
+	// geodesics) and the surfaces and volumes the tool made on them
+	EDSketchEngine engine;
+	// anchors and curves whose heights are in the surfaces' height fields;
+	// new ones are added as they come, removed or reshaped ones and new
+	// snapshots rebuild them all
+	std::unordered_set<uint64_t> height_sites;
+	unsigned height_field_revision = 0;
+	bool height_field_stale = true;
+	// grid a generated NURBS patch is sampled on, per direction
+	int generated_grid = 16;
+	// which surface along the ray strokes land on, 0 being the front one;
+	// set with -projectionLayer and held for the length of a stroke
+	int projection_layer = 0;
+
+	// curves, surfaces and volumes the tool created
+	EDShapeStore drawn_shapes;
+
+	// surfaces depend on their boundary curves, volumes on their surface
+	EDDependencyGraph shape_deps;
 
-	// kd tree for finding nearest point on mesh
-	std::unique_ptr<EDMath::KDTree2D> kd_2d = nullptr;
+	// curves of the quad being drawn, in order
+	std::vector<EDHandle> quad_curves;
+	EDHandle prev_surf;
 
-    // TODO: delete these hack
-	std::list<MString> prev_curves;
-	std::list<std::pair<MPoint, MPoint>> prev_curve_start_end;
-    MString prev_surf;
+	// which curves meet at which anchors, for finding closed loops
+	EDAnchorGraph anchor_graph;
+	size_t max_loop_sides = 8;
 
-	std::list<DrawnCurve> drawn_curves;
+	// all anchors live in one pool; anchor_hash welds nearby curve ends
+	EDAnchorPool anchor_pool;
+	EDSpatialHash anchor_hash;
+	// set with -weldTolerance; when 0, weld_radius is weld_fraction of the
+	// selected meshes' bounding box diagonal
+	double weld_tolerance = 0;
+	double weld_fraction = 0.005;
+	double weld_radius = 0.1;
+	unsigned weld_revision = 0;
 
-	std::vector<std::shared_ptr<EDAnchor>> anchors; 
+	// anchors visible for snapping, parallel to anchors_2d
+	std::vector<size_t> anchors;
 	EDMath::PointCloud<float> anchors_2d;
 	std::unique_ptr<EDMath::KDTree2D> anchors_kd_2d = nullptr;
 
+	bool resketch_enabled = false;
+
+	// samples of every drawn curve in screen space, parallel to curve_sample_ids
+	bool oversketch_enabled = false;
+	float oversketch_radius = 8;
+	std::vector<std::pair<EDHandle, size_t>> curve_sample_ids;
+	EDMath::PointCloud<float> curve_samples_2d;
+	std::unique_ptr<EDMath::KDTree2D> curve_samples_kd_2d = nullptr;
+	// the view they were projected for; set stale when a curve changes
+	bool curve_samples_stale = true;
+	MMatrix curve_samples_view;
+	int curve_samples_width = 0;
+	int curve_samples_height = 0;
+
+	// filled by project_stroke for the stroke being projected
+	EDProjectionData projection;
+
 	bool first_anchored = false;
-    std::shared_ptr<EDAnchor> first_anchor = nullptr;
-    std::shared_ptr<EDAnchor> last_anchor = nullptr;
-	std::list<MString> drawn_shapes;
+	size_t first_anchor = kNoAnchor;
+	size_t last_anchor = kNoAnchor;
+
+	// all scene edits of a stroke go through here
+	EDSceneWriter scene_writer;
+	// one record per committed batch of scene_writer
+	EDJournal<EDStrokeRecord> journal;
 };
@@ -22,8 +22,11 @@
 #include <maya/MFnPlugin.h>
 #include <maya/MGlobal.h>
 #include <maya/MPxContextCommand.h>
+#include <maya/MSyntax.h>
+#include <maya/MArgParser.h>
 
 #include "EasyDressTool.h"
+#include "EDKernels.h"
 
 
 //////////////////////////////////////////////
@@ -36,11 +39,37 @@ public:
 	LassoContextCmd() = default;
 	virtual MPxContext* makeObj();
 	static void*		creator();
+
+	virtual MStatus appendSyntax() override;
+	virtual MStatus doEditFlags() override;
+	virtual MStatus doQueryFlags() override;
+
+private:
+	EasyDressTool* tool = nullptr;
 };
 
+// stroke history flags, e.g. lassoToolContext -e -redoStroke $ctx
+const char kUndoFlag[] = "-us";
+const char kUndoFlagLong[] = "-undoStroke";
+const char kRedoFlag[] = "-rs";
+const char kRedoFlagLong[] = "-redoStroke";
+const char kJournalCapFlag[] = "-jmc";
+const char kJournalCapFlagLong[] = "-journalMemoryCap"; // in MB
+const char kRasterFlag[] = "-rht";
+const char kRasterFlagLong[] = "-rasterHitTest";
+const char kLayerFlag[] = "-pl";
+const char kLayerFlagLong[] = "-projectionLayer"; // 0 is the front surface
+const char kResketchFlag[] = "-rsk";
+const char kResketchFlagLong[] = "-resketchCurves";
+const char kOversketchFlag[] = "-os";
+const char kOversketchFlagLong[] = "-oversketch";
+const char kWeldFlag[] = "-wt";
+const char kWeldFlagLong[] = "-weldTolerance"; // world units, 0 scales with the mesh
+
 MPxContext* LassoContextCmd::makeObj()
 {
-	return new EasyDressTool;
+	tool = new EasyDressTool;
+	return tool;
 }
 
 void* LassoContextCmd::creator()
@@ -48,6 +77,110 @@ void* LassoContextCmd::creator()
 	return new LassoContextCmd;
 }
 
+MStatus LassoContextCmd::appendSyntax()
+{
+	MSyntax mySyntax = syntax();
+	mySyntax.addFlag(kUndoFlag, kUndoFlagLong);
+	mySyntax.addFlag(kRedoFlag, kRedoFlagLong);
+	mySyntax.addFlag(kJournalCapFlag, kJournalCapFlagLong, MSyntax::kDouble);
+	mySyntax.addFlag(kRasterFlag, kRasterFlagLong, MSyntax::kBoolean);
+	mySyntax.addFlag(kLayerFlag, kLayerFlagLong, MSyntax::kLong);
+	mySyntax.addFlag(kResketchFlag, kResketchFlagLong, MSyntax::kBoolean);
+	mySyntax.addFlag(kOversketchFlag, kOversketchFlagLong, MSyntax::kBoolean);
+	mySyntax.addFlag(kWeldFlag, kWeldFlagLong, MSyntax::kDouble);
+	return MS::kSuccess;
+}
+
+MStatus LassoContextCmd::doEditFlags()
+{
+	if (!tool) return MS::kFailure;
+
+	MArgParser argData = parser();
+	if (argData.isFlagSet(kUndoFlag))
+	{
+		tool->undo_stroke();
+	}
+	if (argData.isFlagSet(kRedoFlag))
+	{
+		tool->redo_stroke();
+	}
+	if (argData.isFlagSet(kJournalCapFlag))
+	{
+		double megabytes = 0;
+		auto stat = argData.getFlagArgument(kJournalCapFlag, 0, megabytes);
+		if (!stat || megabytes < 0) return MS::kInvalidParameter;
+		tool->set_journal_memory_cap(static_cast<size_t>(megabytes * 1024 * 1024));
+	}
+	if (argData.isFlagSet(kRasterFlag))
+	{
+		bool enabled = false;
+		auto stat = argData.getFlagArgument(kRasterFlag, 0, enabled);
+		if (!stat) return MS::kInvalidParameter;
+		tool->set_raster_hit_test(enabled);
+	}
+	if (argData.isFlagSet(kLayerFlag))
+	{
+		int layer = 0;
+		auto stat = argData.getFlagArgument(kLayerFlag, 0, layer);
+		if (!stat || layer < 0) return MS::kInvalidParameter;
+		tool->set_projection_layer(layer);
+	}
+	if (argData.isFlagSet(kResketchFlag))
+	{
+		bool enabled = false;
+		auto stat = argData.getFlagArgument(kResketchFlag, 0, enabled);
+		if (!stat) return MS::kInvalidParameter;
+		tool->set_resketch(enabled);
+	}
+	if (argData.isFlagSet(kOversketchFlag))
+	{
+		bool enabled = false;
+		auto stat = argData.getFlagArgument(kOversketchFlag, 0, enabled);
+		if (!stat) return MS::kInvalidParameter;
+		tool->set_oversketch(enabled);
+	}
+	if (argData.isFlagSet(kWeldFlag))
+	{
+		double tolerance = 0;
+		auto stat = argData.getFlagArgument(kWeldFlag, 0, tolerance);
+		if (!stat || tolerance < 0) return MS::kInvalidParameter;
+		tool->set_weld_tolerance(tolerance);
+	}
+	return MS::kSuccess;
+}
+
+MStatus LassoContextCmd::doQueryFlags()
+{
+	if (!tool) return MS::kFailure;
+
+	MArgParser argData = parser();
+	if (argData.isFlagSet(kJournalCapFlag))
+	{
+		setResult(static_cast<double>(tool->journal_memory_cap()) / (1024 * 1024));
+	}
+	if (argData.isFlagSet(kRasterFlag))
+	{
+		setResult(tool->raster_hit_test_enabled());
+	}
+	if (argData.isFlagSet(kLayerFlag))
+	{
+		setResult(tool->get_projection_layer());
+	}
+	if (argData.isFlagSet(kResketchFlag))
+	{
+		setResult(tool->get_resketch());
+	}
+	if (argData.isFlagSet(kOversketchFlag))
+	{
+		setResult(tool->get_oversketch());
+	}
+	if (argData.isFlagSet(kWeldFlag))
+	{
+		setResult(tool->get_weld_tolerance());
+	}
+	return MS::kSuccess;
+}
+
 
 
 //////////////////////////////////////////////
@@ -58,6 +191,8 @@ MStatus initializePlugin(MObject obj)
 	MStatus		status;
 	MFnPlugin	plugin(obj, PLUGIN_COMPANY, "3.0", "Any");
 	std::cout << "plugin loaded" << std::endl;
+	// pick the SIMD kernels for this CPU once, before any stroke
+	std::cout << "easyDress kernels: " << EDKernels::select().name << std::endl;
 	status = plugin.registerContextCommand("lassoToolContext",
 		LassoContextCmd::creator);
 
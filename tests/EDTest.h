@@ -0,0 +1,67 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+// Minimal checks shared by the engine tests; each test is its own executable
+// and returns non-zero if any check failed.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+
+namespace EDTest
+{
+	inline int & failures()
+	{
+		static int count = 0;
+		return count;
+	}
+
+	inline bool check(bool ok, const char * what, const char * file, int line)
+	{
+		if (!ok)
+		{
+			std::printf("%s:%d: failed: %s\n", file, line, what);
+			failures()++;
+		}
+		return ok;
+	}
+
+	inline bool near(double a, double b, double tolerance, const char * what, const char * file, int line)
+	{
+		if (std::fabs(a - b) <= tolerance) return true;
+		std::printf("%s:%d: failed: %s (%.9g vs %.9g, tolerance %.3g)\n", file, line, what, a, b, tolerance);
+		failures()++;
+		return false;
+	}
+
+	inline int finish(const char * name)
+	{
+		if (failures() == 0) std::printf("%s: passed\n", name);
+		return failures() == 0 ? 0 : 1;
+	}
+}
+
+#define ED_CHECK(condition) EDTest::check((condition), #condition, __FILE__, __LINE__)
+#define ED_CHECK_NEAR(a, b, tolerance) EDTest::near((a), (b), (tolerance), #a " ~ " #b, __FILE__, __LINE__)
@@ -0,0 +1,92 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+
+// Meshes shared by the engine tests: a UV sphere loaded into a snapshot.
+//
+// Created: Oct 19, 2026
+
+#pragma once
+
+#include "EDMeshSnapshot.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace EDTest
+{
+	///
+	//  A unit sphere with one vertex at each pole, wound counter-clockwise
+	//  seen from outside. Vertex 0 is the north pole (+y), the last one the
+	//  south pole.
+	///
+	inline void make_sphere(int rings, int segments, std::vector<float> & points, std::vector<int> & triangles)
+	{
+		const double pi = 3.14159265358979323846;
+		auto add = [&](double x, double y, double z)
+		{
+			points.push_back(static_cast<float>(x));
+			points.push_back(static_cast<float>(y));
+			points.push_back(static_cast<float>(z));
+		};
+		add(0, 1, 0);
+		for (int i = 1; i < rings; i++)
+		{
+			for (int j = 0; j < segments; j++)
+			{
+				double theta = pi * i / rings, phi = 2 * pi * j / segments;
+				add(std::sin(theta) * std::cos(phi), std::cos(theta), -std::sin(theta) * std::sin(phi));
+			}
+		}
+		add(0, -1, 0);
+
+		int south = 1 + (rings - 1) * segments;
+		auto at = [&](int i, int j) { return 1 + (i - 1) * segments + j % segments; };
+		for (int j = 0; j < segments; j++)
+		{
+			int top[] = { 0, at(1, j), at(1, j + 1) };
+			int bottom[] = { south, at(rings - 1, j + 1), at(rings - 1, j) };
+			triangles.insert(triangles.end(), top, top + 3);
+			triangles.insert(triangles.end(), bottom, bottom + 3);
+		}
+		for (int i = 1; i < rings - 1; i++)
+		{
+			for (int j = 0; j < segments; j++)
+			{
+				int quad[] = { at(i, j), at(i + 1, j), at(i, j + 1), at(i, j + 1), at(i + 1, j), at(i + 1, j + 1) };
+				triangles.insert(triangles.end(), quad, quad + 6);
+			}
+		}
+	}
+
+	// loads points and triangles into the snapshot as the tool does, moved by the row-vector matrix
+	inline void load_snapshot(EDMeshSnapshot & mesh, const std::vector<float> & points, const std::vector<int> & triangles,
+		const double matrix[4][4] = nullptr)
+	{
+		const double identity[4][4] = { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 }, { 0, 0, 0, 1 } };
+		mesh.update(points.data(), points.size() / 3, matrix ? matrix : identity,
+			EDMeshSnapshot::hash_words(reinterpret_cast<const uint32_t *>(triangles.data()), triangles.size()));
+		mesh.set_triangles(std::vector<int>(triangles));
+		mesh.build_normals();
+	}
+}
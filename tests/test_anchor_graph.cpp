@@ -0,0 +1,168 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+// EDAnchorGraph::find_path against an exhaustive search of simple paths on
+// small random multigraphs, with and without a bound on the path length.
+//
+// Created: Oct 19, 2026
+
+#include "EDTest.h"
+#include "EDAnchorGraph.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace
+{
+	struct Edge
+	{
+		size_t id, a, b;
+		bool alive;
+	};
+
+	bool joins(const Edge & e, size_t u, size_t v)
+	{
+		return (e.a == u && e.b == v) || (e.a == v && e.b == u);
+	}
+
+	// fewest edges of any simple path from v to "to", not using a direct from-to edge
+	void search(const std::vector<Edge> & edges, size_t from, size_t to, size_t v, std::vector<bool> & on_path, size_t depth, size_t & best)
+	{
+		if (v == to)
+		{
+			best = std::min(best, depth);
+			return;
+		}
+		if (depth + 1 >= best) return;
+		for (auto & e : edges)
+		{
+			if (!e.alive || joins(e, from, to) || (e.a != v && e.b != v)) continue;
+			auto w = e.a == v ? e.b : e.a;
+			if (on_path[w]) continue;
+			on_path[w] = true;
+			search(edges, from, to, w, on_path, depth + 1, best);
+			on_path[w] = false;
+		}
+	}
+
+	// the path is a chain of live edges leading from "from" to "to"
+	bool is_chain(const std::vector<Edge> & edges, size_t from, size_t to, const std::vector<EDAnchorGraph::EdgeId> & path)
+	{
+		auto v = from;
+		for (auto id : path)
+		{
+			auto & e = edges[id];
+			if (!e.alive || (e.a != v && e.b != v) || joins(e, from, to)) return false;
+			v = e.a == v ? e.b : e.a;
+		}
+		return v == to;
+	}
+}
+
+int main()
+{
+	std::mt19937 rng(5);
+	const size_t kVertices = 9;
+	std::uniform_int_distribution<size_t> vertex(0, kVertices - 1);
+	const size_t kNone = static_cast<size_t>(-1);
+
+	int found = 0, bounded = 0;
+	for (int round = 0; round < 200; round++)
+	{
+		EDAnchorGraph graph;
+		std::vector<Edge> edges;
+		size_t count = 4 + round % 12;
+		for (size_t i = 0; i < count; i++)
+		{
+			Edge e = { i, vertex(rng), vertex(rng), true };
+			edges.push_back(e);
+			graph.add_edge(e.id, e.a, e.b);
+		}
+		// removals, and re-adding an id moves the edge
+		for (int k = 0; k < 2; k++)
+		{
+			auto & e = edges[vertex(rng) % count];
+			e.alive = false;
+			graph.remove_edge(e.id);
+		}
+		auto & moved = edges[vertex(rng) % count];
+		moved.a = vertex(rng);
+		moved.b = vertex(rng);
+		moved.alive = true;
+		graph.add_edge(moved.id, moved.a, moved.b);
+
+		for (size_t from = 0; from < kVertices; from++)
+		{
+			for (size_t to = 0; to < kVertices; to++)
+			{
+				size_t best = kNone;
+				if (from != to)
+				{
+					std::vector<bool> on_path(kVertices, false);
+					on_path[from] = true;
+					search(edges, from, to, from, on_path, 0, best);
+				}
+
+				std::vector<EDAnchorGraph::EdgeId> path;
+				bool ok = graph.find_path(from, to, path);
+				if (!ED_CHECK(ok == (best != kNone))) continue;
+				if (!ok) continue;
+				found++;
+				ED_CHECK(path.size() == best);
+				ED_CHECK(path.size() >= 2);
+				ED_CHECK(is_chain(edges, from, to, path));
+
+				// a bound below the shortest path finds nothing, one at it finds a shortest path
+				size_t max_edges = best > 2 ? best - 1 : best;
+				ok = graph.find_path(from, to, path, max_edges);
+				ED_CHECK(ok == (best <= max_edges));
+				if (ok) ED_CHECK(path.size() == best && is_chain(edges, from, to, path));
+				bounded += !ok;
+			}
+		}
+
+		EDAnchorGraph::EdgeId e;
+		for (size_t a = 0; a < kVertices; a++)
+		{
+			for (size_t b = 0; b < kVertices; b++)
+			{
+				bool any = false;
+				for (auto & edge : edges) any = any || (edge.alive && joins(edge, a, b));
+				bool ok = graph.find_edge(a, b, e);
+				ED_CHECK(ok == any);
+				if (ok) ED_CHECK(edges[e].alive && joins(edges[e], a, b));
+			}
+		}
+	}
+	std::printf("%d paths, %d cut off by the bound\n", found, bounded);
+	ED_CHECK(found > 0 && bounded > 0);
+
+	EDAnchorGraph graph;
+	graph.add_edge(0, 1, 2);
+	graph.add_edge(1, 2, 3);
+	graph.clear();
+	std::vector<EDAnchorGraph::EdgeId> path;
+	ED_CHECK(!graph.find_path(1, 3, path) && path.empty());
+
+	return EDTest::finish("test_anchor_graph");
+}
@@ -0,0 +1,270 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+// EDBvh against a brute-force double-precision test of every triangle, on a
+// closed sphere and on a random triangle soup. Run once per kernel table
+// (EASYDRESS_SIMD=baseline caps it).
+//
+// Created: Oct 19, 2026
+
+#include "EDTest.h"
+#include "EDBvh.h"
+#include "EDKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+	struct Mesh
+	{
+		std::vector<float> x, y, z;
+		std::vector<int> triangles;
+
+		int add(double px, double py, double pz)
+		{
+			x.push_back(static_cast<float>(px));
+			y.push_back(static_cast<float>(py));
+			z.push_back(static_cast<float>(pz));
+			return static_cast<int>(x.size()) - 1;
+		}
+		size_t triangle_count() const { return triangles.size() / 3; }
+	};
+
+	struct Reference
+	{
+		double t;
+		// distance of the crossing from the nearest edge in barycentric units,
+		// negative outside the triangle
+		double margin;
+	};
+
+	// Moller-Trumbore in doubles, both facings; hit is filled for any crossing of the plane ahead
+	bool reference_hit(const Mesh & mesh, size_t i, const float origin[3], const float direction[3], Reference & hit)
+	{
+		const int * tri = &mesh.triangles[i * 3];
+		double v[3][3];
+		for (int k = 0; k < 3; k++)
+		{
+			v[k][0] = mesh.x[tri[k]];
+			v[k][1] = mesh.y[tri[k]];
+			v[k][2] = mesh.z[tri[k]];
+		}
+		double e1[3], e2[3], s[3], p[3], q[3];
+		for (int a = 0; a < 3; a++)
+		{
+			e1[a] = v[1][a] - v[0][a];
+			e2[a] = v[2][a] - v[0][a];
+			s[a] = origin[a] - v[0][a];
+		}
+		auto cross = [](const double * a, const double * b, double * out)
+		{
+			out[0] = a[1] * b[2] - a[2] * b[1];
+			out[1] = a[2] * b[0] - a[0] * b[2];
+			out[2] = a[0] * b[1] - a[1] * b[0];
+		};
+		double d[] = { direction[0], direction[1], direction[2] };
+		cross(d, e2, p);
+		double det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+		if (std::fabs(det) < 1e-12) return false;
+		double u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) / det;
+		cross(s, e1, q);
+		double w = (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) / det;
+		double t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) / det;
+		if (t < 0) return false;
+		hit.t = t;
+		hit.margin = std::min(std::min(u, w), 1 - u - w);
+		return hit.margin >= 0;
+	}
+
+	void make_sphere(Mesh & mesh, int rings, int segments)
+	{
+		const double pi = 3.14159265358979323846;
+		int north = mesh.add(0, 1, 0);
+		for (int i = 1; i < rings; i++)
+		{
+			for (int j = 0; j < segments; j++)
+			{
+				double theta = pi * i / rings, phi = 2 * pi * j / segments;
+				mesh.add(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+			}
+		}
+		int south = mesh.add(0, -1, 0);
+		auto at = [&](int i, int j) { return north + 1 + (i - 1) * segments + j % segments; };
+		for (int j = 0; j < segments; j++)
+		{
+			int cap[] = { north, at(1, j + 1), at(1, j), south, at(rings - 1, j), at(rings - 1, j + 1) };
+			mesh.triangles.insert(mesh.triangles.end(), cap, cap + 6);
+		}
+		for (int i = 1; i < rings - 1; i++)
+		{
+			for (int j = 0; j < segments; j++)
+			{
+				int quad[] = { at(i, j), at(i, j + 1), at(i + 1, j), at(i, j + 1), at(i + 1, j + 1), at(i + 1, j) };
+				mesh.triangles.insert(mesh.triangles.end(), quad, quad + 6);
+			}
+		}
+	}
+
+	void make_soup(Mesh & mesh, size_t count, std::mt19937 & rng)
+	{
+		std::uniform_real_distribution<double> where(-2, 2), offset(-0.3, 0.3);
+		for (size_t i = 0; i < count; i++)
+		{
+			double c[] = { where(rng), where(rng), where(rng) };
+			for (int k = 0; k < 3; k++)
+			{
+				mesh.triangles.push_back(mesh.add(c[0] + offset(rng), c[1] + offset(rng), c[2] + offset(rng)));
+			}
+		}
+	}
+
+	void test_mesh(const char * name, const Mesh & mesh, std::mt19937 & rng)
+	{
+		EDBvh bvh;
+		bvh.build(mesh.x.data(), mesh.y.data(), mesh.z.data(), mesh.triangles.data(), mesh.triangle_count());
+		ED_CHECK(bvh.triangle_count() == mesh.triangle_count());
+
+		// rays from a shell around the mesh towards points inside it, some of them missing
+		std::uniform_real_distribution<float> unit(-1, 1);
+		const int kRays = 2000;
+		// hits this close to an edge may land on either neighbour, or on both within EDKernels::kEdgeSlack
+		const double kEdge = 1e-4;
+		int hits = 0;
+		for (int r = 0; r < kRays; r++)
+		{
+			float origin[3], target[3], direction[3];
+			float length = 0;
+			for (int a = 0; a < 3; a++)
+			{
+				origin[a] = 4 * unit(rng);
+				target[a] = 1.5f * unit(rng);
+				direction[a] = target[a] - origin[a];
+				length += direction[a] * direction[a];
+			}
+			length = std::sqrt(length);
+			for (int a = 0; a < 3; a++) direction[a] /= length;
+
+			std::vector<Reference> expected;
+			Reference nearest = { 0, 0 };
+			bool any = false, near_edge = false;
+			for (size_t i = 0; i < mesh.triangle_count(); i++)
+			{
+				Reference h = { 0, -1 };
+				bool inside = reference_hit(mesh, i, origin, direction, h);
+				near_edge = near_edge || std::fabs(h.margin) < kEdge;
+				if (!inside) continue;
+				expected.push_back(h);
+				if (!any || h.t < nearest.t) nearest = h;
+				any = true;
+			}
+
+			EDBvh::Hit hit;
+			bool found = bvh.intersect(origin, direction, hit);
+			if (near_edge) continue;
+
+			hits += any;
+			if (!ED_CHECK(found == any)) continue;
+			if (found) ED_CHECK_NEAR(hit.t, nearest.t, 1e-4 * std::max(1.0, nearest.t));
+
+			std::vector<EDBvh::Hit> all;
+			bvh.intersect_all(origin, direction, all);
+			ED_CHECK(all.size() == expected.size());
+			if (all.size() != expected.size()) continue;
+			std::vector<double> got_t, expected_t;
+			for (auto & h : all) got_t.push_back(h.t);
+			for (auto & h : expected) expected_t.push_back(h.t);
+			std::sort(got_t.begin(), got_t.end());
+			std::sort(expected_t.begin(), expected_t.end());
+			for (size_t k = 0; k < got_t.size(); k++) ED_CHECK_NEAR(got_t[k], expected_t[k], 1e-4 * std::max(1.0, expected_t[k]));
+
+			// a t_max short of the nearest hit finds nothing
+			if (found) ED_CHECK(!bvh.intersect(origin, direction, hit, static_cast<float>(nearest.t * 0.99)));
+		}
+		std::printf("%s: %zu triangles, %d of %d rays hit\n", name, mesh.triangle_count(), hits, kRays);
+		ED_CHECK(hits > kRays / 10);
+	}
+
+	// rays aimed at edges of a closed mesh from random points outside must not slip through
+	void test_shared_edges(const Mesh & mesh, std::mt19937 & rng)
+	{
+		EDBvh bvh;
+		bvh.build(mesh.x.data(), mesh.y.data(), mesh.z.data(), mesh.triangles.data(), mesh.triangle_count());
+
+		std::uniform_real_distribution<float> unit(-1, 1), along(0, 1);
+		int missed = 0;
+		for (size_t i = 0; i < mesh.triangle_count(); i++)
+		{
+			for (int k = 0; k < 3; k++)
+			{
+				int a = mesh.triangles[i * 3 + k], b = mesh.triangles[i * 3 + (k + 1) % 3];
+				float s = along(rng);
+				float target[] = {
+					mesh.x[a] + (mesh.x[b] - mesh.x[a]) * s,
+					mesh.y[a] + (mesh.y[b] - mesh.y[a]) * s,
+					mesh.z[a] + (mesh.z[b] - mesh.z[a]) * s };
+				float origin[3], direction[3];
+				float length = 0;
+				for (int c = 0; c < 3; c++)
+				{
+					origin[c] = 4 * target[c] + unit(rng);
+					direction[c] = target[c] - origin[c];
+					length += direction[c] * direction[c];
+				}
+				length = std::sqrt(length);
+				for (int c = 0; c < 3; c++) direction[c] /= length;
+
+				EDBvh::Hit hit;
+				missed += !bvh.intersect(origin, direction, hit);
+			}
+		}
+		ED_CHECK(missed == 0);
+	}
+}
+
+int main()
+{
+	std::printf("kernels: %s\n", EDKernels::select().name);
+	std::mt19937 rng(11);
+
+	Mesh sphere;
+	make_sphere(sphere, 24, 48);
+	test_mesh("sphere", sphere, rng);
+
+	// the driver's sphere: fine enough that rounding across an edge matters
+	Mesh fine;
+	make_sphere(fine, 256, 512);
+	test_shared_edges(fine, rng);
+
+	Mesh soup;
+	make_soup(soup, 3000, rng);
+	test_mesh("soup", soup, rng);
+
+	EDBvh empty;
+	float origin[] = { 0, 0, 0 }, direction[] = { 0, 0, 1 };
+	EDBvh::Hit hit;
+	ED_CHECK(!empty.intersect(origin, direction, hit));
+
+	return EDTest::finish("test_bvh");
+}
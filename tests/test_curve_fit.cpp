@@ -0,0 +1,235 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+// EDCurveFit against a dense least-squares solve of the same problem, with
+// its own Cox-de Boor recursion, plus the shapes a fit must reproduce.
+//
+// Created: Oct 19, 2026
+
+#include "EDTest.h"
+#include "EDCurveFit.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+	// the fit's pull of interior control points towards the chord
+	const double kChordPull = 1e-6;
+
+	// the plain recursive definition, so the reference shares nothing with the fit
+	double basis(const std::vector<double> & u, size_t i, int degree, double t)
+	{
+		if (degree == 0)
+		{
+			// the last non-empty span is closed, so t = 1 belongs to it
+			bool last = u[i + 1] == 1.0 && u[i] < 1.0;
+			return (u[i] <= t && (t < u[i + 1] || (last && t == 1.0))) ? 1.0 : 0.0;
+		}
+		double value = 0;
+		if (u[i + degree] > u[i]) value += (t - u[i]) / (u[i + degree] - u[i]) * basis(u, i, degree - 1, t);
+		if (u[i + degree + 1] > u[i + 1]) value += (u[i + degree + 1] - t) / (u[i + degree + 1] - u[i + 1]) * basis(u, i + 1, degree - 1, t);
+		return value;
+	}
+
+	// Gaussian elimination with partial pivoting, in place
+	bool solve_dense(std::vector<std::vector<double>> a, std::vector<double> & b)
+	{
+		auto n = b.size();
+		for (size_t c = 0; c < n; c++)
+		{
+			size_t pivot = c;
+			for (size_t r = c + 1; r < n; r++)
+			{
+				if (std::fabs(a[r][c]) > std::fabs(a[pivot][c])) pivot = r;
+			}
+			if (a[pivot][c] == 0) return false;
+			std::swap(a[c], a[pivot]);
+			std::swap(b[c], b[pivot]);
+			for (size_t r = c + 1; r < n; r++)
+			{
+				double f = a[r][c] / a[c][c];
+				for (size_t k = c; k < n; k++) a[r][k] -= f * a[c][k];
+				b[r] -= f * b[c];
+			}
+		}
+		for (size_t c = n; c-- > 0;)
+		{
+			for (size_t k = c + 1; k < n; k++) b[c] -= a[c][k] * b[k];
+			b[c] /= a[c][c];
+		}
+		return true;
+	}
+
+	// least squares at chord-length parameters with the ends held, as the fit documents it
+	bool reference_fit(const std::vector<double> & samples, int spans, std::vector<double> & control_points)
+	{
+		auto count = samples.size() / 3;
+		std::vector<double> t(count, 0.0);
+		for (size_t i = 1; i < count; i++)
+		{
+			double d = 0;
+			for (int a = 0; a < 3; a++) d += std::pow(samples[i * 3 + a] - samples[(i - 1) * 3 + a], 2);
+			t[i] = t[i - 1] + std::sqrt(d);
+		}
+		for (auto & ti : t) ti /= t.back();
+
+		size_t controls = spans + 3;
+		std::vector<double> u;
+		EDCurveFit::knots(controls, u);
+		size_t n = controls - 2;
+
+		control_points.assign(controls * 3, 0.0);
+		for (int a = 0; a < 3; a++)
+		{
+			control_points[a] = samples[a];
+			control_points[(controls - 1) * 3 + a] = samples[(count - 1) * 3 + a];
+		}
+
+		std::vector<std::vector<double>> normal(n, std::vector<double>(n, 0.0));
+		std::vector<double> rhs[3];
+		for (int a = 0; a < 3; a++) rhs[a].assign(n, 0.0);
+		for (size_t i = 0; i < count; i++)
+		{
+			std::vector<double> row(controls);
+			for (size_t j = 0; j < controls; j++) row[j] = basis(u, j, 3, t[i]);
+			for (size_t j = 1; j + 1 < controls; j++)
+			{
+				for (size_t m = 1; m + 1 < controls; m++) normal[j - 1][m - 1] += row[j] * row[m];
+				for (int a = 0; a < 3; a++)
+				{
+					double residual = samples[i * 3 + a] - row[0] * control_points[a] - row[controls - 1] * control_points[(controls - 1) * 3 + a];
+					rhs[a][j - 1] += row[j] * residual;
+				}
+			}
+		}
+		for (size_t j = 1; j + 1 < controls; j++)
+		{
+			double g = (u[j + 1] + u[j + 2] + u[j + 3]) / 3;
+			normal[j - 1][j - 1] += kChordPull;
+			for (int a = 0; a < 3; a++)
+			{
+				rhs[a][j - 1] += kChordPull * ((1 - g) * control_points[a] + g * control_points[(controls - 1) * 3 + a]);
+			}
+		}
+		for (int a = 0; a < 3; a++)
+		{
+			if (!solve_dense(normal, rhs[a])) return false;
+			for (size_t j = 0; j < n; j++) control_points[(j + 1) * 3 + a] = rhs[a][j];
+		}
+		return true;
+	}
+
+	void add_sample(std::vector<double> & samples, double x, double y, double z)
+	{
+		samples.push_back(x);
+		samples.push_back(y);
+		samples.push_back(z);
+	}
+
+	void test_against_reference()
+	{
+		// a helix with uneven spacing, like a hand-drawn stroke
+		std::vector<double> samples;
+		for (int i = 0; i < 150; i++)
+		{
+			double s = i / 149.0;
+			double t = s + 0.05 * std::sin(9 * s);
+			add_sample(samples, std::cos(6 * t), std::sin(6 * t), 2 * t);
+		}
+		std::vector<double> fitted, expected;
+		ED_CHECK(EDCurveFit::fit(samples, 8, fitted));
+		ED_CHECK(reference_fit(samples, 8, expected));
+		ED_CHECK(fitted.size() == expected.size());
+		if (fitted.size() != expected.size()) return;
+		for (size_t k = 0; k < fitted.size(); k++) ED_CHECK_NEAR(fitted[k], expected[k], 1e-8);
+
+		// evaluate agrees with the basis the reference uses
+		std::vector<double> u;
+		EDCurveFit::knots(fitted.size() / 3, u);
+		for (int k = 0; k <= 10; k++)
+		{
+			double t = k / 10.0, p[3], q[3] = { 0, 0, 0 };
+			EDCurveFit::evaluate(fitted, t, p);
+			for (size_t j = 0; j < fitted.size() / 3; j++)
+			{
+				double b = basis(u, j, 3, t);
+				for (int a = 0; a < 3; a++) q[a] += b * fitted[j * 3 + a];
+			}
+			for (int a = 0; a < 3; a++) ED_CHECK_NEAR(p[a], q[a], 1e-12);
+		}
+	}
+
+	void test_line()
+	{
+		// evenly spaced samples on a line fit exactly, ends kept
+		std::vector<double> samples;
+		for (int i = 0; i < 40; i++)
+		{
+			double s = i / 39.0;
+			add_sample(samples, 1 + 2 * s, -1 + s, 0.5 - 3 * s);
+		}
+		std::vector<double> control_points;
+		ED_CHECK(EDCurveFit::fit(samples, 8, control_points));
+		ED_CHECK(control_points.size() == 11 * 3);
+		for (int a = 0; a < 3; a++)
+		{
+			ED_CHECK(control_points[a] == samples[a]);
+			ED_CHECK(control_points[control_points.size() - 3 + a] == samples[samples.size() - 3 + a]);
+		}
+		for (int k = 0; k <= 20; k++)
+		{
+			double s = k / 20.0, p[3];
+			EDCurveFit::evaluate(control_points, s, p);
+			ED_CHECK_NEAR(p[0], 1 + 2 * s, 1e-6);
+			ED_CHECK_NEAR(p[1], -1 + s, 1e-6);
+			ED_CHECK_NEAR(p[2], 0.5 - 3 * s, 1e-6);
+		}
+	}
+
+	void test_short_strokes()
+	{
+		std::vector<double> control_points;
+		std::vector<double> one = { 1, 2, 3 };
+		ED_CHECK(!EDCurveFit::fit(one, 8, control_points));
+		ED_CHECK(control_points.empty());
+
+		// three samples support two spans
+		std::vector<double> three = { 0, 0, 0, 1, 1, 0, 2, 0, 0 };
+		ED_CHECK(EDCurveFit::fit(three, 8, control_points));
+		ED_CHECK(control_points.size() == 5 * 3);
+
+		// a stroke that never moved still fits, on its one point
+		std::vector<double> still = { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+		ED_CHECK(EDCurveFit::fit(still, 8, control_points));
+		for (auto c : control_points) ED_CHECK_NEAR(c, 1.0, 1e-9);
+	}
+}
+
+int main()
+{
+	test_against_reference();
+	test_line();
+	test_short_strokes();
+	return EDTest::finish("test_curve_fit");
+}
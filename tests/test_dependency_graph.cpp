@@ -0,0 +1,142 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+// EDDependencyGraph on random DAGs: dirty propagation against reachability
+// from the marked nodes, dirty_levels against longest dirty paths, and a
+// parallel evaluate() that must finish every node's dirty inputs before it
+// starts the node.
+//
+// Created: Oct 19, 2026
+
+#include "EDTest.h"
+#include "EDDependencyGraph.h"
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <vector>
+
+int main()
+{
+	std::mt19937 rng(19);
+	const size_t kNodes = 40;
+
+	int rounds_with_levels = 0;
+	for (int round = 0; round < 100; round++)
+	{
+		// edges only run from lower to higher ids, so the graph is acyclic
+		EDDependencyGraph graph;
+		std::vector<std::vector<bool>> edge(kNodes, std::vector<bool>(kNodes, false));
+		for (size_t a = 0; a < kNodes; a++)
+		{
+			for (size_t b = a + 1; b < kNodes; b++)
+			{
+				if (rng() % 12 != 0) continue;
+				edge[a][b] = true;
+				graph.add_edge(a, b);
+				// a repeated edge is ignored
+				if (rng() % 4 == 0) graph.add_edge(a, b);
+			}
+		}
+		auto removed = rng() % kNodes;
+		graph.remove_node(removed);
+		for (size_t k = 0; k < kNodes; k++) edge[removed][k] = edge[k][removed] = false;
+
+		for (size_t a = 0; a < kNodes; a++)
+		{
+			size_t down = 0, up = 0;
+			for (size_t k = 0; k < kNodes; k++)
+			{
+				down += edge[a][k];
+				up += edge[k][a];
+			}
+			ED_CHECK(graph.downstream_of(a).size() == down && graph.upstream_of(a).size() == up);
+		}
+
+		// dirty is everything reachable from the marked nodes
+		std::vector<bool> dirty(kNodes, false);
+		for (int m = 0; m < 3; m++)
+		{
+			auto n = rng() % kNodes;
+			graph.mark_dirty(n);
+			dirty[n] = true;
+		}
+		for (size_t a = 0; a < kNodes; a++)
+		{
+			for (size_t b = a + 1; b < kNodes; b++)
+			{
+				if (dirty[a] && edge[a][b]) dirty[b] = true;
+			}
+		}
+		for (size_t a = 0; a < kNodes; a++) ED_CHECK(graph.is_dirty(a) == dirty[a]);
+
+		// a node's level is the longest chain of dirty nodes leading to it
+		std::vector<int> level(kNodes, -1);
+		for (size_t b = 0; b < kNodes; b++)
+		{
+			if (!dirty[b]) continue;
+			level[b] = 0;
+			for (size_t a = 0; a < b; a++)
+			{
+				if (dirty[a] && edge[a][b]) level[b] = std::max(level[b], level[a] + 1);
+			}
+		}
+		std::vector<std::vector<EDDependencyGraph::NodeId>> levels;
+		graph.dirty_levels(levels);
+		size_t listed = 0;
+		for (size_t l = 0; l < levels.size(); l++)
+		{
+			for (auto n : levels[l])
+			{
+				ED_CHECK(level[n] == static_cast<int>(l));
+				listed++;
+			}
+		}
+		ED_CHECK(listed == static_cast<size_t>(std::count(dirty.begin(), dirty.end(), true)));
+		rounds_with_levels += levels.size() > 2;
+
+		// every node once, each after all of its dirty inputs have finished
+		std::atomic<int> clock(0);
+		std::vector<int> started(kNodes, -1), finished(kNodes, -1), calls(kNodes, 0);
+		graph.evaluate([&](EDDependencyGraph::NodeId n)
+		{
+			started[n] = clock++;
+			calls[n]++;
+			volatile double sink = 0;
+			for (int k = 0; k < 2000; k++) sink = sink + k;
+			finished[n] = clock++;
+		}, true);
+		for (size_t b = 0; b < kNodes; b++)
+		{
+			ED_CHECK(calls[b] == (dirty[b] ? 1 : 0));
+			for (size_t a = 0; a < kNodes; a++)
+			{
+				if (dirty[a] && dirty[b] && edge[a][b]) ED_CHECK(finished[a] < started[b]);
+			}
+		}
+		ED_CHECK(!graph.has_dirty());
+	}
+	std::printf("%d of 100 graphs had more than two dirty levels\n", rounds_with_levels);
+	ED_CHECK(rounds_with_levels > 0);
+
+	return EDTest::finish("test_dependency_graph");
+}
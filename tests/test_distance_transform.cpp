@@ -0,0 +1,128 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+// EDDistanceTransform against a scan of every covered pixel: the nearest
+// covered pixel's distance and the triangle under it, for coverage from
+// a few scattered triangles, a single pixel and none at all.
+//
+// Created: Oct 19, 2026
+
+#include "EDTest.h"
+#include "EDDistanceTransform.h"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+	void check_transform(const EDRasterizer & raster, const EDDistanceTransform & transform)
+	{
+		int w = raster.width(), h = raster.height();
+		std::vector<int> covered;
+		for (int y = 0; y < h; y++)
+		{
+			for (int x = 0; x < w; x++)
+			{
+				if (raster.triangle_at(x, y) != EDRasterizer::kNoTriangle) covered.push_back(y * w + x);
+			}
+		}
+
+		int wrong = 0;
+		for (int y = 0; y < h && wrong < 10; y++)
+		{
+			for (int x = 0; x < w && wrong < 10; x++)
+			{
+				long best = std::numeric_limits<long>::max();
+				for (auto c : covered)
+				{
+					long dx = c % w - x, dy = c / w - y;
+					best = std::min(best, dx * dx + dy * dy);
+				}
+
+				auto & n = transform.nearest_at(x, y);
+				if (covered.empty())
+				{
+					wrong += !ED_CHECK(n.x < 0 && n.triangle == EDRasterizer::kNoTriangle);
+					continue;
+				}
+				// ties between equally near pixels may go either way
+				long dx = n.x - x, dy = n.y - y;
+				wrong += !ED_CHECK(dx * dx + dy * dy == best);
+				wrong += !ED_CHECK(n.triangle == raster.triangle_at(n.x, n.y) && n.triangle != EDRasterizer::kNoTriangle);
+			}
+		}
+	}
+}
+
+int main()
+{
+	const int kWidth = 131, kHeight = 77;
+	std::mt19937 rng(29);
+	std::uniform_real_distribution<float> sx(0, kWidth), sy(0, kHeight), offset(-12, 12);
+
+	EDRasterizer raster;
+	raster.resize(kWidth, kHeight);
+	EDDistanceTransform transform;
+
+	std::vector<EDRasterizer::Vertex> vertices;
+	std::vector<int> indices;
+	for (int t = 0; t < 6; t++)
+	{
+		float cx = sx(rng), cy = sy(rng);
+		for (int k = 0; k < 3; k++)
+		{
+			EDRasterizer::Vertex v = { cx + offset(rng), cy + offset(rng), 0 };
+			vertices.push_back(v);
+			indices.push_back(static_cast<int>(vertices.size()) - 1);
+		}
+	}
+	for (int parallel = 0; parallel < 2; parallel++)
+	{
+		raster.rasterize(vertices, indices, parallel != 0);
+		transform.build(raster, parallel != 0);
+		ED_CHECK(transform.width() == kWidth && transform.height() == kHeight);
+		check_transform(raster, transform);
+	}
+
+	// out-of-port lookups clamp to the border
+	ED_CHECK(&transform.nearest_at(-5, -5) == &transform.nearest_at(0, 0));
+	ED_CHECK(&transform.nearest_at(kWidth + 5, kHeight) == &transform.nearest_at(kWidth - 1, kHeight - 1));
+
+	// one covered pixel in a corner: every pixel points at it
+	vertices.clear();
+	EDRasterizer::Vertex corner[] = { { 0, 0, 0 }, { 1.2f, 0, 0 }, { 0, 1.2f, 0 } };
+	vertices.assign(corner, corner + 3);
+	indices.assign({ 0, 1, 2 });
+	raster.rasterize(vertices, indices);
+	transform.build(raster);
+	check_transform(raster, transform);
+	ED_CHECK(transform.nearest_at(kWidth - 1, kHeight - 1).x == 0 && transform.nearest_at(kWidth - 1, kHeight - 1).y == 0);
+
+	// nothing covered
+	raster.clear();
+	transform.build(raster);
+	check_transform(raster, transform);
+
+	return EDTest::finish("test_distance_transform");
+}
@@ -0,0 +1,160 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+
+// EDGeodesics against great-circle distances on a unit sphere, on its own
+// and next to a second sphere it must not reach; and the request/ready
+// hand-off, including a request made while another is factoring.
+//
+// Created: Oct 19, 2026
+
+#include "EDTest.h"
+#include "EDTestMesh.h"
+#include "EDGeodesics.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	// polls as the tool does, for at most a minute
+	bool wait_ready(EDGeodesics & geodesics)
+	{
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+		while (!geodesics.ready())
+		{
+			if (std::chrono::steady_clock::now() > deadline) return false;
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+		return true;
+	}
+
+	// the heat method against the angle between source and vertex, on the sphere starting at first
+	void check_sphere(const EDGeodesics & geodesics, const EDMeshSnapshot & mesh, int first, int count, int source)
+	{
+		std::vector<float> d;
+		if (!ED_CHECK(geodesics.distances(source, d))) return;
+		ED_CHECK(d.size() == mesh.vertex_count());
+		ED_CHECK_NEAR(d[source], 0.0, 1e-5);
+
+		double cx = 0, cy = 0, cz = 0;
+		for (int i = first; i < first + count; i++)
+		{
+			cx += mesh.x[i] / count;
+			cy += mesh.y[i] / count;
+			cz += mesh.z[i] / count;
+		}
+		double sx = mesh.x[source] - cx, sy = mesh.y[source] - cy, sz = mesh.z[source] - cz;
+		double worst = 0, mean = 0;
+		for (int i = first; i < first + count; i++)
+		{
+			double px = mesh.x[i] - cx, py = mesh.y[i] - cy, pz = mesh.z[i] - cz;
+			double c = (px * sx + py * sy + pz * sz) / std::sqrt((px * px + py * py + pz * pz) * (sx * sx + sy * sy + sz * sz));
+			double error = std::fabs(d[i] - std::acos(std::max(-1.0, std::min(1.0, c))));
+			worst = std::max(worst, error);
+			mean += error / count;
+		}
+		ED_CHECK_NEAR(worst, 0.0, 0.1);
+		ED_CHECK_NEAR(mean, 0.0, 0.04);
+	}
+}
+
+int main()
+{
+	std::vector<float> points;
+	std::vector<int> triangles;
+	const int rings = 32, segments = 64;
+	EDTest::make_sphere(rings, segments, points, triangles);
+	int sphere_vertices = static_cast<int>(points.size() / 3);
+	int south = sphere_vertices - 1;
+
+	EDMeshSnapshot mesh;
+	EDTest::load_snapshot(mesh, points, triangles);
+	EDGeodesics geodesics;
+	std::vector<float> d;
+	ED_CHECK(!geodesics.ready());
+	ED_CHECK(!geodesics.distances(0, d));
+	ED_CHECK(geodesics.mesh_revision() == 0);
+
+	geodesics.request(mesh);
+	if (!ED_CHECK(wait_ready(geodesics))) return EDTest::finish("test_geodesics");
+	ED_CHECK(geodesics.mesh_revision() == mesh.revision());
+	ED_CHECK(!geodesics.distances(-1, d));
+	ED_CHECK(!geodesics.distances(sphere_vertices, d));
+
+	// pole to pole is half a great circle
+	check_sphere(geodesics, mesh, 0, sphere_vertices, 0);
+	ED_CHECK(geodesics.distances(0, d));
+	ED_CHECK_NEAR(d[south], 3.14159265358979, 0.05);
+	check_sphere(geodesics, mesh, 0, sphere_vertices, 1 + (rings / 2 - 1) * segments + 5);
+
+	// a second sphere beside the first: out of reach of the first one's sources
+	std::vector<float> two(points);
+	std::vector<int> two_triangles(triangles);
+	for (size_t i = 0; i < points.size(); i += 3)
+	{
+		two.push_back(points[i] + 3);
+		two.push_back(points[i + 1]);
+		two.push_back(points[i + 2]);
+	}
+	for (auto v : triangles) two_triangles.push_back(v + sphere_vertices);
+	EDTest::load_snapshot(mesh, two, two_triangles);
+	auto old_revision = geodesics.mesh_revision();
+	geodesics.request(mesh);
+	// the old factors stay in use until the new ones are done
+	ED_CHECK(geodesics.mesh_revision() == old_revision || geodesics.mesh_revision() == mesh.revision());
+	ED_CHECK(wait_ready(geodesics));
+	ED_CHECK(geodesics.mesh_revision() == mesh.revision());
+
+	ED_CHECK(geodesics.distances(0, d));
+	ED_CHECK(d.size() == two.size() / 3);
+	ED_CHECK(d[sphere_vertices] == FLT_MAX && d[two.size() / 3 - 1] == FLT_MAX);
+	ED_CHECK(d[south] < 4);
+	check_sphere(geodesics, mesh, sphere_vertices, sphere_vertices, sphere_vertices + 7);
+	ED_CHECK(geodesics.distances(sphere_vertices, d));
+	ED_CHECK(d[0] == FLT_MAX && d[south] == FLT_MAX);
+
+	// a request while another is factoring follows it, and the last one wins
+	EDTest::load_snapshot(mesh, points, triangles);
+	geodesics.request(mesh);
+	auto moved = points;
+	for (size_t i = 1; i < moved.size(); i += 3) moved[i] += 1;
+	EDTest::load_snapshot(mesh, moved, triangles);
+	geodesics.request(mesh);
+	ED_CHECK(wait_ready(geodesics));
+	ED_CHECK(geodesics.mesh_revision() == mesh.revision());
+	check_sphere(geodesics, mesh, 0, sphere_vertices, south);
+
+	// asking again for the same revision starts nothing
+	geodesics.request(mesh);
+	ED_CHECK(geodesics.ready());
+
+	geodesics.clear();
+	ED_CHECK(geodesics.mesh_revision() == 0);
+	ED_CHECK(!geodesics.distances(0, d));
+
+	return EDTest::finish("test_geodesics");
+}
@@ -0,0 +1,205 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+
+// EDHeightField against a blend over the k nearest sites found by scanning
+// every site, with the tree built, partly built and not built at all; and
+// against what any such blend must do: match the sites themselves, keep a
+// constant field constant and stay within the heights it blends.
+//
+// Created: Oct 19, 2026
+
+#include "EDTest.h"
+#include "EDHeightField.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	struct Site
+	{
+		double x, y, z, h;
+	};
+
+	// the documented blend, in doubles over a full scan
+	bool reference(const std::vector<Site> & sites, const float p[3], double & height,
+		const std::vector<float> & extra_heights, const std::vector<float> & extra_distances)
+	{
+		double sum = 0, weight_sum = 0;
+		for (size_t k = 0; k < extra_heights.size(); k++)
+		{
+			double d = extra_distances[k];
+			if (d < 1e-6)
+			{
+				height = extra_heights[k];
+				return true;
+			}
+			sum += extra_heights[k] / (d * d);
+			weight_sum += 1 / (d * d);
+		}
+
+		std::vector<std::pair<double, size_t>> nearest;
+		for (size_t i = 0; i < sites.size(); i++)
+		{
+			double dx = sites[i].x - p[0], dy = sites[i].y - p[1], dz = sites[i].z - p[2];
+			nearest.push_back(std::make_pair(dx * dx + dy * dy + dz * dz, i));
+		}
+		std::sort(nearest.begin(), nearest.end());
+		nearest.resize(std::min<size_t>(nearest.size(), EDHeightField::kNeighbours));
+		if (!nearest.empty())
+		{
+			if (nearest[0].first < 1e-12 || (nearest.size() == 1 && extra_heights.empty()))
+			{
+				height = sites[nearest[0].second].h;
+				return true;
+			}
+			double support = std::sqrt(nearest.back().first) * 1.05;
+			for (auto & n : nearest)
+			{
+				double r = std::sqrt(n.first) / support, s = 1 - r;
+				double w = s * s * s * s * (4 * r + 1) / n.first;
+				sum += w * sites[n.second].h;
+				weight_sum += w;
+			}
+		}
+		if (!(weight_sum > 0)) return false;
+		height = sum / weight_sum;
+		return true;
+	}
+
+	void check_queries(const EDHeightField & field, const std::vector<Site> & sites, std::mt19937 & random, bool with_extras)
+	{
+		std::uniform_real_distribution<float> unit(-1.2f, 1.2f), positive(0.05f, 2.0f);
+		double lo = 1e30, hi = -1e30;
+		for (auto & s : sites)
+		{
+			lo = std::min(lo, s.h);
+			hi = std::max(hi, s.h);
+		}
+
+		for (int q = 0; q < 300; q++)
+		{
+			float p[] = { unit(random), unit(random), unit(random) };
+			std::vector<float> extra_heights, extra_distances;
+			if (with_extras)
+			{
+				for (int k = 0; k < 2; k++)
+				{
+					extra_heights.push_back(positive(random));
+					extra_distances.push_back(positive(random));
+					lo = std::min(lo, double(extra_heights.back()));
+					hi = std::max(hi, double(extra_heights.back()));
+				}
+			}
+
+			double expected;
+			float height = 0;
+			bool expect = reference(sites, p, expected, extra_heights, extra_distances);
+			bool found = field.evaluate(p, height, extra_heights.data(), extra_distances.data(), extra_heights.size());
+			if (!ED_CHECK(found == expect) || !found) continue;
+			ED_CHECK_NEAR(height, expected, 1e-4 * std::max(1.0, std::fabs(expected)));
+			ED_CHECK(height >= lo - 1e-4 && height <= hi + 1e-4);
+		}
+	}
+}
+
+int main()
+{
+	std::mt19937 random(5);
+	std::uniform_real_distribution<float> unit(-1, 1), positive(0.01f, 1.0f);
+
+	// nothing known: no height unless extras are given
+	EDHeightField field;
+	float origin[] = { 0, 0, 0 }, height = 0;
+	ED_CHECK(field.empty());
+	ED_CHECK(!field.evaluate(origin, height));
+	float extra_h[] = { 0.3f, 0.6f }, extra_d[] = { 1, 2 };
+	ED_CHECK(field.evaluate(origin, height, extra_h, extra_d, 2));
+	ED_CHECK_NEAR(height, (0.3 / 1 + 0.6 / 4) / (1 + 0.25), 1e-6);
+	extra_d[1] = 0;
+	ED_CHECK(field.evaluate(origin, height, extra_h, extra_d, 2));
+	ED_CHECK_NEAR(height, 0.6, 1e-7);
+
+	// one site is the whole field
+	field.add(0.5f, 0, 0, 0.25f);
+	field.build();
+	ED_CHECK(field.evaluate(origin, height));
+	ED_CHECK_NEAR(height, 0.25, 1e-7);
+
+	// a few sites, all pending; then enough to build the tree, then more pending on top
+	std::vector<Site> sites(1, Site{ 0.5, 0, 0, 0.25 });
+	auto add_sites = [&](int count)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			Site s = { unit(random), unit(random), unit(random), positive(random) };
+			sites.push_back(s);
+			field.add(static_cast<float>(s.x), static_cast<float>(s.y), static_cast<float>(s.z), static_cast<float>(s.h));
+		}
+		field.build();
+	};
+	add_sites(20);
+	ED_CHECK(field.pending() == field.size());
+	check_queries(field, sites, random, false);
+	check_queries(field, sites, random, true);
+
+	add_sites(2000);
+	ED_CHECK(field.pending() == 0);
+	check_queries(field, sites, random, false);
+
+	add_sites(100);
+	ED_CHECK(field.pending() == 100);
+	check_queries(field, sites, random, false);
+	check_queries(field, sites, random, true);
+
+	// every site is matched exactly, from the tree or the pending list
+	for (size_t i = 0; i < sites.size(); i += 7)
+	{
+		float p[] = { static_cast<float>(sites[i].x), static_cast<float>(sites[i].y), static_cast<float>(sites[i].z) };
+		ED_CHECK(field.evaluate(p, height));
+		ED_CHECK_NEAR(height, sites[i].h, 1e-6);
+	}
+
+	// a constant field stays constant anywhere
+	EDHeightField flat;
+	for (int i = 0; i < 500; i++)
+	{
+		flat.add(unit(random), unit(random), unit(random), 0.125f);
+	}
+	flat.build();
+	for (int q = 0; q < 100; q++)
+	{
+		float p[] = { unit(random) * 2, unit(random) * 2, unit(random) * 2 };
+		ED_CHECK(flat.evaluate(p, height));
+		ED_CHECK_NEAR(height, 0.125, 1e-6);
+	}
+
+	field.clear();
+	ED_CHECK(field.empty() && field.pending() == 0);
+	ED_CHECK(!field.evaluate(origin, height));
+
+	return EDTest::finish("test_height_field");
+}
@@ -0,0 +1,135 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+// EDJournal against two plain stacks of stroke ids: undo and redo order,
+// discarding a stroke that failed to commit, the redo list surviving until
+// confirm(), and the running memory total through trims.
+//
+// Created: Oct 19, 2026
+
+#include "EDTest.h"
+#include "EDJournal.h"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+	struct Record
+	{
+		int id = 0;
+		std::vector<char> payload;
+
+		size_t memory_size() const { return sizeof(Record) + payload.capacity(); }
+		size_t counted = 0;
+	};
+
+	size_t total(const std::vector<Record> & records)
+	{
+		size_t sum = 0;
+		for (auto & r : records) sum += r.memory_size();
+		return sum;
+	}
+}
+
+int main()
+{
+	std::mt19937 rng(17);
+	std::uniform_int_distribution<int> action(0, 6), bytes(0, 4000);
+
+	EDJournal<Record> journal;
+	journal.set_memory_cap(40000);
+	// the model keeps whole records so sizes can be summed
+	std::vector<Record> done, undone;
+	int next_id = 0, trimmed = 0, discarded = 0;
+	for (int step = 0; step < 5000; step++)
+	{
+		auto a = action(rng);
+		if (a <= 2)
+		{
+			auto & record = journal.push();
+			record.id = next_id++;
+			record.payload.resize(bytes(rng));
+			journal.update_memory();
+			if (a == 2)
+			{
+				// the commit failed: nothing changes, not even the redo list
+				journal.discard_last();
+				discarded++;
+			}
+			else
+			{
+				journal.confirm();
+				done.push_back(record);
+				undone.clear();
+			}
+		}
+		else if (a == 3)
+		{
+			auto record = journal.undo();
+			ED_CHECK((record != nullptr) == !done.empty());
+			if (record)
+			{
+				ED_CHECK(record->id == done.back().id);
+				undone.push_back(done.back());
+				done.pop_back();
+			}
+		}
+		else if (a == 4)
+		{
+			auto record = journal.redo();
+			ED_CHECK((record != nullptr) == !undone.empty());
+			if (record)
+			{
+				ED_CHECK(record->id == undone.back().id);
+				done.push_back(undone.back());
+				undone.pop_back();
+			}
+		}
+		else
+		{
+			// the redo list goes first, then the oldest strokes, but never the latest
+			auto dropped = journal.trim();
+			while (total(done) + total(undone) > journal.get_memory_cap() && !undone.empty()) undone.erase(undone.begin());
+			size_t expected = 0;
+			while (total(done) + total(undone) > journal.get_memory_cap() && done.size() > 1)
+			{
+				done.erase(done.begin());
+				expected++;
+			}
+			ED_CHECK(dropped == expected);
+			trimmed += static_cast<int>(dropped);
+		}
+
+		ED_CHECK(journal.undo_count() == done.size());
+		ED_CHECK(journal.redo_count() == undone.size());
+		ED_CHECK(journal.can_undo() == !done.empty() && journal.can_redo() == !undone.empty());
+		ED_CHECK(journal.memory_used() == total(done) + total(undone));
+	}
+	std::printf("%d strokes, %d discarded, %d trimmed\n", next_id, discarded, trimmed);
+	ED_CHECK(trimmed > 0 && discarded > 0);
+
+	journal.clear();
+	ED_CHECK(!journal.can_undo() && !journal.can_redo() && journal.memory_used() == 0);
+
+	return EDTest::finish("test_journal");
+}
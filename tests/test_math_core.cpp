@@ -0,0 +1,321 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+
+// The EDMathCore templates instantiated for float, double and EDFloat4
+// against the double instantiation, which is itself checked against what
+// each result must satisfy: projected points on their plane and ray,
+// triangle hits at their barycentrics, contour planes through both ends.
+//
+// Created: Oct 19, 2026
+
+#include "EDTest.h"
+#include "EDMathCore.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+	typedef double Triple[3];
+	typedef EDVec3<double> Vec;
+
+	struct Case
+	{
+		// plane point and normal; ray origin and unit direction
+		Triple p, n, o, d;
+		// triangle
+		Triple a, b, c;
+		// stroke ends and a height
+		Triple first, last;
+		double h;
+	};
+
+	// what one instantiation returns for a case, in doubles
+	struct Result
+	{
+		Vec projected;
+		bool hit;
+		double t, u, v;
+		bool contour;
+		Vec contour_point, contour_normal;
+		Vec tangent_point, tangent_normal;
+	};
+
+	// how many cases one scalar of T holds, and moving them in and out
+	template <typename T>
+	struct Lanes
+	{
+		static const int count = 1;
+		static T make(const double * v) { return static_cast<T>(v[0]); }
+		static double get(const T & a, int) { return a; }
+	};
+
+	template <>
+	struct Lanes<EDFloat4>
+	{
+		static const int count = 4;
+		static EDFloat4 make(const double * v)
+		{
+			float f[] = { static_cast<float>(v[0]), static_cast<float>(v[1]), static_cast<float>(v[2]), static_cast<float>(v[3]) };
+			return EDFloat4::load(f);
+		}
+		static double get(const EDFloat4 & a, int k)
+		{
+			float f[4];
+			a.store(f);
+			return f[k];
+		}
+	};
+
+	template <typename T>
+	EDVec3<T> pack(const Case * cases, Triple Case::* member)
+	{
+		double v[3][4];
+		for (int k = 0; k < Lanes<T>::count; k++)
+		{
+			for (int a = 0; a < 3; a++) v[a][k] = (cases[k].*member)[a];
+		}
+		return EDVec3<T>(Lanes<T>::make(v[0]), Lanes<T>::make(v[1]), Lanes<T>::make(v[2]));
+	}
+
+	template <typename T>
+	Vec unpack(const EDVec3<T> & a, int k)
+	{
+		return Vec(Lanes<T>::get(a.x, k), Lanes<T>::get(a.y, k), Lanes<T>::get(a.z, k));
+	}
+
+	// Lanes<T>::count cases at once; a failing template fails every lane
+	template <typename T>
+	void run(const Case * cases, Result * results)
+	{
+		typedef EDVec3<T> V;
+		V p = pack<T>(cases, &Case::p), n = pack<T>(cases, &Case::n);
+		V o = pack<T>(cases, &Case::o), d = pack<T>(cases, &Case::d);
+		V a = pack<T>(cases, &Case::a), b = pack<T>(cases, &Case::b), c = pack<T>(cases, &Case::c);
+		V first = pack<T>(cases, &Case::first), last = pack<T>(cases, &Case::last);
+		double heights[4];
+		for (int k = 0; k < Lanes<T>::count; k++) heights[k] = cases[k].h;
+		T h = Lanes<T>::make(heights);
+
+		V projected = EDMath::project_on_plane(p, n, o, d);
+		T t, u, v;
+		bool hit = EDMath::intersect_triangle(a, b, c, o, d, t, u, v);
+		EDMath::Plane<V, V> contour;
+		bool has_contour = EDMath::contour_plane(first, last, d, contour);
+		auto tangent = EDMath::tangent_plane(first, d, h, n);
+
+		for (int k = 0; k < Lanes<T>::count; k++)
+		{
+			auto & r = results[k];
+			r.projected = unpack(projected, k);
+			r.hit = hit;
+			if (hit)
+			{
+				r.t = Lanes<T>::get(t, k);
+				r.u = Lanes<T>::get(u, k);
+				r.v = Lanes<T>::get(v, k);
+			}
+			r.contour = has_contour;
+			if (has_contour)
+			{
+				r.contour_point = unpack(contour.point, k);
+				r.contour_normal = unpack(contour.normal, k);
+			}
+			r.tangent_point = unpack(tangent.point, k);
+			r.tangent_normal = unpack(tangent.normal, k);
+		}
+	}
+
+	double dot(const Vec & a, const Vec & b) { return EDMath::VectorOps<Vec>::dot(a, b); }
+	Vec cross(const Vec & a, const Vec & b) { return EDMath::VectorOps<Vec>::cross(a, b); }
+	Vec to_vec(const Triple & a) { return Vec(a[0], a[1], a[2]); }
+
+	void check_near(const Vec & got, const Vec & expected, double tolerance)
+	{
+		double scale = 1 + std::sqrt(dot(expected, expected));
+		ED_CHECK_NEAR(got.x, expected.x, tolerance * scale);
+		ED_CHECK_NEAR(got.y, expected.y, tolerance * scale);
+		ED_CHECK_NEAR(got.z, expected.z, tolerance * scale);
+	}
+
+	void check_against(const Result & got, const Result & expected, double tolerance)
+	{
+		check_near(got.projected, expected.projected, tolerance);
+		ED_CHECK(got.hit == expected.hit);
+		if (got.hit && expected.hit)
+		{
+			ED_CHECK_NEAR(got.t, expected.t, tolerance * (1 + std::fabs(expected.t)));
+			ED_CHECK_NEAR(got.u, expected.u, tolerance * (1 + std::fabs(expected.u)));
+			ED_CHECK_NEAR(got.v, expected.v, tolerance * (1 + std::fabs(expected.v)));
+		}
+		ED_CHECK(got.contour == expected.contour);
+		if (got.contour && expected.contour)
+		{
+			check_near(got.contour_point, expected.contour_point, tolerance);
+			check_near(got.contour_normal, expected.contour_normal, tolerance);
+		}
+		check_near(got.tangent_point, expected.tangent_point, tolerance);
+		check_near(got.tangent_normal, expected.tangent_normal, tolerance);
+	}
+
+	// the double results, against what they have to be
+	void check_reference(const Case & k, const Result & r)
+	{
+		auto p = to_vec(k.p), n = to_vec(k.n), o = to_vec(k.o), d = to_vec(k.d);
+		// on the plane and on the ray
+		ED_CHECK_NEAR(dot(r.projected - p, n), 0, 1e-9);
+		auto along = r.projected - o;
+		auto off_ray = cross(along, d);
+		ED_CHECK_NEAR(dot(off_ray, off_ray), 0, 1e-12);
+
+		// o + t d is the point at (u, v)
+		ED_CHECK(r.hit);
+		auto a = to_vec(k.a), b = to_vec(k.b), c = to_vec(k.c);
+		auto at_t = o + d * r.t;
+		auto at_uv = a + (b - a) * r.u + (c - a) * r.v;
+		ED_CHECK_NEAR(at_t.x, at_uv.x, 1e-9);
+		ED_CHECK_NEAR(at_t.y, at_uv.y, 1e-9);
+		ED_CHECK_NEAR(at_t.z, at_uv.z, 1e-9);
+
+		// through both ends, its normal turned towards the ray as far as that allows
+		ED_CHECK(r.contour);
+		auto first = to_vec(k.first), last = to_vec(k.last);
+		ED_CHECK_NEAR(dot(r.contour_point - first, r.contour_normal), 0, 1e-9);
+		ED_CHECK_NEAR(dot(last - first, r.contour_normal), 0, 1e-9);
+		ED_CHECK_NEAR(dot(cross(d, last - first), r.contour_normal), 0, 1e-9);
+		ED_CHECK(dot(r.contour_normal, r.contour_normal) > 1e-6);
+
+		// h back towards the camera, parallel to the surface
+		check_near(r.tangent_point, first - d * k.h, 1e-12);
+		check_near(r.tangent_normal, n, 0);
+	}
+
+	void random_unit(std::mt19937 & random, Triple & out)
+	{
+		std::normal_distribution<double> normal;
+		double length;
+		do
+		{
+			for (int a = 0; a < 3; a++) out[a] = normal(random);
+			length = std::sqrt(out[0] * out[0] + out[1] * out[1] + out[2] * out[2]);
+		} while (length < 1e-3);
+		for (int a = 0; a < 3; a++) out[a] /= length;
+	}
+
+	// planes and triangles at least 0.3 off parallel to the ray, ends at least 0.5 apart
+	Case random_case(std::mt19937 & random)
+	{
+		std::uniform_real_distribution<double> coordinate(-3, 3), offset(-1, 1), distance(1, 5), height(0, 0.5);
+		Case k;
+		for (int a = 0; a < 3; a++) k.o[a] = coordinate(random);
+		random_unit(random, k.d);
+		auto d = to_vec(k.d);
+		do random_unit(random, k.n); while (std::fabs(dot(to_vec(k.n), d)) < 0.3);
+
+		auto t = distance(random);
+		for (int a = 0; a < 3; a++) k.p[a] = k.o[a] + k.d[a] * t + offset(random);
+
+		auto center = to_vec(k.o) + d * distance(random);
+		do
+		{
+			Triple * corners[] = { &k.a, &k.b, &k.c };
+			for (auto corner : corners)
+			{
+				(*corner)[0] = center.x + offset(random);
+				(*corner)[1] = center.y + offset(random);
+				(*corner)[2] = center.z + offset(random);
+			}
+			auto normal = cross(to_vec(k.b) - to_vec(k.a), to_vec(k.c) - to_vec(k.a));
+			auto length = std::sqrt(dot(normal, normal));
+			if (length > 0.2 && std::fabs(dot(normal, d)) > 0.3 * length) break;
+		} while (true);
+
+		do
+		{
+			for (int a = 0; a < 3; a++)
+			{
+				k.first[a] = coordinate(random);
+				k.last[a] = coordinate(random);
+			}
+		} while (dot(to_vec(k.last) - to_vec(k.first), to_vec(k.last) - to_vec(k.first)) < 0.25);
+		k.h = height(random);
+		return k;
+	}
+}
+
+int main()
+{
+	std::mt19937 random(49);
+	// a multiple of four, so EDFloat4 covers every case
+	const size_t count = 400;
+	std::vector<Case> cases;
+	for (size_t i = 0; i < count; i++) cases.push_back(random_case(random));
+
+	std::vector<Result> reference(count), single(count), wide(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		run<double>(&cases[i], &reference[i]);
+		check_reference(cases[i], reference[i]);
+		run<float>(&cases[i], &single[i]);
+		check_against(single[i], reference[i], 1e-4);
+	}
+	for (size_t i = 0; i < count; i += 4)
+	{
+		run<EDFloat4>(&cases[i], &wide[i]);
+		for (size_t k = i; k < i + 4; k++)
+		{
+			check_against(wide[k], reference[k], 1e-4);
+			// the same float arithmetic, lane by lane
+			check_near(wide[k].projected, single[k].projected, 1e-6);
+		}
+	}
+
+	// a ray in the plane of the triangle, and ends that coincide
+	Case flat = cases[0];
+	const Triple a = { 0, 0, 0 }, b = { 1, 0, 0 }, c = { 0, 1, 0 }, along = { 1, 0, 0 };
+	for (int k = 0; k < 3; k++)
+	{
+		flat.a[k] = a[k];
+		flat.b[k] = b[k];
+		flat.c[k] = c[k];
+		flat.d[k] = along[k];
+		flat.last[k] = flat.first[k];
+	}
+	Result r;
+	run<double>(&flat, &r);
+	ED_CHECK(!r.hit && !r.contour);
+	run<float>(&flat, &r);
+	ED_CHECK(!r.hit && !r.contour);
+
+	// with EDFloat4, one such lane fails all four
+	Case mixed[] = { cases[4], cases[5], flat, cases[6] };
+	Result results[4];
+	run<EDFloat4>(mixed, results);
+	for (auto & m : results) ED_CHECK(!m.hit && !m.contour);
+	Case good[] = { cases[4], cases[5], cases[7], cases[6] };
+	run<EDFloat4>(good, results);
+	for (auto & m : results) ED_CHECK(m.hit && m.contour);
+
+	return EDTest::finish("test_math_core");
+}
@@ -0,0 +1,183 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+
+// EDMeshAdjacency against scans of the triangle list: the faces around each
+// vertex, the mean edge length, and rings found by a breadth-first search
+// over the edges, on a sphere and on random triangle soups.
+//
+// Created: Oct 19, 2026
+
+#include "EDTest.h"
+#include "EDTestMesh.h"
+#include "EDMeshAdjacency.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace
+{
+	void check_mesh(const EDMeshSnapshot & mesh, std::mt19937 & random)
+	{
+		EDMeshAdjacency adjacency;
+		adjacency.build(mesh);
+		ED_CHECK(!adjacency.empty());
+		ED_CHECK(adjacency.mesh_revision() == mesh.revision());
+
+		auto vertex_count = mesh.vertex_count();
+		auto & tris = mesh.triangles;
+		// a triangle is listed once per corner, so twice around a repeated one
+		std::vector<std::multiset<int>> faces(vertex_count);
+		std::vector<std::set<int>> neighbours(vertex_count);
+		double total = 0;
+		for (size_t t = 0; t < mesh.triangle_count(); t++)
+		{
+			for (int k = 0; k < 3; k++)
+			{
+				int a = tris[t * 3 + k], b = tris[t * 3 + (k + 1) % 3];
+				faces[a].insert(static_cast<int>(t));
+				neighbours[a].insert(b);
+				neighbours[b].insert(a);
+				double dx = mesh.x[a] - mesh.x[b], dy = mesh.y[a] - mesh.y[b], dz = mesh.z[a] - mesh.z[b];
+				total += std::sqrt(dx * dx + dy * dy + dz * dz);
+			}
+		}
+		ED_CHECK_NEAR(adjacency.mean_edge_length(), total / tris.size(), 1e-5 * total / tris.size());
+
+		int wrong_faces = 0;
+		for (size_t v = 0; v < vertex_count; v++)
+		{
+			std::multiset<int> found(adjacency.faces_begin(static_cast<int>(v)), adjacency.faces_end(static_cast<int>(v)));
+			if (found != faces[v]) wrong_faces++;
+		}
+		ED_CHECK(wrong_faces == 0);
+
+		std::uniform_int_distribution<int> pick(0, static_cast<int>(vertex_count) - 1);
+		for (int q = 0; q < 20; q++)
+		{
+			std::vector<int> seeds;
+			for (int k = 0; k <= q % 4; k++) seeds.push_back(pick(random));
+			if (q % 5 == 0) seeds.push_back(seeds[0]);
+			int rings = q % 6;
+
+			// breadth-first from every seed at once
+			std::vector<int> ring(vertex_count, -1);
+			std::deque<int> queue;
+			for (auto s : seeds)
+			{
+				if (ring[s] == 0) continue;
+				ring[s] = 0;
+				queue.push_back(s);
+			}
+			while (!queue.empty())
+			{
+				auto v = queue.front();
+				queue.pop_front();
+				if (ring[v] == rings) continue;
+				for (auto w : neighbours[v])
+				{
+					if (ring[w] >= 0) continue;
+					ring[w] = ring[v] + 1;
+					queue.push_back(w);
+				}
+			}
+
+			std::vector<int> vertices, ring_of;
+			adjacency.expand_rings(seeds, rings, vertices, &ring_of);
+			ED_CHECK(vertices.size() == ring_of.size());
+			std::set<int> unique(vertices.begin(), vertices.end());
+			ED_CHECK(unique.size() == vertices.size());
+			size_t expected = std::count_if(ring.begin(), ring.end(), [](int r) { return r >= 0; });
+			ED_CHECK(vertices.size() == expected);
+
+			int wrong = 0;
+			for (size_t i = 0; i < vertices.size(); i++)
+			{
+				if (ring[vertices[i]] != ring_of[i]) wrong++;
+				// breadth-first: rings never go down
+				if (i > 0 && ring_of[i] < ring_of[i - 1]) wrong++;
+			}
+			ED_CHECK(wrong == 0);
+
+			std::vector<int> plain;
+			adjacency.expand_rings(seeds, rings, plain);
+			ED_CHECK(plain == vertices);
+		}
+	}
+}
+
+int main()
+{
+	std::mt19937 random(31);
+
+	std::vector<float> points;
+	std::vector<int> triangles;
+	EDTest::make_sphere(16, 32, points, triangles);
+	EDMeshSnapshot sphere;
+	EDTest::load_snapshot(sphere, points, triangles);
+	check_mesh(sphere, random);
+
+	// the ring of a pole is its whole latitude
+	{
+		EDMeshAdjacency adjacency;
+		adjacency.build(sphere);
+		std::vector<int> vertices, ring_of;
+		adjacency.expand_rings(std::vector<int>(1, 0), 1, vertices, &ring_of);
+		ED_CHECK(vertices.size() == 33);
+		ED_CHECK(adjacency.faces_end(0) - adjacency.faces_begin(0) == 32);
+
+		// rings past the far pole stop growing
+		adjacency.expand_rings(std::vector<int>(1, 0), 100, vertices, &ring_of);
+		ED_CHECK(vertices.size() == sphere.vertex_count());
+		ED_CHECK(ring_of.back() == 16);
+	}
+
+	// soups with unused vertices and repeated corners
+	for (int round = 0; round < 4; round++)
+	{
+		std::uniform_real_distribution<float> unit(-1, 1);
+		int vertex_count = 50 + 40 * round;
+		std::uniform_int_distribution<int> pick(0, vertex_count - 1);
+		std::vector<float> soup_points;
+		std::vector<int> soup_triangles;
+		for (int i = 0; i < vertex_count * 3; i++) soup_points.push_back(unit(random));
+		for (int t = 0; t < vertex_count; t++)
+		{
+			for (int k = 0; k < 3; k++) soup_triangles.push_back(pick(random));
+		}
+		EDMeshSnapshot soup;
+		EDTest::load_snapshot(soup, soup_points, soup_triangles);
+		check_mesh(soup, random);
+	}
+
+	// nothing built, nothing found
+	EDMeshAdjacency empty;
+	std::vector<int> vertices;
+	empty.expand_rings(std::vector<int>(1, 0), 2, vertices);
+	ED_CHECK(empty.empty() && vertices.empty());
+
+	return EDTest::finish("test_mesh_adjacency");
+}
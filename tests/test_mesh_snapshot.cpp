@@ -0,0 +1,178 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+
+// EDMeshSnapshot against a double-precision transform of the raw points and
+// normals summed triangle by triangle; and when update() reports a change,
+// bumps the revision and asks for the triangles again.
+//
+// Created: Oct 19, 2026
+
+#include "EDTest.h"
+#include "EDTestMesh.h"
+#include "EDMeshSnapshot.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+	void check_points(const EDMeshSnapshot & mesh, const std::vector<float> & points, const double m[4][4])
+	{
+		double worst = 0;
+		for (size_t i = 0; i < mesh.vertex_count(); i++)
+		{
+			double p[] = { points[i * 3], points[i * 3 + 1], points[i * 3 + 2] };
+			double world[3];
+			for (int c = 0; c < 3; c++) world[c] = p[0] * m[0][c] + p[1] * m[1][c] + p[2] * m[2][c] + m[3][c];
+			worst = std::max(worst, std::fabs(mesh.x[i] - world[0]));
+			worst = std::max(worst, std::fabs(mesh.y[i] - world[1]));
+			worst = std::max(worst, std::fabs(mesh.z[i] - world[2]));
+		}
+		ED_CHECK_NEAR(worst, 0.0, 1e-5);
+	}
+
+	void check_normals(const EDMeshSnapshot & mesh)
+	{
+		auto tri_count = mesh.triangle_count();
+		ED_CHECK(mesh.face_normals.size() == tri_count * 3);
+		ED_CHECK(mesh.vertex_normals.size() == mesh.vertex_count() * 3);
+
+		std::vector<double> sums(mesh.vertex_count() * 3, 0.0);
+		double worst_face = 0;
+		for (size_t t = 0; t < tri_count; t++)
+		{
+			const int * tri = &mesh.triangles[t * 3];
+			double e1[] = { mesh.x[tri[1]] - mesh.x[tri[0]], mesh.y[tri[1]] - mesh.y[tri[0]], mesh.z[tri[1]] - mesh.z[tri[0]] };
+			double e2[] = { mesh.x[tri[2]] - mesh.x[tri[0]], mesh.y[tri[2]] - mesh.y[tri[0]], mesh.z[tri[2]] - mesh.z[tri[0]] };
+			double n[] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+			double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+			for (int a = 0; a < 3; a++)
+			{
+				worst_face = std::max(worst_face, std::fabs(mesh.face_normals[t * 3 + a] - n[a] / length));
+				for (int k = 0; k < 3; k++) sums[tri[k] * 3 + a] += n[a];
+			}
+		}
+		ED_CHECK_NEAR(worst_face, 0.0, 1e-4);
+
+		double worst_vertex = 0;
+		for (size_t i = 0; i < mesh.vertex_count(); i++)
+		{
+			double * s = &sums[i * 3];
+			double length = std::sqrt(s[0] * s[0] + s[1] * s[1] + s[2] * s[2]);
+			for (int a = 0; a < 3; a++) worst_vertex = std::max(worst_vertex, std::fabs(mesh.vertex_normals[i * 3 + a] - s[a] / length));
+		}
+		ED_CHECK_NEAR(worst_vertex, 0.0, 1e-4);
+	}
+}
+
+int main()
+{
+	// enough vertices for several transform and hash chunks
+	std::vector<float> points;
+	std::vector<int> triangles;
+	EDTest::make_sphere(128, 256, points, triangles);
+	auto vertex_count = points.size() / 3;
+	auto topology = EDMeshSnapshot::hash_words(reinterpret_cast<const uint32_t *>(triangles.data()), triangles.size());
+
+	// chunked hashing does not depend on the threads
+	ED_CHECK(topology == EDMeshSnapshot::hash_words(reinterpret_cast<const uint32_t *>(triangles.data()), triangles.size(), false));
+	ED_CHECK(topology != EDMeshSnapshot::hash_words(reinterpret_cast<const uint32_t *>(triangles.data()), triangles.size() - 1));
+
+	// rotation about y, a non-uniform scale and a translation, as row vectors
+	const double c = std::cos(0.7), s = std::sin(0.7);
+	const double m[4][4] = { { 2 * c, 0, -2 * s, 0 }, { 0, 0.5, 0, 0 }, { 3 * s, 0, 3 * c, 0 }, { 1, -2, 5, 1 } };
+
+	EDMeshSnapshot mesh;
+	ED_CHECK(mesh.empty() && mesh.revision() == 0);
+	ED_CHECK(mesh.update(points.data(), vertex_count, m, topology));
+	ED_CHECK(mesh.revision() == 1);
+	ED_CHECK(mesh.topology_changed());
+	mesh.set_triangles(std::vector<int>(triangles));
+	ED_CHECK(!mesh.topology_changed());
+	mesh.build_normals();
+	ED_CHECK(mesh.vertex_count() == vertex_count);
+	ED_CHECK(mesh.triangle_count() == triangles.size() / 3);
+	check_points(mesh, points, m);
+	check_normals(mesh);
+
+	// the serial paths agree with the parallel ones
+	{
+		EDMeshSnapshot serial;
+		serial.update(points.data(), vertex_count, m, topology, false);
+		serial.set_triangles(std::vector<int>(triangles));
+		serial.build_normals(false);
+		ED_CHECK(serial.hash() == mesh.hash());
+		ED_CHECK(serial.x == mesh.x && serial.y == mesh.y && serial.z == mesh.z);
+		ED_CHECK(serial.vertex_normals == mesh.vertex_normals);
+	}
+
+	// an outward-wound sphere has outward normals, even through the scale
+	int inward = 0;
+	for (size_t i = 0; i < vertex_count; i++)
+	{
+		double centre_x = m[3][0], centre_y = m[3][1], centre_z = m[3][2];
+		double d = (mesh.x[i] - centre_x) * mesh.vertex_normals[i * 3] + (mesh.y[i] - centre_y) * mesh.vertex_normals[i * 3 + 1]
+			+ (mesh.z[i] - centre_z) * mesh.vertex_normals[i * 3 + 2];
+		if (d <= 0) inward++;
+	}
+	ED_CHECK(inward == 0);
+
+	// the same points, matrix and topology are no change
+	auto hash = mesh.hash();
+	ED_CHECK(!mesh.update(points.data(), vertex_count, m, topology));
+	ED_CHECK(mesh.revision() == 1 && mesh.hash() == hash);
+
+	// one moved point is, but keeps the triangles
+	std::mt19937 random(3);
+	auto moved = points;
+	moved[std::uniform_int_distribution<size_t>(0, moved.size() - 1)(random)] += 1e-3f;
+	ED_CHECK(mesh.update(moved.data(), vertex_count, m, topology));
+	ED_CHECK(mesh.revision() == 2 && !mesh.topology_changed());
+	check_points(mesh, moved, m);
+
+	// so is a new matrix
+	const double identity[4][4] = { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 }, { 0, 0, 0, 1 } };
+	ED_CHECK(mesh.update(moved.data(), vertex_count, identity, topology));
+	ED_CHECK(mesh.revision() == 3 && !mesh.topology_changed());
+	check_points(mesh, moved, identity);
+
+	// a new topology key asks for the triangles again
+	ED_CHECK(mesh.update(moved.data(), vertex_count, identity, topology + 1));
+	ED_CHECK(mesh.revision() == 4 && mesh.topology_changed());
+	mesh.set_triangles(std::vector<int>(triangles));
+	mesh.build_normals();
+	check_normals(mesh);
+
+	mesh.clear();
+	ED_CHECK(mesh.empty() && mesh.revision() == 5);
+	mesh.clear();
+	ED_CHECK(mesh.revision() == 5);
+
+	// after a clear the same content is new again
+	ED_CHECK(mesh.update(moved.data(), vertex_count, identity, topology + 1));
+	ED_CHECK(mesh.topology_changed());
+
+	return EDTest::finish("test_mesh_snapshot");
+}
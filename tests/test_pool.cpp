@@ -0,0 +1,124 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+// EDPool against a plain model of its slots: reference counts, slot reuse
+// and the live count through random create, retain, release and destroy.
+//
+// Created: Oct 19, 2026
+
+#include "EDTest.h"
+#include "EDPool.h"
+
+#include <random>
+#include <vector>
+
+int main()
+{
+	std::mt19937 rng(7);
+	std::uniform_int_distribution<int> action(0, 3);
+
+	EDPool<int> pool;
+	// -1 for a free slot, as the pool keeps them
+	std::vector<int> counts, values;
+	std::vector<size_t> freed;
+	for (int step = 0; step < 20000; step++)
+	{
+		std::vector<size_t> live;
+		for (size_t i = 0; i < counts.size(); i++)
+		{
+			if (counts[i] >= 0) live.push_back(i);
+		}
+
+		int a = live.empty() ? 0 : action(rng);
+		if (a == 0)
+		{
+			auto index = pool.create(step);
+			// a freed slot is reused before the pool grows
+			if (!freed.empty())
+			{
+				ED_CHECK(index == freed.back());
+				freed.pop_back();
+			}
+			else
+			{
+				ED_CHECK(index == counts.size());
+				counts.push_back(0);
+				values.push_back(0);
+			}
+			if (index < counts.size())
+			{
+				counts[index] = 0;
+				values[index] = step;
+			}
+			continue;
+		}
+
+		auto index = live[rng() % live.size()];
+		if (a == 1)
+		{
+			pool.retain(index);
+			counts[index]++;
+		}
+		else if (a == 2)
+		{
+			bool freed_now = counts[index] <= 1;
+			ED_CHECK(pool.release(index) == freed_now);
+			if (freed_now)
+			{
+				counts[index] = -1;
+				freed.push_back(index);
+			}
+			else
+			{
+				counts[index]--;
+			}
+		}
+		else if (rng() % 8 == 0)
+		{
+			pool.destroy(index);
+			// destroying a free slot again does nothing
+			pool.destroy(index);
+			counts[index] = -1;
+			freed.push_back(index);
+		}
+
+		size_t alive = 0;
+		for (size_t i = 0; i < counts.size(); i++)
+		{
+			ED_CHECK(pool.alive(i) == (counts[i] >= 0));
+			if (counts[i] >= 0)
+			{
+				alive++;
+				ED_CHECK(pool[i] == values[i]);
+			}
+		}
+		ED_CHECK(pool.size() == alive);
+		ED_CHECK(pool.slot_count() == counts.size());
+	}
+	ED_CHECK(!pool.alive(counts.size()));
+	std::printf("%zu slots, %zu live\n", pool.slot_count(), pool.size());
+
+	pool.clear();
+	ED_CHECK(pool.size() == 0 && pool.slot_count() == 0);
+
+	return EDTest::finish("test_pool");
+}
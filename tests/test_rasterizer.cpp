@@ -0,0 +1,236 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+// EDRasterizer against a per-pixel reference in doubles. Screen-space
+// triangles are tested with edge functions at every pixel centre; the
+// clip-space path solves for the point of each triangle on the pixel's
+// line of sight, so near-plane clipping is checked without clipping
+// anything. Pixels within a hair of an edge or of a depth tie are skipped.
+//
+// Created: Oct 19, 2026
+
+#include "EDTest.h"
+#include "EDRasterizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+	const int kWidth = 203, kHeight = 150;
+	// barycentric and depth margins below which a pixel is too close to call
+	const double kEdge = 1e-3, kDepthGap = 1e-4;
+
+	struct Reference
+	{
+		int triangle = EDRasterizer::kNoTriangle;
+		double depth = std::numeric_limits<double>::max();
+		bool ambiguous = false;
+	};
+
+	// keeps the nearest hit, and whether another came too close to tell apart
+	void consider(Reference & r, int triangle, double depth, double margin)
+	{
+		if (std::fabs(margin) < kEdge)
+		{
+			r.ambiguous = true;
+			if (margin < 0) return;
+		}
+		if (margin < 0) return;
+		if (std::fabs(depth - r.depth) < kDepthGap) r.ambiguous = true;
+		if (depth < r.depth)
+		{
+			r.depth = depth;
+			r.triangle = triangle;
+		}
+	}
+
+	// barycentrics of (px, py) in a screen triangle, either facing
+	bool barycentric(const EDRasterizer::Vertex & a, const EDRasterizer::Vertex & b, const EDRasterizer::Vertex & c, double px, double py, double l[3])
+	{
+		double area = (double(b.x) - a.x) * (double(c.y) - a.y) - (double(b.y) - a.y) * (double(c.x) - a.x);
+		if (std::fabs(area) < 1e-9) return false;
+		l[0] = ((double(b.x) - px) * (double(c.y) - py) - (double(b.y) - py) * (double(c.x) - px)) / area;
+		l[1] = ((double(c.x) - px) * (double(a.y) - py) - (double(c.y) - py) * (double(a.x) - px)) / area;
+		l[2] = 1 - l[0] - l[1];
+		return true;
+	}
+
+	// solves a 3x3 system by Cramer's rule
+	bool solve(const double m[3][3], const double r[3], double out[3])
+	{
+		auto det = [](const double a[3][3])
+		{
+			return a[0][0] * (a[1][1] * a[2][2] - a[1][2] * a[2][1]) - a[0][1] * (a[1][0] * a[2][2] - a[1][2] * a[2][0]) + a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0]);
+		};
+		double d = det(m);
+		if (std::fabs(d) < 1e-12) return false;
+		for (int k = 0; k < 3; k++)
+		{
+			double a[3][3];
+			for (int i = 0; i < 3; i++)
+			{
+				for (int j = 0; j < 3; j++) a[i][j] = j == k ? r[i] : m[i][j];
+			}
+			out[k] = det(a) / d;
+		}
+		return true;
+	}
+
+	int compare(const EDRasterizer & raster, const std::vector<Reference> & expected, int & checked)
+	{
+		int wrong = 0;
+		for (int y = 0; y < kHeight; y++)
+		{
+			for (int x = 0; x < kWidth; x++)
+			{
+				auto & r = expected[y * kWidth + x];
+				if (r.ambiguous) continue;
+				checked++;
+				if (!ED_CHECK(raster.triangle_at(x, y) == r.triangle))
+				{
+					if (++wrong > 10) return wrong;
+					continue;
+				}
+				if (r.triangle != EDRasterizer::kNoTriangle) ED_CHECK_NEAR(raster.depth_at(x, y), r.depth, 1e-4);
+			}
+		}
+		return wrong;
+	}
+}
+
+int main()
+{
+	std::mt19937 rng(23);
+	std::uniform_real_distribution<float> sx(-40, kWidth + 40), sy(-40, kHeight + 40), depth(-1, 1), unit(-1, 1);
+
+	// screen space
+	std::vector<EDRasterizer::Vertex> vertices;
+	std::vector<int> indices;
+	for (int t = 0; t < 60; t++)
+	{
+		float cx = sx(rng), cy = sy(rng), size = 10 + 40 * (unit(rng) + 1);
+		for (int k = 0; k < 3; k++)
+		{
+			EDRasterizer::Vertex v = { cx + size * unit(rng), cy + size * unit(rng), depth(rng) };
+			vertices.push_back(v);
+			indices.push_back(static_cast<int>(vertices.size()) - 1);
+		}
+	}
+	EDRasterizer raster;
+	raster.resize(kWidth, kHeight);
+	ED_CHECK(raster.row_stride() % 4 == 0 && raster.row_stride() >= static_cast<size_t>(kWidth));
+
+	std::vector<Reference> expected(kWidth * kHeight);
+	for (int y = 0; y < kHeight; y++)
+	{
+		for (int x = 0; x < kWidth; x++)
+		{
+			auto & r = expected[y * kWidth + x];
+			for (size_t t = 0; t < indices.size() / 3; t++)
+			{
+				auto & a = vertices[indices[t * 3]];
+				auto & b = vertices[indices[t * 3 + 1]];
+				auto & c = vertices[indices[t * 3 + 2]];
+				double l[3];
+				if (!barycentric(a, b, c, x + 0.5, y + 0.5, l)) continue;
+				consider(r, static_cast<int>(t), l[0] * a.z + l[1] * b.z + l[2] * c.z, std::min(l[0], std::min(l[1], l[2])));
+			}
+		}
+	}
+	int checked = 0;
+	for (int parallel = 0; parallel < 2; parallel++)
+	{
+		raster.rasterize(vertices, indices, parallel != 0);
+		compare(raster, expected, checked);
+	}
+
+	// clip space: a perspective camera at the origin looking down -z, near 1, far 100
+	const double near_z = 1, far_z = 100, focal = 1.5, aspect = double(kWidth) / kHeight;
+	std::vector<EDRasterizer::ClipVertex> clip;
+	indices.clear();
+	std::uniform_real_distribution<double> side(-6, 6), ahead(-12, 3);
+	int crossing = 0;
+	for (int t = 0; t < 60; t++)
+	{
+		double cx = side(rng), cy = side(rng) / aspect, cz = ahead(rng);
+		int behind = 0;
+		for (int k = 0; k < 3; k++)
+		{
+			double x = cx + 3 * unit(rng), y = cy + 3 * unit(rng), z = cz + 3 * unit(rng);
+			EDRasterizer::ClipVertex v;
+			v.x = static_cast<float>(x * focal / aspect);
+			v.y = static_cast<float>(y * focal);
+			v.z = static_cast<float>(z * (far_z + near_z) / (near_z - far_z) + 2 * far_z * near_z / (near_z - far_z));
+			v.w = static_cast<float>(-z);
+			behind += v.z + v.w < 0;
+			clip.push_back(v);
+			indices.push_back(static_cast<int>(clip.size()) - 1);
+		}
+		crossing += behind == 1 || behind == 2;
+	}
+	std::fill(expected.begin(), expected.end(), Reference());
+	for (int y = 0; y < kHeight; y++)
+	{
+		for (int x = 0; x < kWidth; x++)
+		{
+			// a point b0 V0 + b1 V1 + b2 V2 on the line of sight has x = nx w and y = ny w
+			double nx = (x + 0.5) / kWidth * 2 - 1, ny = (y + 0.5) / kHeight * 2 - 1;
+			auto & r = expected[y * kWidth + x];
+			for (size_t t = 0; t < indices.size() / 3; t++)
+			{
+				const EDRasterizer::ClipVertex * v[] = { &clip[indices[t * 3]], &clip[indices[t * 3 + 1]], &clip[indices[t * 3 + 2]] };
+				double m[3][3], rhs[] = { 0, 0, 1 }, b[3];
+				for (int k = 0; k < 3; k++)
+				{
+					m[0][k] = v[k]->x - nx * v[k]->w;
+					m[1][k] = v[k]->y - ny * v[k]->w;
+					m[2][k] = 1;
+				}
+				if (!solve(m, rhs, b)) continue;
+				double z = 0, w = 0;
+				for (int k = 0; k < 3; k++)
+				{
+					z += b[k] * v[k]->z;
+					w += b[k] * v[k]->w;
+				}
+				if (w <= 0) continue;
+				// the near plane is an edge too once the triangle reaches behind it
+				double margin = std::min(b[0], std::min(b[1], b[2]));
+				margin = std::min(margin, (z + w) / w);
+				consider(r, static_cast<int>(t), z / w, margin);
+			}
+		}
+	}
+	raster.rasterize(clip, indices);
+	compare(raster, expected, checked);
+	std::printf("%d pixels checked, %d triangles cross the near plane\n", checked, crossing);
+	ED_CHECK(crossing > 0 && checked > kWidth * kHeight);
+
+	// out of the port
+	ED_CHECK(raster.triangle_at(-1, 0) == EDRasterizer::kNoTriangle && raster.triangle_at(0, kHeight) == EDRasterizer::kNoTriangle);
+
+	return EDTest::finish("test_rasterizer");
+}
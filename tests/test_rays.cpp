@@ -0,0 +1,250 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+// Every kernel table this CPU can run against a double-precision reference:
+// ray generation, plane projection, minimum-skew planes and toPort.
+//
+// Created: Oct 19, 2026
+
+#include "EDTest.h"
+#include "EDKernels.h"
+#include "EDRays.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+	// SIMD paths work in floats; everything is held to 1e-5 of the magnitude involved
+	const double kTolerance = 1e-5;
+	// odd, so every table runs both its vector body and its scalar tail
+	const size_t kCount = 61;
+	const int kWidth = 960, kHeight = 540;
+
+	typedef double Matrix[4][4];
+
+	void multiply(const Matrix a, const Matrix b, Matrix out)
+	{
+		for (int r = 0; r < 4; r++)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				out[r][c] = 0;
+				for (int k = 0; k < 4; k++) out[r][c] += a[r][k] * b[k][c];
+			}
+		}
+	}
+
+	bool invert(const Matrix m, Matrix out)
+	{
+		double a[4][8];
+		for (int r = 0; r < 4; r++)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				a[r][c] = m[r][c];
+				a[r][c + 4] = r == c ? 1 : 0;
+			}
+		}
+		for (int c = 0; c < 4; c++)
+		{
+			int pivot = c;
+			for (int r = c + 1; r < 4; r++)
+			{
+				if (std::fabs(a[r][c]) > std::fabs(a[pivot][c])) pivot = r;
+			}
+			if (a[pivot][c] == 0) return false;
+			for (int k = 0; k < 8; k++) std::swap(a[c][k], a[pivot][k]);
+			double scale = 1 / a[c][c];
+			for (int k = 0; k < 8; k++) a[c][k] *= scale;
+			for (int r = 0; r < 4; r++)
+			{
+				if (r == c) continue;
+				double f = a[r][c];
+				for (int k = 0; k < 8; k++) a[r][k] -= f * a[c][k];
+			}
+		}
+		for (int r = 0; r < 4; r++)
+		{
+			for (int c = 0; c < 4; c++) out[r][c] = a[r][c + 4];
+		}
+		return true;
+	}
+
+	// a perspective camera at (0.3, 0.2, 6) looking down -z, row vectors as in Maya
+	void camera(Matrix view_projection)
+	{
+		const double near_z = 0.1, far_z = 100, f = 1 / std::tan(0.4), aspect = double(kWidth) / kHeight;
+		Matrix view = { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 }, { -0.3, -0.2, -6, 1 } };
+		Matrix projection = {
+			{ f / aspect, 0, 0, 0 },
+			{ 0, f, 0, 0 },
+			{ 0, 0, (far_z + near_z) / (near_z - far_z), -1 },
+			{ 0, 0, 2 * far_z * near_z / (near_z - far_z), 0 } };
+		multiply(view, projection, view_projection);
+	}
+
+	void transform(const double p[4], const Matrix m, double out[4])
+	{
+		for (int c = 0; c < 4; c++)
+		{
+			out[c] = p[0] * m[0][c] + p[1] * m[1][c] + p[2] * m[2][c] + p[3] * m[3][c];
+		}
+	}
+
+	// the ray through a pixel, in doubles: origin on the near plane, unit direction
+	void reference_ray(const Matrix inverse, double px, double py, double o[3], double d[3])
+	{
+		double nx = px * 2 / kWidth - 1, ny = py * 2 / kHeight - 1;
+		double near_ndc[] = { nx, ny, -1, 1 }, far_ndc[] = { nx, ny, 1, 1 };
+		double near_h[4], far_h[4];
+		transform(near_ndc, inverse, near_h);
+		transform(far_ndc, inverse, far_h);
+		double length = 0;
+		for (int c = 0; c < 3; c++)
+		{
+			o[c] = near_h[c] / near_h[3];
+			d[c] = far_h[c] / far_h[3] - o[c];
+			length += d[c] * d[c];
+		}
+		length = std::sqrt(length);
+		for (int c = 0; c < 3; c++) d[c] /= length;
+	}
+
+	void test_table(const EDKernelTable & kernels, const Matrix view_projection, const Matrix inverse)
+	{
+		std::printf("kernels: %s\n", kernels.name);
+		std::mt19937 rng(7);
+		std::uniform_real_distribution<float> along_x(0, kWidth), along_y(0, kHeight), unit(-1, 1);
+
+		std::vector<float> px(kCount), py(kCount);
+		for (size_t i = 0; i < kCount; i++)
+		{
+			px[i] = along_x(rng);
+			py[i] = along_y(rng);
+		}
+
+		float m[4][4];
+		for (int r = 0; r < 4; r++)
+		{
+			for (int c = 0; c < 4; c++) m[r][c] = static_cast<float>(inverse[r][c]);
+		}
+		EDRayBatch rays;
+		rays.resize(kCount);
+		kernels.unproject(m, 2.0f / kWidth, 2.0f / kHeight, px.data(), py.data(), 0, kCount, rays);
+		for (size_t i = 0; i < kCount; i++)
+		{
+			double o[3], d[3];
+			reference_ray(inverse, px[i], py[i], o, d);
+			ED_CHECK_NEAR(rays.ox[i], o[0], kTolerance * 10);
+			ED_CHECK_NEAR(rays.oy[i], o[1], kTolerance * 10);
+			ED_CHECK_NEAR(rays.oz[i], o[2], kTolerance * 10);
+			ED_CHECK_NEAR(rays.dx[i], d[0], kTolerance);
+			ED_CHECK_NEAR(rays.dy[i], d[1], kTolerance);
+			ED_CHECK_NEAR(rays.dz[i], d[2], kTolerance);
+		}
+
+		// a tilted plane a few units in front of the camera
+		EDPlane plane = { { 0.1, -0.2, 1.5 }, { 0.2, 0.1, 0.97 } };
+		std::vector<float> x(kCount), y(kCount), z(kCount);
+		size_t begin = 3;
+		kernels.project_on_plane(rays, begin, kCount, plane, x.data(), y.data(), z.data());
+		for (size_t i = begin; i < kCount; i++)
+		{
+			double o[] = { rays.ox[i], rays.oy[i], rays.oz[i] };
+			double d[] = { rays.dx[i], rays.dy[i], rays.dz[i] };
+			auto & p = plane.point;
+			auto & n = plane.normal;
+			double t = ((p[0] - o[0]) * n[0] + (p[1] - o[1]) * n[1] + (p[2] - o[2]) * n[2])
+				/ (d[0] * n[0] + d[1] * n[1] + d[2] * n[2]);
+			double scale = kTolerance * std::max(1.0, std::fabs(t));
+			ED_CHECK_NEAR(x[i], o[0] + t * d[0], scale);
+			ED_CHECK_NEAR(y[i], o[1] + t * d[1], scale);
+			ED_CHECK_NEAR(z[i], o[2] + t * d[2], scale);
+		}
+
+		std::vector<float> rx(kCount), ry(kCount), rz(kCount), nx(kCount), ny(kCount), nz(kCount);
+		for (size_t i = 0; i < kCount; i++)
+		{
+			rx[i] = unit(rng);
+			ry[i] = unit(rng);
+			rz[i] = unit(rng);
+		}
+		kernels.minimum_skew_viewplanes(kCount, rx.data(), ry.data(), rz.data(), rays.dx.data(), rays.dy.data(), rays.dz.data(),
+			nx.data(), ny.data(), nz.data());
+		for (size_t i = 0; i < kCount; i++)
+		{
+			double r[] = { rx[i], ry[i], rz[i] };
+			double d[] = { rays.dx[i], rays.dy[i], rays.dz[i] };
+			double c[] = { r[1] * d[2] - r[2] * d[1], r[2] * d[0] - r[0] * d[2], r[0] * d[1] - r[1] * d[0] };
+			ED_CHECK_NEAR(nx[i], d[1] * c[2] - d[2] * c[1], kTolerance);
+			ED_CHECK_NEAR(ny[i], d[2] * c[0] - d[0] * c[2], kTolerance);
+			ED_CHECK_NEAR(nz[i], d[0] * c[1] - d[1] * c[0], kTolerance);
+		}
+
+		// some points behind the camera, which come back as NaN
+		for (size_t i = 0; i < kCount; i++)
+		{
+			x[i] = 3 * unit(rng);
+			y[i] = 3 * unit(rng);
+			z[i] = i % 7 == 0 ? 7 + unit(rng) : 2 * unit(rng);
+		}
+		std::vector<float> sx(kCount), sy(kCount), sz(kCount);
+		for (int r = 0; r < 4; r++)
+		{
+			for (int c = 0; c < 4; c++) m[r][c] = static_cast<float>(view_projection[r][c]);
+		}
+		kernels.to_port(m, static_cast<float>(kWidth), static_cast<float>(kHeight), x.data(), y.data(), z.data(), kCount,
+			sx.data(), sy.data(), sz.data());
+		for (size_t i = 0; i < kCount; i++)
+		{
+			double p[] = { x[i], y[i], z[i], 1 }, clip[4];
+			transform(p, view_projection, clip);
+			if (!(clip[3] > 1e-6))
+			{
+				ED_CHECK(std::isnan(sx[i]) && std::isnan(sy[i]) && std::isnan(sz[i]));
+				continue;
+			}
+			double ref_x = (clip[0] / clip[3] * 0.5 + 0.5) * kWidth;
+			double ref_y = (clip[1] / clip[3] * 0.5 + 0.5) * kHeight;
+			// to 1e-5 of the port, about a hundredth of a pixel
+			ED_CHECK_NEAR(sx[i], ref_x, kTolerance * kWidth);
+			ED_CHECK_NEAR(sy[i], ref_y, kTolerance * kHeight);
+			ED_CHECK_NEAR(sz[i], clip[2] / clip[3], kTolerance);
+		}
+	}
+}
+
+int main()
+{
+	Matrix view_projection, inverse;
+	camera(view_projection);
+	if (!ED_CHECK(invert(view_projection, inverse))) return EDTest::finish("test_rays");
+
+	test_table(*EDKernels::table(EDKernels::kBaseline), view_projection, inverse);
+	auto avx2 = EDKernels::table(EDKernels::kAVX2);
+	if (avx2 && EDKernels::detect() == EDKernels::kAVX2) test_table(*avx2, view_projection, inverse);
+
+	return EDTest::finish("test_rays");
+}
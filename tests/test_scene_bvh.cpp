@@ -0,0 +1,333 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+
+// EDSceneBvh against a brute-force double-precision test of every triangle
+// of every instance, moved to world space by hand: the nearest hit and the
+// full sorted list of hits, after adding, moving, reshaping, pinning and
+// dropping instances.
+//
+// Created: Oct 19, 2026
+
+#include "EDTest.h"
+#include "EDTestMesh.h"
+#include "EDSceneBvh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	struct Object
+	{
+		std::string key;
+		std::vector<float> points;
+		std::vector<int> triangles;
+		double matrix[4][4];
+		uint64_t hash;
+	};
+
+	struct Reference
+	{
+		double t;
+		std::string key;
+		int triangle;
+		bool operator<(const Reference & o) const { return t < o.t; }
+	};
+
+	void random_matrix(std::mt19937 & random, double m[4][4])
+	{
+		std::uniform_real_distribution<double> angle(0, 6.2831853), scale(0.4, 1.6), offset(-4, 4);
+		double a = angle(random), b = angle(random), s = scale(random);
+		double ca = std::cos(a), sa = std::sin(a), cb = std::cos(b), sb = std::sin(b);
+		// rotation about z then x, scaled, as row vectors
+		double r[3][3] = { { ca, sa, 0 }, { -sa * cb, ca * cb, sb }, { sa * sb, -ca * sb, cb } };
+		for (int i = 0; i < 3; i++)
+		{
+			for (int j = 0; j < 3; j++) m[i][j] = r[i][j] * s;
+			m[i][3] = 0;
+		}
+		m[3][0] = offset(random);
+		m[3][1] = offset(random);
+		m[3][2] = offset(random);
+		m[3][3] = 1;
+	}
+
+	Object sphere(const std::string & key, int rings, std::mt19937 & random)
+	{
+		Object o;
+		o.key = key;
+		EDTest::make_sphere(rings, rings * 2, o.points, o.triangles);
+		random_matrix(random, o.matrix);
+		o.hash = static_cast<uint64_t>(rings);
+		return o;
+	}
+
+	Object soup(const std::string & key, int count, std::mt19937 & random)
+	{
+		Object o;
+		o.key = key;
+		std::uniform_real_distribution<float> unit(-1, 1);
+		std::uniform_int_distribution<int> pick(0, count * 3 - 1);
+		for (int i = 0; i < count * 9; i++) o.points.push_back(unit(random));
+		for (int t = 0; t < count; t++)
+		{
+			for (int k = 0; k < 3; k++) o.triangles.push_back(pick(random));
+		}
+		random_matrix(random, o.matrix);
+		o.hash = 1000 + static_cast<uint64_t>(count);
+		return o;
+	}
+
+	///
+	//  Every hit along the ray over all objects, nearest first. margin gets
+	//  the smallest distance of any hit from a triangle edge, in barycentric
+	//  units, so rays grazing an edge can be skipped.
+	///
+	void reference_hits(const std::vector<const Object *> & scene, const float origin[3], const float direction[3],
+		std::vector<Reference> & hits, double & margin)
+	{
+		hits.clear();
+		margin = 1;
+		double d[] = { direction[0], direction[1], direction[2] };
+		auto cross = [](const double * a, const double * b, double * out)
+		{
+			out[0] = a[1] * b[2] - a[2] * b[1];
+			out[1] = a[2] * b[0] - a[0] * b[2];
+			out[2] = a[0] * b[1] - a[1] * b[0];
+		};
+		for (auto object : scene)
+		{
+			auto & m = object->matrix;
+			for (size_t t = 0; t < object->triangles.size(); t += 3)
+			{
+				double v[3][3];
+				for (int k = 0; k < 3; k++)
+				{
+					const float * p = &object->points[object->triangles[t + k] * 3];
+					for (int c = 0; c < 3; c++) v[k][c] = p[0] * m[0][c] + p[1] * m[1][c] + p[2] * m[2][c] + m[3][c];
+				}
+				double e1[3], e2[3], s[3], p[3], q[3];
+				for (int a = 0; a < 3; a++)
+				{
+					e1[a] = v[1][a] - v[0][a];
+					e2[a] = v[2][a] - v[0][a];
+					s[a] = origin[a] - v[0][a];
+				}
+				cross(d, e2, p);
+				double det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+				if (std::fabs(det) < 1e-12) continue;
+				double u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) / det;
+				cross(s, e1, q);
+				double w = (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) / det;
+				double hit_t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) / det;
+				double edge = std::min(std::min(u, w), 1 - u - w);
+				if (edge < -1e-3 || hit_t < 0) continue;
+				margin = std::min(margin, std::fabs(edge));
+				if (edge < 0) continue;
+				Reference hit = { hit_t, object->key, static_cast<int>(t / 3) };
+				hits.push_back(hit);
+			}
+		}
+		std::sort(hits.begin(), hits.end());
+	}
+
+	void check_scene(const EDSceneBvh & bvh, const std::vector<const Object *> & scene, std::mt19937 & random)
+	{
+		ED_CHECK(bvh.instance_count() == scene.size());
+		ED_CHECK(bvh.empty() == scene.empty());
+		for (auto object : scene) ED_CHECK(bvh.has_instance(object->key));
+
+		std::uniform_real_distribution<float> unit(-6, 6);
+		int tested = 0, hit_rays = 0;
+		std::vector<Reference> expected;
+		std::vector<EDSceneBvh::Hit> hits;
+		for (int r = 0; r < 300; r++)
+		{
+			float origin[3], direction[3], length = 0;
+			for (int a = 0; a < 3; a++)
+			{
+				origin[a] = unit(random) * 2;
+				direction[a] = unit(random) * 0.5f - origin[a];
+				length += direction[a] * direction[a];
+			}
+			for (int a = 0; a < 3; a++) direction[a] /= std::sqrt(length);
+
+			double margin;
+			reference_hits(scene, origin, direction, expected, margin);
+			if (margin < 1e-4) continue;
+			tested++;
+
+			EDSceneBvh::Hit hit;
+			bool found = bvh.intersect(origin, direction, hit);
+			if (!ED_CHECK(found == !expected.empty())) continue;
+
+			bvh.intersect_all(origin, direction, hits);
+			if (!ED_CHECK(hits.size() == expected.size())) continue;
+			if (!found) continue;
+			hit_rays++;
+
+			auto tolerance = [](double t) { return 1e-4 * std::max(1.0, t); };
+			ED_CHECK_NEAR(hit.t, expected[0].t, tolerance(expected[0].t));
+			// the nearest is told apart only when no other hit ties with it
+			if (expected.size() == 1 || expected[1].t - expected[0].t > 1e-3)
+			{
+				ED_CHECK(bvh.instance_key(hit.instance) == expected[0].key);
+				ED_CHECK(hit.triangle == expected[0].triangle);
+			}
+
+			std::vector<std::pair<std::string, int>> got_ids, expected_ids;
+			for (size_t k = 0; k < hits.size(); k++)
+			{
+				ED_CHECK_NEAR(hits[k].t, expected[k].t, tolerance(expected[k].t));
+				if (k > 0) ED_CHECK(hits[k].t >= hits[k - 1].t);
+				got_ids.push_back(std::make_pair(bvh.instance_key(hits[k].instance), hits[k].triangle));
+				expected_ids.push_back(std::make_pair(expected[k].key, expected[k].triangle));
+			}
+			std::sort(got_ids.begin(), got_ids.end());
+			std::sort(expected_ids.begin(), expected_ids.end());
+			ED_CHECK(got_ids == expected_ids);
+			ED_CHECK_NEAR(hits[0].t, hit.t, 1e-5 * std::max(1.0f, hit.t));
+
+			// a cap on t keeps only the hits before it
+			float cap = static_cast<float>(expected[0].t + 1e-3);
+			bvh.intersect_all(origin, direction, hits, cap);
+			size_t before = 0;
+			for (auto & e : expected) before += e.t < cap - 1e-4 ? 1 : 0;
+			ED_CHECK(hits.size() >= before);
+			for (auto & h : hits) ED_CHECK(h.t <= cap);
+		}
+		ED_CHECK(tested > 250);
+		if (!scene.empty()) ED_CHECK(hit_rays > 0);
+	}
+
+	// one begin_update() .. end_update() round over the given objects, as the tool refreshes selected meshes
+	void update(EDSceneBvh & bvh, const std::vector<Object *> & objects, int expect_rebuilds)
+	{
+		bvh.begin_update();
+		int rebuilds = 0;
+		for (auto object : objects)
+		{
+			if (!bvh.update_instance(object->key, object->hash, object->matrix)) continue;
+			rebuilds++;
+			bvh.set_geometry(object->key, object->points.data(), object->points.size() / 3, object->triangles);
+		}
+		bvh.end_update();
+		ED_CHECK(rebuilds == expect_rebuilds);
+	}
+
+	std::vector<const Object *> scene_of(std::initializer_list<const Object *> objects)
+	{
+		return std::vector<const Object *>(objects);
+	}
+}
+
+int main()
+{
+	std::mt19937 random(41);
+	EDSceneBvh bvh;
+	EDSceneBvh::Hit hit;
+	float origin[] = { 0, 0, 10 }, down[] = { 0, 0, -1 };
+	ED_CHECK(bvh.empty() && !bvh.intersect(origin, down, hit));
+
+	auto a = sphere("|a|aShape", 12, random);
+	auto b = soup("|b|bShape", 60, random);
+	auto c = sphere("|c|cShape", 8, random);
+	update(bvh, { &a, &b, &c }, 3);
+	check_scene(bvh, scene_of({ &a, &b, &c }), random);
+
+	// nothing changed: no bottom level is rebuilt
+	update(bvh, { &a, &b, &c }, 0);
+	check_scene(bvh, scene_of({ &a, &b, &c }), random);
+
+	// a moved instance keeps its bottom level and is refitted
+	random_matrix(random, b.matrix);
+	update(bvh, { &a, &b, &c }, 0);
+	check_scene(bvh, scene_of({ &a, &b, &c }), random);
+
+	// a reshaped one is rebuilt
+	auto c2 = sphere(c.key, 16, random);
+	update(bvh, { &a, &b, &c2 }, 1);
+	check_scene(bvh, scene_of({ &a, &b, &c2 }), random);
+
+	// pinned instances, from points and from a prebuilt bottom level
+	auto p = soup("|p|pShape", 40, random);
+	auto q = sphere("|q|qShape", 10, random);
+	bvh.insert_instance(p.key, p.points.data(), p.points.size() / 3, p.triangles, p.matrix);
+	EDBvh blas;
+	EDSceneBvh::build_geometry(blas, q.points.data(), q.points.size() / 3, q.triangles);
+	bvh.insert_instance(q.key, std::move(blas), q.matrix);
+	check_scene(bvh, scene_of({ &a, &b, &c2, &p, &q }), random);
+
+	// an update without b drops it; pinned ones stay
+	update(bvh, { &a, &c2 }, 0);
+	ED_CHECK(!bvh.has_instance(b.key));
+	check_scene(bvh, scene_of({ &a, &c2, &p, &q }), random);
+
+	// pinned ones leave only when removed
+	bvh.remove_instance(p.key);
+	bvh.remove_instance("|nowhere");
+	check_scene(bvh, scene_of({ &a, &c2, &q }), random);
+
+	// replacing a pinned instance moves it
+	random_matrix(random, q.matrix);
+	bvh.insert_instance(q.key, q.points.data(), q.points.size() / 3, q.triangles, q.matrix);
+	check_scene(bvh, scene_of({ &a, &c2, &q }), random);
+
+	// many instances, then half of them gone, reusing their slots
+	std::vector<Object> many;
+	for (int i = 0; i < 30; i++) many.push_back(i % 3 ? sphere("|m" + std::to_string(i), 6, random) : soup("|m" + std::to_string(i), 20, random));
+	std::vector<Object *> all;
+	std::vector<const Object *> expected = scene_of({ &q });
+	for (auto & m : many)
+	{
+		all.push_back(&m);
+		expected.push_back(&m);
+	}
+	update(bvh, all, 30);
+	ED_CHECK(!bvh.has_instance(a.key));
+	check_scene(bvh, expected, random);
+
+	std::vector<Object *> half;
+	expected = scene_of({ &q });
+	for (size_t i = 0; i < many.size(); i += 2)
+	{
+		half.push_back(&many[i]);
+		expected.push_back(&many[i]);
+	}
+	update(bvh, half, 0);
+	check_scene(bvh, expected, random);
+	update(bvh, { &a, &b }, 2);
+	expected = scene_of({ &q, &a, &b });
+	check_scene(bvh, expected, random);
+
+	bvh.clear();
+	ED_CHECK(bvh.empty() && bvh.instance_count() == 0);
+	ED_CHECK(!bvh.intersect(origin, down, hit));
+
+	return EDTest::finish("test_scene_bvh");
+}
@@ -0,0 +1,305 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+
+// EDShellCache against a brute-force double-precision test of the patch
+// triangles pushed out by hand, and against the analytic distance to the
+// shell straight above a triangle. Also checks the level snapping and when
+// a patch and its shells are kept.
+//
+// Created: Oct 19, 2026
+
+#include "EDTest.h"
+#include "EDTestMesh.h"
+#include "EDShellCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace
+{
+	struct Shell
+	{
+		std::vector<double> x, y, z;
+		std::vector<int> triangles;
+	};
+
+	// the triangles touching the vertices within rings of the seeds, every vertex moved out by height
+	Shell offset_patch(const EDMeshSnapshot & mesh, const EDMeshAdjacency & adjacency, const std::vector<int> & seeds, int rings, double height)
+	{
+		Shell shell;
+		auto count = mesh.vertex_count();
+		shell.x.resize(count);
+		shell.y.resize(count);
+		shell.z.resize(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			shell.x[i] = mesh.x[i] + mesh.vertex_normals[i * 3] * height;
+			shell.y[i] = mesh.y[i] + mesh.vertex_normals[i * 3 + 1] * height;
+			shell.z[i] = mesh.z[i] + mesh.vertex_normals[i * 3 + 2] * height;
+		}
+
+		std::vector<int> vertices;
+		adjacency.expand_rings(seeds, rings, vertices);
+		std::set<int> faces;
+		for (auto v : vertices)
+		{
+			faces.insert(adjacency.faces_begin(v), adjacency.faces_end(v));
+		}
+		for (auto f : faces)
+		{
+			shell.triangles.insert(shell.triangles.end(), &mesh.triangles[f * 3], &mesh.triangles[f * 3] + 3);
+		}
+		return shell;
+	}
+
+	///
+	//  Nearest hit over every triangle, both facings, in doubles. margin gets
+	//  the smallest distance of any hit near the nearest one from a triangle
+	//  edge, in barycentric units, so rays grazing an edge can be skipped.
+	///
+	bool reference_hit(const Shell & shell, const float origin[3], const float direction[3], double & t, double & margin)
+	{
+		t = std::numeric_limits<double>::max();
+		margin = 1;
+		std::vector<double> ts, margins;
+		for (size_t i = 0; i < shell.triangles.size(); i += 3)
+		{
+			const int * tri = &shell.triangles[i];
+			double e1[3], e2[3], s[3], p[3], q[3];
+			double v0[] = { shell.x[tri[0]], shell.y[tri[0]], shell.z[tri[0]] };
+			double v1[] = { shell.x[tri[1]], shell.y[tri[1]], shell.z[tri[1]] };
+			double v2[] = { shell.x[tri[2]], shell.y[tri[2]], shell.z[tri[2]] };
+			for (int a = 0; a < 3; a++)
+			{
+				e1[a] = v1[a] - v0[a];
+				e2[a] = v2[a] - v0[a];
+				s[a] = origin[a] - v0[a];
+			}
+			auto cross = [](const double * a, const double * b, double * out)
+			{
+				out[0] = a[1] * b[2] - a[2] * b[1];
+				out[1] = a[2] * b[0] - a[0] * b[2];
+				out[2] = a[0] * b[1] - a[1] * b[0];
+			};
+			double d[] = { direction[0], direction[1], direction[2] };
+			cross(d, e2, p);
+			double det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+			if (std::fabs(det) < 1e-14) continue;
+			double u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) / det;
+			cross(s, e1, q);
+			double v = (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) / det;
+			double hit_t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) / det;
+			double edge = std::min(std::min(u, v), 1 - u - v);
+			if (edge < -1e-3 || hit_t < 0) continue;
+			ts.push_back(hit_t);
+			margins.push_back(edge);
+			if (edge >= 0) t = std::min(t, hit_t);
+		}
+		for (size_t k = 0; k < ts.size(); k++)
+		{
+			// an edge hit anywhere near the nearest one can go either way
+			if (ts[k] < t + 1e-3) margin = std::min(margin, std::fabs(margins[k]));
+		}
+		return t < std::numeric_limits<double>::max();
+	}
+
+	void check_rays(EDShellCache & cache, const EDMeshSnapshot & mesh, const EDMeshAdjacency & adjacency,
+		const std::vector<int> & seeds, int patch_rings, float height, std::mt19937 & random)
+	{
+		auto shell = offset_patch(mesh, adjacency, seeds, patch_rings, EDShellCache::level_height(EDShellCache::level_of(height)));
+		float centre[] = { mesh.x[seeds[0]], mesh.y[seeds[0]], mesh.z[seeds[0]] };
+
+		std::uniform_real_distribution<float> unit(-1, 1);
+		int tested = 0, hits = 0;
+		for (int r = 0; r < 400; r++)
+		{
+			// from outside, at a point near the seeds
+			float origin[3], direction[3], length = 0;
+			for (int a = 0; a < 3; a++)
+			{
+				origin[a] = centre[a] * 3 + unit(random);
+				direction[a] = centre[a] * (1 + height) + unit(random) * 0.4f - origin[a];
+				length += direction[a] * direction[a];
+			}
+			for (int a = 0; a < 3; a++) direction[a] /= std::sqrt(length);
+
+			double expected, margin;
+			bool expect_hit = reference_hit(shell, origin, direction, expected, margin);
+			if (margin < 1e-4) continue;
+			tested++;
+
+			float t = 0;
+			const EDShellCache & shared = cache;
+			bool hit = shared.intersect(height, origin, direction, t);
+			if (!ED_CHECK(hit == expect_hit)) continue;
+			if (!hit) continue;
+			hits++;
+			ED_CHECK_NEAR(t, expected, 1e-4 * std::max(1.0, expected));
+		}
+		ED_CHECK(tested > 300);
+		ED_CHECK(hits > tested / 4);
+	}
+}
+
+int main()
+{
+	// levels 2% apart: every height snaps to within 1% of itself
+	for (int k = 0; k <= 400; k++)
+	{
+		float h = static_cast<float>(1e-3 * std::pow(1e4, k / 400.0));
+		auto level = EDShellCache::level_of(h);
+		ED_CHECK_NEAR(EDShellCache::level_height(level) / h, 1.0, 0.0101);
+		ED_CHECK(EDShellCache::level_of(EDShellCache::level_height(level)) == level);
+	}
+	ED_CHECK(EDShellCache::level_of(1.0f) == 0);
+
+	std::vector<float> points;
+	std::vector<int> triangles;
+	const int rings = 24, segments = 48;
+	EDTest::make_sphere(rings, segments, points, triangles);
+	EDMeshSnapshot mesh;
+	EDTest::load_snapshot(mesh, points, triangles);
+	EDMeshAdjacency adjacency;
+	adjacency.build(mesh);
+	auto at = [&](int i, int j) { return 1 + (i - 1) * segments + j % segments; };
+
+	EDShellCache cache;
+	std::vector<int> seeds;
+	seeds.push_back(at(6, 0));
+	seeds.push_back(at(6, 1));
+	float origin[] = { 0, 3, 0 }, down[] = { 0, -1, 0 }, t = 0;
+	ED_CHECK(cache.empty());
+	ED_CHECK(!cache.covers(mesh, seeds, 1));
+	ED_CHECK(!cache.intersect(0.1f, origin, down, t));
+
+	// a patch twice the rings asked for
+	cache.set_patch(mesh, adjacency, seeds, 2);
+	ED_CHECK(!cache.empty());
+	ED_CHECK(cache.covers(mesh, seeds, 2));
+	ED_CHECK(cache.covers(mesh, seeds, 4));
+	ED_CHECK(!cache.covers(mesh, seeds, 5));
+	ED_CHECK(!cache.covers(mesh, std::vector<int>(1, at(18, 24)), 1));
+
+	// one shell per distinct level; heights <= 0 are skipped
+	std::vector<float> heights;
+	heights.push_back(0.05f);
+	heights.push_back(0.0502f);
+	heights.push_back(0.2f);
+	heights.push_back(0);
+	heights.push_back(-1);
+	std::set<int> levels;
+	for (auto h : heights)
+	{
+		if (h > 0) levels.insert(EDShellCache::level_of(h));
+	}
+	cache.prepare(heights);
+	ED_CHECK(cache.shell_count() == levels.size());
+	ED_CHECK(!cache.intersect(0.0f, origin, down, t));
+	ED_CHECK(!cache.intersect(-0.5f, origin, down, t));
+
+	std::mt19937 random(17);
+	check_rays(cache, mesh, adjacency, seeds, 4, 0.05f, random);
+	check_rays(cache, mesh, adjacency, seeds, 4, 0.2f, random);
+
+	// straight down onto the shell above each triangle at the seeds
+	{
+		const float h = 0.2f;
+		double level_h = EDShellCache::level_height(EDShellCache::level_of(h));
+		for (auto f = adjacency.faces_begin(seeds[0]); f != adjacency.faces_end(seeds[0]); ++f)
+		{
+			double c[3] = { 0, 0, 0 };
+			for (int k = 0; k < 3; k++)
+			{
+				auto v = mesh.triangles[*f * 3 + k];
+				c[0] += (mesh.x[v] + mesh.vertex_normals[v * 3] * level_h) / 3;
+				c[1] += (mesh.y[v] + mesh.vertex_normals[v * 3 + 1] * level_h) / 3;
+				c[2] += (mesh.z[v] + mesh.vertex_normals[v * 3 + 2] * level_h) / 3;
+			}
+			const float * n = &mesh.face_normals[*f * 3];
+			float from[3], direction[3];
+			for (int a = 0; a < 3; a++)
+			{
+				from[a] = static_cast<float>(c[a] + n[a] * 0.5);
+				direction[a] = -n[a];
+			}
+			ED_CHECK(cache.intersect(h, from, direction, t));
+			ED_CHECK_NEAR(t, 0.5, 1e-4);
+		}
+	}
+
+	// the non-const overload builds a missing level on demand
+	auto before = cache.shell_count();
+	cache.intersect(0.1f, origin, down, t);
+	ED_CHECK(cache.shell_count() == before + 1);
+	check_rays(cache, mesh, adjacency, seeds, 4, 0.1f, random);
+
+	// a stroke whose rings fit in the patch keeps it and its shells
+	cache.set_patch(mesh, adjacency, std::vector<int>(1, at(7, 0)), 2);
+	ED_CHECK(cache.shell_count() == before + 1);
+	ED_CHECK(cache.covers(mesh, seeds, 2));
+
+	// one that does not starts over
+	std::vector<int> far_seeds(1, at(12, 20));
+	cache.set_patch(mesh, adjacency, far_seeds, 1);
+	ED_CHECK(cache.shell_count() == 0);
+	ED_CHECK(cache.covers(mesh, far_seeds, 2));
+	ED_CHECK(!cache.covers(mesh, seeds, 1));
+	cache.prepare(std::vector<float>(1, 0.3f));
+	check_rays(cache, mesh, adjacency, far_seeds, 2, 0.3f, random);
+
+	// levels past kMaxShells start the cache over; one batch is always built whole
+	std::vector<float> many;
+	for (int k = 0; k < EDShellCache::kMaxShells; k++)
+	{
+		many.push_back(EDShellCache::level_height(k - 100));
+	}
+	cache.prepare(many);
+	ED_CHECK(cache.shell_count() == static_cast<size_t>(EDShellCache::kMaxShells));
+	cache.prepare(many);
+	ED_CHECK(cache.shell_count() == static_cast<size_t>(EDShellCache::kMaxShells));
+	cache.prepare(std::vector<float>(1, EDShellCache::level_height(50)));
+	ED_CHECK(cache.shell_count() == 1);
+
+	// starting over keeps every level the batch asks for, cached ones too
+	many.assign(1, EDShellCache::level_height(50));
+	for (int k = 1; k < EDShellCache::kMaxShells; k++)
+	{
+		many.push_back(EDShellCache::level_height(k - 100));
+	}
+	cache.prepare(many);
+	ED_CHECK(cache.shell_count() == static_cast<size_t>(EDShellCache::kMaxShells));
+	many.push_back(EDShellCache::level_height(60));
+	cache.prepare(many);
+	ED_CHECK(cache.shell_count() == many.size());
+
+	// a changed mesh invalidates the patch
+	const double moved[4][4] = { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 }, { 0.5, 0, 0, 1 } };
+	EDTest::load_snapshot(mesh, points, triangles, moved);
+	ED_CHECK(!cache.covers(mesh, far_seeds, 1));
+
+	return EDTest::finish("test_shell_cache");
+}
@@ -0,0 +1,96 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+// EDSlotMap against a map from handle to value: lookups, removal by swap,
+// stale handles after slot reuse, and handle_at over the packed values.
+//
+// Created: Oct 19, 2026
+
+#include "EDTest.h"
+#include "EDSlotMap.h"
+
+#include <iterator>
+#include <map>
+#include <random>
+#include <vector>
+
+int main()
+{
+	std::mt19937 rng(13);
+	std::uniform_int_distribution<int> action(0, 2);
+
+	EDSlotMap<int> map;
+	std::map<uint64_t, int> model;
+	std::vector<EDHandle> removed;
+	for (int step = 0; step < 20000; step++)
+	{
+		if (model.empty() || action(rng) != 0)
+		{
+			auto h = map.insert(step);
+			ED_CHECK(h.valid());
+			ED_CHECK(model.count(h.pack()) == 0);
+			model[h.pack()] = step;
+		}
+		else
+		{
+			auto it = model.begin();
+			std::advance(it, rng() % model.size());
+			auto h = EDHandle::unpack(it->first);
+			ED_CHECK(map.remove(h));
+			ED_CHECK(!map.remove(h));
+			model.erase(it);
+			removed.push_back(h);
+		}
+
+		if (step % 50 != 0) continue;
+
+		ED_CHECK(map.size() == model.size());
+		for (auto & entry : model)
+		{
+			auto value = map.get(EDHandle::unpack(entry.first));
+			ED_CHECK(value && *value == entry.second);
+		}
+		// removed handles stay dead even when their slot holds something new
+		for (auto h : removed)
+		{
+			ED_CHECK(!map.contains(h) && !map.get(h));
+		}
+		// iteration visits every value once, and handle_at names each one
+		size_t i = 0;
+		for (auto it = map.begin(); it != map.end(); ++it, ++i)
+		{
+			auto h = map.handle_at(i);
+			auto found = model.find(h.pack());
+			ED_CHECK(found != model.end() && found->second == *it);
+		}
+		ED_CHECK(i == model.size());
+	}
+	std::printf("%zu values, %zu removed handles\n", map.size(), removed.size());
+
+	auto kept = map.handle_at(0);
+	map.clear();
+	ED_CHECK(map.empty() && !map.contains(kept));
+	auto fresh = map.insert(1);
+	ED_CHECK(fresh != kept && map.contains(fresh) && !map.contains(EDHandle()));
+
+	return EDTest::finish("test_slot_map");
+}
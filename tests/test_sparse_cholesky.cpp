@@ -0,0 +1,199 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+
+// EDSparseCholesky against dense Gaussian elimination, on a grid Laplacian
+// and on random sparse matrices with several components, with entries given
+// in either triangle and repeated. Also checks that indefinite matrices and
+// factors past the size limit are refused.
+//
+// Created: Oct 19, 2026
+
+#include "EDTest.h"
+#include "EDSparseCholesky.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+	typedef std::vector<EDSparseCholesky::Entry> Entries;
+
+	void add(Entries & entries, int row, int col, double value)
+	{
+		EDSparseCholesky::Entry e = { row, col, value };
+		entries.push_back(e);
+	}
+
+	// the full symmetric matrix of the entries, whichever triangle they are in
+	std::vector<double> dense(size_t n, const Entries & entries)
+	{
+		std::vector<double> a(n * n, 0.0);
+		for (auto & e : entries)
+		{
+			a[e.row * n + e.col] += e.value;
+			if (e.row != e.col) a[e.col * n + e.row] += e.value;
+		}
+		return a;
+	}
+
+	// Gaussian elimination with partial pivoting
+	std::vector<double> dense_solve(size_t n, std::vector<double> a, std::vector<double> b)
+	{
+		for (size_t c = 0; c < n; c++)
+		{
+			size_t pivot = c;
+			for (size_t r = c + 1; r < n; r++)
+			{
+				if (std::fabs(a[r * n + c]) > std::fabs(a[pivot * n + c])) pivot = r;
+			}
+			for (size_t k = 0; k < n; k++) std::swap(a[c * n + k], a[pivot * n + k]);
+			std::swap(b[c], b[pivot]);
+			for (size_t r = c + 1; r < n; r++)
+			{
+				double f = a[r * n + c] / a[c * n + c];
+				if (f == 0) continue;
+				for (size_t k = c; k < n; k++) a[r * n + k] -= f * a[c * n + k];
+				b[r] -= f * b[c];
+			}
+		}
+		for (size_t c = n; c-- > 0;)
+		{
+			for (size_t k = c + 1; k < n; k++) b[c] -= a[c * n + k] * b[k];
+			b[c] /= a[c * n + c];
+		}
+		return b;
+	}
+
+	void check_solve(size_t n, const Entries & entries, std::mt19937 & random)
+	{
+		EDSparseCholesky cholesky;
+		if (!ED_CHECK(cholesky.factor(n, entries, 1 << 20))) return;
+		ED_CHECK(cholesky.size() == n);
+		ED_CHECK(cholesky.factor_size() >= n);
+
+		auto a = dense(n, entries);
+		std::uniform_real_distribution<double> unit(-1, 1);
+		for (int rhs = 0; rhs < 3; rhs++)
+		{
+			std::vector<double> b(n);
+			for (auto & v : b) v = unit(random);
+			auto expected = dense_solve(n, a, b);
+			double scale = 0;
+			for (auto v : expected) scale = std::max(scale, std::fabs(v));
+
+			auto x = b;
+			cholesky.solve(x);
+			double worst = 0;
+			for (size_t i = 0; i < n; i++) worst = std::max(worst, std::fabs(x[i] - expected[i]));
+			ED_CHECK_NEAR(worst / scale, 0.0, 1e-9);
+		}
+	}
+}
+
+int main()
+{
+	std::mt19937 random(11);
+
+	// 5-point Laplacian of a grid plus a small shift, lower triangle only
+	{
+		const int w = 23, h = 17;
+		Entries entries;
+		for (int y = 0; y < h; y++)
+		{
+			for (int x = 0; x < w; x++)
+			{
+				int i = y * w + x;
+				add(entries, i, i, 4.01);
+				if (x > 0) add(entries, i, i - 1, -1);
+				if (y > 0) add(entries, i, i - w, -1);
+			}
+		}
+		check_solve(w * h, entries, random);
+	}
+
+	// random graph Laplacians on three separate blocks, plus the identity;
+	// entries in both triangles, some repeated
+	for (int round = 0; round < 5; round++)
+	{
+		const int block = 60 + round * 10, n = block * 3;
+		std::uniform_int_distribution<int> pick(0, block - 1);
+		std::uniform_real_distribution<double> weight(0.1, 2.0);
+		Entries entries;
+		for (int i = 0; i < n; i++) add(entries, i, i, 1);
+		for (int b = 0; b < 3; b++)
+		{
+			for (int e = 0; e < block * 3; e++)
+			{
+				int i = b * block + pick(random), j = b * block + pick(random);
+				if (i == j) continue;
+				double w = weight(random);
+				add(entries, i, i, w);
+				add(entries, j, j, w);
+				if (e % 2) add(entries, i, j, -w);
+				else add(entries, j, i, -w);
+			}
+		}
+		check_solve(n, entries, random);
+	}
+
+	// a single entry
+	{
+		Entries entries;
+		add(entries, 0, 0, 4);
+		EDSparseCholesky cholesky;
+		ED_CHECK(cholesky.factor(1, entries, 16));
+		std::vector<double> b(1, 2.0);
+		cholesky.solve(b);
+		ED_CHECK_NEAR(b[0], 0.5, 1e-15);
+		cholesky.clear();
+		ED_CHECK(cholesky.empty());
+	}
+
+	// indefinite: [[1, 2], [2, 1]]
+	{
+		Entries entries;
+		add(entries, 0, 0, 1);
+		add(entries, 1, 1, 1);
+		add(entries, 1, 0, 2);
+		EDSparseCholesky cholesky;
+		ED_CHECK(!cholesky.factor(2, entries, 16));
+	}
+
+	// a dense block's factor does not fit in fewer entries than its triangle
+	{
+		const int n = 30;
+		Entries entries;
+		for (int i = 0; i < n; i++)
+		{
+			add(entries, i, i, n);
+			for (int j = 0; j < i; j++) add(entries, i, j, 0.5);
+		}
+		EDSparseCholesky cholesky;
+		ED_CHECK(!cholesky.factor(n, entries, n * (n + 1) / 2 - 1));
+		ED_CHECK(cholesky.factor(n, entries, n * (n + 1) / 2));
+	}
+
+	return EDTest::finish("test_sparse_cholesky");
+}
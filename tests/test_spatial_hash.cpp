@@ -0,0 +1,118 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+// EDSpatialHash::find_nearest against a linear scan of the live points,
+// through random inserts and removals around the origin, where cell
+// indices change sign.
+//
+// Created: Oct 19, 2026
+
+#include "EDTest.h"
+#include "EDSpatialHash.h"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+	struct Point
+	{
+		double x, y, z;
+		bool alive;
+	};
+
+	double distance_sq(const Point & p, double x, double y, double z)
+	{
+		return (p.x - x) * (p.x - x) + (p.y - y) * (p.y - y) + (p.z - z) * (p.z - z);
+	}
+}
+
+int main()
+{
+	std::mt19937 rng(3);
+	std::uniform_real_distribution<double> where(-2, 2), unit(0, 1);
+	const double kCell = 0.25;
+
+	EDSpatialHash hash(kCell);
+	std::vector<Point> points;
+	int queries = 0, found = 0;
+	for (int step = 0; step < 4000; step++)
+	{
+		if (points.empty() || unit(rng) < 0.6)
+		{
+			Point p = { where(rng), where(rng), where(rng), true };
+			hash.insert(points.size(), p.x, p.y, p.z);
+			points.push_back(p);
+		}
+		else
+		{
+			auto & p = points[static_cast<size_t>(unit(rng) * points.size()) % points.size()];
+			if (p.alive) hash.remove(&p - &points[0], p.x, p.y, p.z);
+			p.alive = false;
+		}
+
+		// a query near a stored point, and one anywhere
+		for (int k = 0; k < 2; k++)
+		{
+			double x = where(rng), y = where(rng), z = where(rng);
+			if (k == 0)
+			{
+				auto & p = points[static_cast<size_t>(unit(rng) * points.size()) % points.size()];
+				x = p.x + 0.1 * (unit(rng) - 0.5);
+				y = p.y + 0.1 * (unit(rng) - 0.5);
+				z = p.z + 0.1 * (unit(rng) - 0.5);
+			}
+			double radius = kCell * unit(rng);
+
+			double best = radius * radius;
+			bool any = false;
+			for (auto & p : points)
+			{
+				if (!p.alive) continue;
+				auto d = distance_sq(p, x, y, z);
+				if (d <= best)
+				{
+					best = d;
+					any = true;
+				}
+			}
+
+			size_t id = 0;
+			bool ok = hash.find_nearest(x, y, z, radius, id);
+			queries++;
+			found += ok;
+			if (!ED_CHECK(ok == any) || !ok) continue;
+			// ties between equally near points may go either way
+			ED_CHECK(id < points.size() && points[id].alive);
+			ED_CHECK_NEAR(distance_sq(points[id], x, y, z), best, 1e-15);
+		}
+	}
+	std::printf("%d queries, %d found a point\n", queries, found);
+	ED_CHECK(found > queries / 10 && found < queries);
+
+	// a new cell size drops every point
+	hash.reset(1.0);
+	size_t id = 0;
+	ED_CHECK(!hash.find_nearest(points[0].x, points[0].y, points[0].z, 1.0, id));
+
+	return EDTest::finish("test_spatial_hash");
+}
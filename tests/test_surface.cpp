@@ -0,0 +1,182 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+
+// EDSurfaceSet over two unit spheres apart: routing points to the surface
+// with the nearest vertex against a scan of both, heights measured and
+// kept per surface, and revisions and drops as the selection changes.
+//
+// Created: Oct 19, 2026
+
+#include "EDTest.h"
+#include "EDTestMesh.h"
+#include "EDSurface.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+	struct Sphere
+	{
+		std::vector<float> points;
+		std::vector<int> triangles;
+		double matrix[4][4];
+	};
+
+	Sphere sphere_at(double x)
+	{
+		Sphere s;
+		EDTest::make_sphere(8, 16, s.points, s.triangles);
+		const double matrix[4][4] = { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 }, { x, 0, 0, 1 } };
+		for (int r = 0; r < 4; r++)
+			for (int c = 0; c < 4; c++)
+				s.matrix[r][c] = matrix[r][c];
+		return s;
+	}
+
+	void load(EDSurface & surface, const Sphere & s)
+	{
+		auto topology = EDMeshSnapshot::hash_words(reinterpret_cast<const uint32_t *>(s.triangles.data()), s.triangles.size());
+		if (!surface.update(s.points.data(), s.points.size() / 3, s.matrix, topology)) return;
+		if (surface.topology_changed()) surface.set_triangles(std::vector<int>(s.triangles));
+		surface.refresh();
+	}
+
+	void select(EDSurfaceSet & set, const std::vector<const char *> & keys, const std::vector<const Sphere *> & spheres)
+	{
+		set.begin_update();
+		for (size_t i = 0; i < keys.size(); i++) load(set.touch(keys[i]), *spheres[i]);
+		set.end_update();
+	}
+
+	// surface and vertex nearest p over every vertex of every surface
+	void scan(EDSurfaceSet & set, const float p[3], int & surface, int & vertex, double & distance)
+	{
+		surface = vertex = -1;
+		distance = std::numeric_limits<double>::max();
+		for (size_t s = 0; s < set.size(); s++)
+		{
+			auto & mesh = set[s].mesh();
+			for (size_t v = 0; v < mesh.vertex_count(); v++)
+			{
+				double dx = mesh.x[v] - p[0], dy = mesh.y[v] - p[1], dz = mesh.z[v] - p[2];
+				auto d = dx * dx + dy * dy + dz * dz;
+				if (d >= distance) continue;
+				distance = d;
+				surface = static_cast<int>(s);
+				vertex = static_cast<int>(v);
+			}
+		}
+	}
+}
+
+int main()
+{
+	std::mt19937 random(43);
+	EDSurfaceSet set;
+	ED_CHECK(set.empty() && set.revision() == 0 && set.diagonal() == 0);
+	float origin[] = { 0, 0, 0 };
+	ED_CHECK(set.nearest(origin) == -1);
+
+	auto a = sphere_at(0), b = sphere_at(5);
+	select(set, { "|a|aShape", "|b|bShape" }, { &a, &b });
+	ED_CHECK(set.size() == 2 && set.revision() == 1);
+	ED_CHECK(set.find("|b|bShape") == 1 && set.find("|c") == -1);
+	// x spans [-1, 6], y and z [-1, 1]
+	ED_CHECK_NEAR(set.diagonal(), std::sqrt(49.0 + 4 + 4), 1e-5);
+
+	// routed to the surface with the nearest vertex
+	std::uniform_real_distribution<float> coordinate(-2, 7);
+	for (int k = 0; k < 500; k++)
+	{
+		float p[] = { coordinate(random), coordinate(random) * 0.5f, coordinate(random) * 0.5f };
+		int vertex, surface = set.nearest(p, &vertex);
+		int expected_surface, expected_vertex;
+		double distance;
+		scan(set, p, expected_surface, expected_vertex, distance);
+		ED_CHECK(surface == expected_surface);
+		auto & mesh = set[surface].mesh();
+		double dx = mesh.x[vertex] - p[0], dy = mesh.y[vertex] - p[1], dz = mesh.z[vertex] - p[2];
+		ED_CHECK_NEAR(dx * dx + dy * dy + dz * dz, distance, 1e-5);
+	}
+
+	// above the equator vertex facing +x of b: its normal is +x
+	float above[] = { 6.5f, 0, 0 }, foot[3], height;
+	ED_CHECK(set[1].height_above(above, height, foot));
+	ED_CHECK_NEAR(height, 0.5, 1e-5);
+	ED_CHECK_NEAR(foot[0], 6, 1e-5);
+	// inside it clamps to 0
+	float inside[] = { 5.5f, 0, 0 };
+	ED_CHECK(set[1].height_above(inside, height, foot) && height == 0);
+
+	// each site lands in the field of its nearest surface only
+	set.clear_heights();
+	for (int k = 0; k < 20; k++)
+	{
+		auto angle = static_cast<float>(k) * 0.3f;
+		float pa[] = { std::cos(angle), std::sin(angle), 0 };
+		float pb[] = { 5 + std::cos(angle), 0, std::sin(angle) };
+		set.add_height_site(pa, 0.25f);
+		set.add_height_site(pb, 0.75f);
+	}
+	// measured, not known: 0.5 above a
+	float measured[] = { -1.5f, 0, 0 };
+	set.add_height_site(measured, -1);
+	set.build_heights();
+	ED_CHECK(set[0].heights().size() == 21 && set[1].heights().size() == 20);
+	float on_b[] = { 5, 1, 0 };
+	ED_CHECK(set[1].heights().evaluate(on_b, height));
+	ED_CHECK_NEAR(height, 0.75, 1e-5);
+	float on_a[] = { -1, 0, 0 };
+	ED_CHECK(set[0].heights().evaluate(on_a, height));
+	ED_CHECK_NEAR(height, 0.5, 1e-5);
+
+	// the same selection again changes nothing
+	select(set, { "|a|aShape", "|b|bShape" }, { &a, &b });
+	ED_CHECK(set.revision() == 1);
+
+	// a moved mesh does
+	auto b2 = sphere_at(4);
+	select(set, { "|a|aShape", "|b|bShape" }, { &a, &b2 });
+	ED_CHECK(set.revision() == 2);
+	ED_CHECK_NEAR(set.diagonal(), std::sqrt(36.0 + 4 + 4), 1e-5);
+	float near_b2[] = { 3.2f, 0, 0 };
+	ED_CHECK(set.nearest(near_b2) == 1);
+
+	// a deselected one is dropped; the other keeps its surface
+	auto & kept = set[0];
+	select(set, { "|a|aShape" }, { &a });
+	ED_CHECK(set.size() == 1 && set.revision() == 3 && &set[0] == &kept);
+	ED_CHECK(set.nearest(near_b2) == 0);
+
+	// a new one is added at the end
+	select(set, { "|a|aShape", "|c|cShape" }, { &a, &b });
+	ED_CHECK(set.size() == 2 && set.revision() == 4 && set.find("|c|cShape") == 1);
+
+	set.clear();
+	ED_CHECK(set.empty() && set.revision() == 5);
+
+	return EDTest::finish("test_surface");
+}
@@ -0,0 +1,189 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+
+// EDTangentEstimator against scans of every vertex: the nearest one, the
+// mean normal within a radius, and the facing-weighted stroke normal, on a
+// moved sphere; and on the sphere's own normals, the tangent planes a
+// stroke across it should give.
+//
+// Created: Oct 19, 2026
+
+#include "EDTest.h"
+#include "EDTestMesh.h"
+#include "EDTangentEstimator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+	double distance_sq(const EDMeshSnapshot & mesh, size_t i, const float p[3])
+	{
+		double dx = mesh.x[i] - p[0], dy = mesh.y[i] - p[1], dz = mesh.z[i] - p[2];
+		return dx * dx + dy * dy + dz * dz;
+	}
+
+	bool normalize(double sum[3], float out[3])
+	{
+		double length = std::sqrt(sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2]);
+		if (!(length > 0)) return false;
+		for (int a = 0; a < 3; a++) out[a] = static_cast<float>(sum[a] / length);
+		return true;
+	}
+
+	bool reference_average(const EDMeshSnapshot & mesh, const float p[3], float radius, float normal[3])
+	{
+		double sum[] = { 0, 0, 0 };
+		bool any = false;
+		for (size_t i = 0; i < mesh.vertex_count(); i++)
+		{
+			if (distance_sq(mesh, i, p) >= double(radius) * radius) continue;
+			any = true;
+			for (int a = 0; a < 3; a++) sum[a] += mesh.vertex_normals[i * 3 + a];
+		}
+		return any && normalize(sum, normal);
+	}
+
+	size_t reference_nearest(const EDMeshSnapshot & mesh, const float p[3])
+	{
+		size_t best = 0;
+		for (size_t i = 1; i < mesh.vertex_count(); i++)
+		{
+			if (distance_sq(mesh, i, p) < distance_sq(mesh, best, p)) best = i;
+		}
+		return best;
+	}
+
+	bool reference_stroke(const EDMeshSnapshot & mesh, const std::vector<float> * hits, size_t count, float radius, float normal[3])
+	{
+		double sum[] = { 0, 0, 0 };
+		for (size_t k = 0; k < count; k++)
+		{
+			float p[] = { hits[0][k], hits[1][k], hits[2][k] };
+			std::vector<size_t> found;
+			for (size_t i = 0; i < mesh.vertex_count(); i++)
+			{
+				if (distance_sq(mesh, i, p) < double(radius) * radius) found.push_back(i);
+			}
+			if (found.empty()) found.push_back(reference_nearest(mesh, p));
+			for (auto i : found)
+			{
+				const float * n = &mesh.vertex_normals[i * 3];
+				double facing = -(n[0] * hits[3][k] + n[1] * hits[4][k] + n[2] * hits[5][k]);
+				if (facing <= 0) continue;
+				for (int a = 0; a < 3; a++) sum[a] += n[a] * facing;
+			}
+		}
+		return normalize(sum, normal);
+	}
+
+	void check_normal(const float * got, const float * expected)
+	{
+		double worst = 0;
+		for (int a = 0; a < 3; a++) worst = std::max(worst, std::fabs(double(got[a]) - expected[a]));
+		ED_CHECK_NEAR(worst, 0.0, 1e-5);
+	}
+}
+
+int main()
+{
+	std::vector<float> points;
+	std::vector<int> triangles;
+	EDTest::make_sphere(24, 48, points, triangles);
+	const double moved[4][4] = { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 }, { 0.25, -1, 2, 1 } };
+	EDMeshSnapshot mesh;
+	EDTest::load_snapshot(mesh, points, triangles, moved);
+
+	EDTangentEstimator estimator;
+	float p[] = { 0, 0, 0 }, normal[3];
+	ED_CHECK(estimator.empty());
+	ED_CHECK(estimator.nearest_vertex(p) == -1);
+	ED_CHECK(!estimator.nearest_normal(p, normal));
+
+	estimator.build(mesh);
+	ED_CHECK(!estimator.empty());
+	ED_CHECK(estimator.mesh_revision() == mesh.revision());
+
+	std::mt19937 random(23);
+	std::uniform_real_distribution<float> unit(-1.5f, 1.5f);
+	for (int q = 0; q < 300; q++)
+	{
+		float at[] = { unit(random) + 0.25f, unit(random) - 1, unit(random) + 2 };
+		auto v = estimator.nearest_vertex(at);
+		if (!ED_CHECK(v >= 0)) continue;
+		auto expected = reference_nearest(mesh, at);
+		ED_CHECK_NEAR(distance_sq(mesh, v, at), distance_sq(mesh, expected, at), 1e-6);
+
+		ED_CHECK(estimator.nearest_normal(at, normal));
+		check_normal(normal, &mesh.vertex_normals[v * 3]);
+
+		float radius = 0.05f + 0.3f * (q % 5);
+		float expected_normal[3];
+		bool expect = reference_average(mesh, at, radius, expected_normal);
+		ED_CHECK(estimator.average_normal(at, radius, normal) == expect);
+		if (expect) check_normal(normal, expected_normal);
+	}
+
+	// strokes of hits on the sphere seen along -z, some with radii too small to reach a vertex
+	for (int s = 0; s < 20; s++)
+	{
+		std::vector<float> hits[6];
+		float y0 = unit(random) * 0.5f;
+		for (int k = 0; k < 30; k++)
+		{
+			double x = -0.8 + 1.6 * k / 29, y = y0 + 0.2 * std::sin(k * 0.3 + s);
+			double z = std::sqrt(std::max(0.0, 1 - x * x - y * y));
+			float values[] = { static_cast<float>(x + 0.25), static_cast<float>(y - 1), static_cast<float>(z + 2), 0, 0, -1 };
+			for (int a = 0; a < 6; a++) hits[a].push_back(values[a]);
+		}
+		float radius = s % 2 ? 0.15f : 1e-3f, expected_normal[3];
+		bool expect = reference_stroke(mesh, hits, 30, radius, expected_normal);
+		ED_CHECK(estimator.stroke_normal(hits[0].data(), hits[1].data(), hits[2].data(), hits[3].data(), hits[4].data(), hits[5].data(),
+			30, radius, normal) == expect);
+		if (expect) check_normal(normal, expected_normal);
+		// the facing-weighted mean of a band across the front faces the camera
+		if (expect) ED_CHECK(normal[2] > 0.5f);
+	}
+
+	// a ray that sees only back faces finds none
+	{
+		float x[] = { 0.25f }, y[] = { -1 }, z[] = { 3 }, dx[] = { 0 }, dy[] = { 0 }, dz[] = { 1 };
+		ED_CHECK(!estimator.stroke_normal(x, y, z, dx, dy, dz, 1, 0.1f, normal));
+	}
+
+	// a new snapshot needs a rebuild, which follows it
+	EDTest::load_snapshot(mesh, points, triangles);
+	ED_CHECK(estimator.mesh_revision() != mesh.revision());
+	estimator.build(mesh);
+	float origin_top[] = { 0, 2, 0 };
+	ED_CHECK(estimator.nearest_vertex(origin_top) == 0);
+
+	estimator.clear();
+	ED_CHECK(estimator.empty() && estimator.mesh_revision() == 0);
+	ED_CHECK(!estimator.average_normal(origin_top, 1, normal));
+
+	return EDTest::finish("test_tangent_estimator");
+}
@@ -0,0 +1,491 @@
+// =============================================================================
+//
+// EasyDress: a 3D sketching plugin for Maya
+// Copyright (C) 2016  Ruoyu Fan (Windy Darian), Yimeng Xu
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// =============================================================================
+
+
+
+// Command-line driver for the Maya-free modules the plugin shares: sends
+// screen strokes through the sketch engine the plugin uses and fits curves
+// to them, timing every stage and checking what comes out, so the hot paths
+// can be run and profiled without Maya.
+//
+//     easydress_driver [mesh.obj] [strokes] [samples per stroke] [raster]
+//
+// Strokes cycle through shell, tangent, normal and contour strokes around
+// the middle of the mesh. Without a mesh it sketches on a unit sphere and
+// also checks each stroke is classified as drawn and lands where it should
+// on the sphere. "raster" hit-tests against a raster of the mesh instead of
+// casting rays. Exits with 1 if any check fails.
+//
+// Created: Oct 19, 2026
+
+#include "EDCurveFit.h"
+#include "EDKernels.h"
+#include "EDMeshSnapshot.h"
+#include "EDSketchEngine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	typedef std::chrono::steady_clock Clock;
+
+	double milliseconds_since(Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	// positions and fan-triangulated faces of an OBJ; texture and normal indices are skipped
+	bool load_obj(const char * path, std::vector<float> & points, std::vector<int> & triangles)
+	{
+		std::ifstream in(path);
+		if (!in) return false;
+
+		std::string line;
+		while (std::getline(in, line))
+		{
+			std::istringstream words(line);
+			std::string tag;
+			words >> tag;
+			if (tag == "v")
+			{
+				float p[3] = { 0, 0, 0 };
+				words >> p[0] >> p[1] >> p[2];
+				points.insert(points.end(), p, p + 3);
+			}
+			else if (tag == "f")
+			{
+				std::vector<int> face;
+				std::string corner;
+				while (words >> corner)
+				{
+					int index = std::atoi(corner.c_str());
+					face.push_back(index < 0 ? static_cast<int>(points.size() / 3) + index : index - 1);
+				}
+				for (size_t k = 2; k < face.size(); k++)
+				{
+					int tri[] = { face[0], face[k - 1], face[k] };
+					triangles.insert(triangles.end(), tri, tri + 3);
+				}
+			}
+		}
+		return !points.empty() && !triangles.empty();
+	}
+
+	void make_sphere(int rings, int segments, std::vector<float> & points, std::vector<int> & triangles)
+	{
+		const double pi = 3.14159265358979323846;
+		auto add = [&](double x, double y, double z)
+		{
+			points.push_back(static_cast<float>(x));
+			points.push_back(static_cast<float>(y));
+			points.push_back(static_cast<float>(z));
+		};
+		add(0, 1, 0);
+		for (int i = 1; i < rings; i++)
+		{
+			for (int j = 0; j < segments; j++)
+			{
+				double theta = pi * i / rings, phi = 2 * pi * j / segments;
+				add(std::sin(theta) * std::cos(phi), std::cos(theta), -std::sin(theta) * std::sin(phi));
+			}
+		}
+		add(0, -1, 0);
+
+		int south = 1 + (rings - 1) * segments;
+		auto at = [&](int i, int j) { return 1 + (i - 1) * segments + j % segments; };
+		for (int j = 0; j < segments; j++)
+		{
+			int top[] = { 0, at(1, j), at(1, j + 1) };
+			int bottom[] = { south, at(rings - 1, j + 1), at(rings - 1, j) };
+			triangles.insert(triangles.end(), top, top + 3);
+			triangles.insert(triangles.end(), bottom, bottom + 3);
+		}
+		for (int i = 1; i < rings - 1; i++)
+		{
+			for (int j = 0; j < segments; j++)
+			{
+				int quad[] = { at(i, j), at(i + 1, j), at(i, j + 1), at(i, j + 1), at(i + 1, j), at(i + 1, j + 1) };
+				triangles.insert(triangles.end(), quad, quad + 6);
+			}
+		}
+	}
+
+	///
+	//  A perspective camera on +z looking at the centre of the bounds from far
+	//  enough to frame them; row vectors as in Maya. Returns the view-projection
+	//  and its inverse.
+	///
+	void frame_camera(const float lo[3], const float hi[3], int width, int height, double vp[4][4], double inverse[4][4])
+	{
+		double centre[3], radius = 0;
+		for (int a = 0; a < 3; a++)
+		{
+			centre[a] = 0.5 * (lo[a] + hi[a]);
+			radius = std::max(radius, 0.5 * (hi[a] - lo[a]));
+		}
+		const double f = 1 / std::tan(0.4), aspect = double(width) / height;
+		double distance = radius * 1.8 * f, near_z = 0.01 * distance, far_z = 10 * distance;
+
+		// view: translate the eye to the origin; projection as OpenGL, transposed
+		double ex = centre[0], ey = centre[1], ez = centre[2] + distance;
+		double depth_scale = (far_z + near_z) / (near_z - far_z), depth_offset = 2 * far_z * near_z / (near_z - far_z);
+		double p[4][4] = { { f / aspect, 0, 0, 0 }, { 0, f, 0, 0 }, { 0, 0, depth_scale, -1 }, { 0, 0, depth_offset, 0 } };
+		for (int r = 0; r < 4; r++)
+		{
+			for (int c = 0; c < 4; c++) vp[r][c] = p[r][c];
+		}
+		for (int c = 0; c < 4; c++) vp[3][c] = -ex * p[0][c] - ey * p[1][c] - ez * p[2][c] + p[3][c];
+
+		// the inverse of translate * projection, in closed form
+		double ip[4][4] = { { aspect / f, 0, 0, 0 }, { 0, 1 / f, 0, 0 }, { 0, 0, 0, 1 / depth_offset }, { 0, 0, -1, depth_scale / depth_offset } };
+		for (int r = 0; r < 4; r++)
+		{
+			double w = ip[r][3];
+			inverse[r][0] = ip[r][0] + w * ex;
+			inverse[r][1] = ip[r][1] + w * ey;
+			inverse[r][2] = ip[r][2] + w * ez;
+			inverse[r][3] = w;
+		}
+	}
+
+	typedef EDSketchEngine::Vec Vec;
+
+	const char * const kStrategyNames[] = { "unprojected", "contour", "normal", "tangent", "shell" };
+
+	// the strategy each stroke is drawn for, in the order they cycle through
+	const EDSketchEngine::Strategy kStrokeKinds[] = { EDSketchEngine::kShell, EDSketchEngine::kTangentPlane, EDSketchEngine::kNormalPlane, EDSketchEngine::kContour };
+
+	double length(const Vec & v)
+	{
+		return std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+	}
+
+	bool finite(const Vec & v)
+	{
+		return std::isfinite(v.x) && std::isfinite(v.y) && std::isfinite(v.z);
+	}
+
+	///
+	//  Stroke s around a mesh that covers a disc of radius r pixels at
+	//  (cx, cy): shell strokes wave across it and just off both sides, tangent
+	//  strokes stay inside it, normal strokes run outwards from inside it and
+	//  contour strokes arc around it without touching it.
+	///
+	void make_stroke(int s, int strokes, int samples, double cx, double cy, double r, EDSketchEngine::Stroke & stroke)
+	{
+		const double two_pi = 6.28318530718;
+		double row = strokes > 1 ? 2.0 * s / (strokes - 1) - 1 : 0;
+		double angle = 0.7 * s;
+		stroke = EDSketchEngine::Stroke();
+		stroke.px.resize(samples);
+		stroke.py.resize(samples);
+		for (int i = 0; i < samples; i++)
+		{
+			double u = double(i) / (samples - 1), x = 0, y = 0;
+			switch (kStrokeKinds[s % 4])
+			{
+			case EDSketchEngine::kShell:
+				x = cx + r * 1.1 * std::sqrt(1 - 0.36 * row * row) * (2 * u - 1);
+				y = cy + r * (0.6 * row + 0.05 * std::sin(two_pi * u * 2 + s));
+				break;
+			case EDSketchEngine::kTangentPlane:
+				x = cx + r * (u - 0.5);
+				y = cy + r * (0.4 * row + 0.03 * std::sin(two_pi * u * 2 + s));
+				break;
+			case EDSketchEngine::kNormalPlane:
+				x = cx + r * (0.3 + 0.55 * u) * std::cos(angle);
+				y = cy + r * (0.3 + 0.55 * u) * std::sin(angle);
+				break;
+			default:
+				x = cx + 1.4 * r * std::cos(angle + 1.2 * u);
+				y = cy + 1.4 * r * std::sin(angle + 1.2 * u);
+				break;
+			}
+			stroke.px[i] = static_cast<float>(x);
+			stroke.py[i] = static_cast<float>(y);
+		}
+		stroke.tangent_mode = kStrokeKinds[s % 4] == EDSketchEngine::kTangentPlane;
+	}
+
+	///
+	//  What every projection must satisfy: one finite point per sample, on
+	//  the plane when there is one, heights for every sample of a shell
+	//  stroke. On the unit sphere, also the strategy the stroke was drawn
+	//  for, hits between the sphere and the highest shell, and hits facing
+	//  the camera on the shell at their own height, as EDShellCache snaps it.
+	///
+	void check_projection(const EDSketchEngine::Stroke & stroke, const EDSketchEngine::Result & result, EDSketchEngine::Strategy kind,
+		const EDCamera & camera, double scale, bool on_sphere, std::vector<std::string> & errors)
+	{
+		auto & points = result.points;
+		auto & projection = result.projection;
+		if (points.size() != stroke.size())
+		{
+			errors.push_back("wrong point count");
+			return;
+		}
+		for (auto & p : points)
+		{
+			if (!finite(p))
+			{
+				errors.push_back("point not finite");
+				return;
+			}
+		}
+		if (on_sphere && result.strategy != kind)
+		{
+			errors.push_back(std::string("classified as ") + kStrategyNames[result.strategy]);
+		}
+
+		if (result.strategy == EDSketchEngine::kShell)
+		{
+			if (projection.has_plane || projection.heights.size() != points.size())
+			{
+				errors.push_back("shell without heights");
+				return;
+			}
+			float highest = 0;
+			auto shell_height = [](float h) { return h > 0 ? EDShellCache::level_height(EDShellCache::level_of(h)) : 0.0f; };
+			for (auto h : projection.heights)
+			{
+				if (!std::isfinite(h) || h < -1e-3 * scale)
+				{
+					errors.push_back("bad height");
+					return;
+				}
+				highest = std::max(highest, h);
+			}
+			for (size_t i = 1; on_sphere && i + 1 < points.size(); i++)
+			{
+				if (!result.hits[i]) continue;
+
+				auto radius = length(points[i]);
+				if (radius < 1 - 1e-3 || radius > 1 + shell_height(highest) + 1e-3)
+				{
+					errors.push_back("shell hit off the shells");
+					return;
+				}
+				Vec origin, direction;
+				camera.ray(stroke.px[i], stroke.py[i], origin, direction);
+				auto facing = -(direction.x * points[i].x + direction.y * points[i].y + direction.z * points[i].z) / radius;
+				auto expected = 1 + shell_height(projection.heights[i]);
+				if (facing > 0.5 && std::abs(radius - expected) > 1e-3 * expected)
+				{
+					errors.push_back("shell hit not at its height");
+					return;
+				}
+			}
+		}
+		else if (!projection.has_plane)
+		{
+			errors.push_back("plane strategy without a plane");
+		}
+		else
+		{
+			// minimum-skew normals are not unit length
+			auto n = projection.plane_normal / length(projection.plane_normal);
+			for (auto & p : points)
+			{
+				auto offset = p - projection.plane_point;
+				if (std::abs(offset.x * n.x + offset.y * n.y + offset.z * n.z) > 1e-4 * scale)
+				{
+					errors.push_back("point off the plane");
+					break;
+				}
+			}
+			// the normal plane holds the surface normal where the stroke starts
+			auto & p0 = points[0];
+			if (on_sphere && result.strategy == EDSketchEngine::kNormalPlane
+				&& std::abs(n.x * p0.x + n.y * p0.y + n.z * p0.z) > 0.05 * length(p0))
+			{
+				errors.push_back("normal plane misses the surface normal");
+			}
+		}
+	}
+}
+
+int main(int argc, char ** argv)
+{
+	std::vector<float> points;
+	std::vector<int> triangles;
+	bool on_sphere = argc <= 1 || std::string(argv[1]) == "-";
+	if (!on_sphere)
+	{
+		if (!load_obj(argv[1], points, triangles))
+		{
+			std::fprintf(stderr, "cannot read a mesh from %s\n", argv[1]);
+			return 1;
+		}
+	}
+	else
+	{
+		make_sphere(256, 512, points, triangles);
+	}
+	int strokes = argc > 2 ? std::max(1, std::atoi(argv[2])) : 200;
+	int samples = argc > 3 ? std::max(3, std::atoi(argv[3])) : 400;
+	bool raster = argc > 4 && std::string(argv[4]) == "raster";
+	const int width = 1920, height = 1080;
+	auto vertex_count = points.size() / 3;
+
+	std::printf("kernels: %s\n", EDKernels::select().name);
+	std::printf("mesh: %zu vertices, %zu triangles\n", vertex_count, triangles.size() / 3);
+
+	// the mesh goes in as the plugin puts a selected mesh in, keyed by its path
+	auto start = Clock::now();
+	EDSketchEngine engine;
+	const double identity[4][4] = { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 }, { 0, 0, 0, 1 } };
+	auto topology = EDMeshSnapshot::hash_words(reinterpret_cast<const uint32_t *>(triangles.data()), triangles.size());
+	auto & surfaces = engine.surfaces();
+	surfaces.begin_update();
+	auto & surface = surfaces.touch("mesh");
+	surface.update(points.data(), vertex_count, identity, topology);
+	surface.set_triangles(std::vector<int>(triangles));
+	surface.refresh();
+	surfaces.end_update();
+	// no anchors or curves: shell heights come from the stroke ends alone
+	surfaces.clear_heights();
+	surfaces.build_heights();
+	std::printf("surface: %.2f ms\n", milliseconds_since(start));
+
+	// the plugin factors on a worker thread while the user sketches; waiting
+	// here times it, and every shell stroke then measures along the surface
+	start = Clock::now();
+	bool geodesics = surface.wait_for_geodesics() != nullptr;
+	std::printf("geodesics: %.2f ms%s\n", milliseconds_since(start), geodesics ? "" : " (mesh too large, straight-line distances)");
+
+	start = Clock::now();
+	auto & scene = engine.scene();
+	scene.begin_update();
+	auto geometry_hash = EDMeshSnapshot::hash_words(reinterpret_cast<const uint32_t *>(points.data()), points.size()) ^ topology;
+	if (scene.update_instance("mesh", geometry_hash, identity))
+	{
+		scene.set_geometry("mesh", points.data(), vertex_count, triangles);
+	}
+	scene.end_update();
+	std::printf("scene bvh: %.2f ms\n", milliseconds_since(start));
+
+	float lo[3] = { points[0], points[1], points[2] }, hi[3] = { points[0], points[1], points[2] };
+	for (size_t i = 0; i < points.size(); i++)
+	{
+		lo[i % 3] = std::min(lo[i % 3], points[i]);
+		hi[i % 3] = std::max(hi[i % 3], points[i]);
+	}
+	EDCamera camera;
+	camera.width = width;
+	camera.height = height;
+	frame_camera(lo, hi, width, height, camera.view_projection, camera.inverse);
+	engine.set_camera(camera);
+
+	start = Clock::now();
+	engine.set_raster_hit_test(raster);
+	engine.update_raster();
+	if (raster) std::printf("raster: %.2f ms\n", milliseconds_since(start));
+
+	// the disc the mesh covers on screen, from its centre and half its largest extent
+	Vec centre(0.5 * (lo[0] + hi[0]), 0.5 * (lo[1] + hi[1]), 0.5 * (lo[2] + hi[2]));
+	double extent = 0;
+	for (int a = 0; a < 3; a++) extent = std::max(extent, 0.5 * (hi[a] - lo[a]));
+	float cx, cy, ex, ey, depth;
+	camera.to_port(centre, cx, cy, depth);
+	camera.to_port(centre + Vec(extent, 0, 0), ex, ey, depth);
+	double r = std::abs(ex - cx);
+
+	double project_ms[5] = { 0, 0, 0, 0, 0 }, fit_ms = 0;
+	int counts[5] = { 0, 0, 0, 0, 0 }, failed = 0;
+	size_t hits = 0, total = 0, fitted = 0;
+	std::vector<std::string> errors;
+	EDSketchEngine::Stroke stroke;
+	EDSketchEngine::Result result;
+	std::vector<double> curve_samples, control_points;
+	for (int s = 0; s < strokes; s++)
+	{
+		auto kind = kStrokeKinds[s % 4];
+		make_stroke(s, strokes, samples, cx, cy, r, stroke);
+		errors.clear();
+
+		start = Clock::now();
+		bool projected = engine.project(stroke, result);
+		project_ms[result.strategy] += milliseconds_since(start);
+		counts[result.strategy]++;
+		if (!projected)
+		{
+			errors.push_back("not projected");
+		}
+		else
+		{
+			hits += std::count(result.hits.begin(), result.hits.end(), true);
+			total += result.hits.size();
+			check_projection(stroke, result, kind, camera, extent, on_sphere, errors);
+		}
+
+		start = Clock::now();
+		curve_samples.resize(result.points.size() * 3);
+		for (size_t i = 0; i < result.points.size(); i++)
+		{
+			curve_samples[i * 3] = result.points[i].x;
+			curve_samples[i * 3 + 1] = result.points[i].y;
+			curve_samples[i * 3 + 2] = result.points[i].z;
+		}
+		bool fit = EDCurveFit::fit(curve_samples, 8, control_points);
+		fit_ms += milliseconds_since(start);
+		fitted += fit;
+
+		// the curve keeps the ends of the stroke
+		auto n = control_points.size();
+		if (projected && !fit)
+		{
+			errors.push_back("no curve fitted");
+		}
+		else if (projected && (std::abs(control_points[0] - curve_samples[0]) > 1e-6 * extent
+			|| std::abs(control_points[n - 1] - curve_samples[curve_samples.size() - 1]) > 1e-6 * extent))
+		{
+			errors.push_back("curve ends moved");
+		}
+
+		if (!errors.empty() && failed++ < 20)
+		{
+			for (auto & e : errors)
+			{
+				std::fprintf(stderr, "stroke %d (%s): %s\n", s, kStrategyNames[kind], e.c_str());
+			}
+		}
+	}
+
+	std::printf("%d strokes of %d samples, %.1f%% hits, %zu curves\n", strokes, samples, total ? 100.0 * hits / total : 0.0, fitted);
+	for (int k = 1; k < 5; k++)
+	{
+		if (counts[k]) std::printf("%s: %d strokes, %.3f ms per stroke\n", kStrategyNames[k], counts[k], project_ms[k] / counts[k]);
+	}
+	std::printf("fits %.3f ms per stroke\n", fit_ms / strokes);
+	if (failed)
+	{
+		std::fprintf(stderr, "%d of %d strokes failed their checks\n", failed, strokes);
+		return 1;
+	}
+	return 0;
+}